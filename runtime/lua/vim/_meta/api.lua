@@ -17,6 +17,17 @@ function vim.api.nvim__buf_debug_extmarks(buffer, keys, dot) end
 --- @return table<string,any>
 function vim.api.nvim__buf_stats(buffer) end
 
+--- @private
+--- Creates a shared memory ring through which the other side of RPC channel
+--- {chan} can send its output, see the "shm_ring" `ui-option`.
+---
+--- This API function is used for testing. One should not rely on its presence
+--- in plugins.
+---
+--- @param chan integer RPC channel id
+--- @return string
+function vim.api.nvim__chan_ring(chan) end
+
 --- @private
 --- EXPERIMENTAL: this API may change in the future.
 ---
@@ -449,6 +460,10 @@ function vim.api.nvim_buf_get_extmark_by_id(buffer, ns_id, id, opts) end
 ---               their start position is less than `start`
 ---             • type: Filter marks by type: "highlight", "sign", "virt_text"
 ---               and "virt_lines"
+---             • columns: Return the marks as `[ids, rows, cols, end_rows, end_cols]`,
+---               five lists with one item per mark, instead of one tuple per
+---               mark. `end_rows` and `end_cols` are -1 for marks without an
+---               end position. Cannot be used with `details`.
 --- @return vim.api.keyset.get_extmark_item[]
 function vim.api.nvim_buf_get_extmarks(buffer, ns_id, start, end_, opts) end
 
@@ -691,6 +706,34 @@ function vim.api.nvim_buf_line_count(buffer) end
 --- @return integer
 function vim.api.nvim_buf_set_extmark(buffer, ns_id, line, col, opts) end
 
+--- Creates or updates many `extmark`s at once.
+---
+--- Like calling `nvim_buf_set_extmark()` for each item of {marks}, but new marks
+--- are sorted and put in the buffer together. This is much faster than setting
+--- a large number of marks one by one, e.g. for semantic highlights or
+--- diagnostics of the whole buffer.
+---
+--- Example:
+---
+--- ```lua
+--- local ns = vim.api.nvim_create_namespace('my_marks')
+--- vim.api.nvim_buf_set_extmarks(0, ns, {
+---   { 0, 0, { end_col = 5, hl_group = 'Keyword' } },
+---   { 2, 4, { sign_text = '>>' } },
+--- }, { replace = true })
+--- ```
+---
+--- @param buffer integer Buffer handle, or 0 for current buffer
+--- @param ns_id integer Namespace id from `nvim_create_namespace()`
+--- @param marks any[] List of `[line, col, opts]` items, where {line}, {col} and
+---              the optional {opts} are as for `nvim_buf_set_extmark()`.
+---              "ephemeral" marks are not supported.
+--- @param opts vim.api.keyset.set_extmarks Optional parameters.
+---             • replace: delete all existing marks in {ns_id} first, like
+---               `nvim_buf_clear_namespace()` for the whole buffer.
+--- @return integer[]
+function vim.api.nvim_buf_set_extmarks(buffer, ns_id, marks, opts) end
+
 --- Sets a buffer-local `mapping` for the given mode.
 ---
 --- @param buffer integer Buffer handle, or 0 for current buffer
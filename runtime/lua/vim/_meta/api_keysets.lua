@@ -130,6 +130,7 @@ error('Cannot require a meta file')
 --- @field hl_name? boolean
 --- @field overlap? boolean
 --- @field type? string
+--- @field columns? boolean
 
 --- @class vim.api.keyset.get_highlight
 --- @field id? integer
@@ -266,6 +267,9 @@ error('Cannot require a meta file')
 --- @field url? string
 --- @field scoped? boolean
 
+--- @class vim.api.keyset.set_extmarks
+--- @field replace? boolean
+
 --- @class vim.api.keyset.user_command
 --- @field addr? any
 --- @field bang? boolean
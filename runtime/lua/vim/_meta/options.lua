@@ -3699,6 +3699,35 @@ vim.o.lrm = vim.o.langremap
 vim.go.langremap = vim.o.langremap
 vim.go.lrm = vim.go.langremap
 
+--- When editing a file of at least this size (in Kbyte), the text of the
+--- file is not read into memory.  Instead the file is mapped into memory
+--- and lines are only taken from it when they are used, which makes
+--- opening a very large file fast.  Lines that are changed are copied
+--- into the buffer as usual.  Zero disables this.
+--- Only used when the file does not need to be converted: 'fileencoding'
+--- is "utf-8" (or 'binary' is set), 'fileformat' is "unix" and the file
+--- does not start with a BOM.  Also not used when 'undofile' is set.
+--- The lines in the first Mbyte are found before the file is displayed,
+--- the rest is scanned in the background like with 'streamfilesize'; the
+--- status line shows "[loading N%]" until all lines were found.
+--- An illegal byte after the first Mbyte is kept as with "++bad=keep",
+--- the file is not read again with another encoding from
+--- 'fileencodings'.
+--- Before the file is overwritten all text is read into memory.
+--- The text that is only in the file cannot be kept in a swap file, so
+--- the buffer has no swap file until the file was written: changes
+--- cannot be recovered after a crash and other Nvim instances editing
+--- the same file are not warned, see |swap-file|.
+--- The file must not be truncated by another program while it is being
+--- edited, lines that can no longer be found are left empty (E1514).
+--- Not used on MS-Windows.
+---
+--- @type integer
+vim.o.largefilesize = 0
+vim.o.lfs = vim.o.largefilesize
+vim.go.largefilesize = vim.o.largefilesize
+vim.go.lfs = vim.go.largefilesize
+
 --- The value of this option influences when the last window will have a
 --- status line:
 --- 	0: never
@@ -4137,6 +4166,19 @@ vim.o.mmp = vim.o.maxmempattern
 vim.go.maxmempattern = vim.o.maxmempattern
 vim.go.mmp = vim.go.maxmempattern
 
+--- When non-zero, the text of a buffer without a swap file that was not
+--- used for this many syncs is kept compressed in memory.  A sync happens
+--- after 'updatetime' or after typing 'updatecount' characters, see
+--- |swap-file|.  Compressed text is decompressed when it is used again.
+--- Useful for many large buffers with 'noswapfile' that are mostly read.
+--- Zero disables this.
+---
+--- @type integer
+vim.o.memcompress = 0
+vim.o.mcp = vim.o.memcompress
+vim.go.memcompress = vim.o.memcompress
+vim.go.mcp = vim.go.memcompress
+
 --- Maximum number of items to use in a menu.  Used for menus that are
 --- generated from a list of items, e.g., the Buffers menu.  Changing this
 --- option has no direct effect, the menu must be refreshed first.
@@ -4947,6 +4989,19 @@ vim.o.rdb = vim.o.redrawdebug
 vim.go.redrawdebug = vim.o.redrawdebug
 vim.go.rdb = vim.go.redrawdebug
 
+--- When non-zero, redraws which are not caused by typing, e.g. when a job
+--- writes into a buffer or |terminal|, are done at most this many times per
+--- second.  Changes made between two redraws are shown together.  Typed
+--- keys are always shown without delay.  Useful to limit the amount of
+--- output sent to the UI while a command produces a lot of output.
+--- Zero means no limit.
+---
+--- @type integer
+vim.o.redrawrate = 0
+vim.o.rdr = vim.o.redrawrate
+vim.go.redrawrate = vim.o.redrawrate
+vim.go.rdr = vim.go.redrawrate
+
 --- Time in milliseconds for redrawing the display.  Applies to
 --- 'hlsearch', 'inccommand', `:match` highlighting and syntax
 --- highlighting.
@@ -6666,6 +6721,30 @@ vim.wo.stl = vim.wo.statusline
 vim.go.statusline = vim.o.statusline
 vim.go.stl = vim.go.statusline
 
+--- When editing a file of at least this size (in Kbyte), only the first
+--- part of the file is read before the file is displayed.  The rest of
+--- the file is read in the background and appended to the buffer while
+--- you can look around in the text that is already there.  The status
+--- line shows "[loading N%]" until the whole file has been read.
+--- Commands that change the buffer, write it or read another file into
+--- it wait for the file to be loaded completely, and so does searching
+--- with |/|, |?|, |n| and |N|.  The 'incsearch' preview only finds
+--- matches in the lines that were read.  Zero disables this.
+--- Only used when the file does not need to be converted: 'fileencoding'
+--- is "utf-8" (or 'binary' is set), 'fileformat' is "unix" and the file
+--- does not start with a BOM.  Also not used when 'undofile' is set.
+--- An illegal byte found in the part of the file that is read in the
+--- background is handled as with |++bad|, the file is not read again
+--- with another encoding from 'fileencodings'.
+--- 'largefilesize' is used first, when the file can be mapped into
+--- memory this option does not matter.
+---
+--- @type integer
+vim.o.streamfilesize = 0
+vim.o.sfs = vim.o.streamfilesize
+vim.go.streamfilesize = vim.o.streamfilesize
+vim.go.sfs = vim.go.streamfilesize
+
 --- Files with these suffixes get a lower priority when multiple files
 --- match a wildcard.  See `suffixes`.  Commas can be used to separate the
 --- suffixes.  Spaces after the comma are ignored.  A dot is also seen as
@@ -410,21 +410,27 @@ void nvim_buf_set_lines(uint64_t channel_id, Buffer buffer, Integer start, Integ
   }
 
   // Now we may need to insert the remaining new old_len
-  for (size_t i = to_replace; i < new_len; i++) {
-    int64_t lnum = start + (int64_t)i - 1;
+  if (to_replace < new_len) {
+    int64_t lnum = start + (int64_t)to_replace - 1;
+    size_t count = new_len - to_replace;
 
-    VALIDATE(lnum < MAXLNUM, "%s", "Index out of bounds", {
+    VALIDATE(lnum + (int64_t)count - 1 < MAXLNUM, "%s", "Index out of bounds", {
       goto end;
     });
 
-    if (ml_append_buf(buf, (linenr_T)lnum, lines[i], 0, false) == FAIL) {
+    colnr_T *lens = arena_alloc(arena, count * sizeof(colnr_T), true);
+    for (size_t i = 0; i < count; i++) {
+      lens[i] = (colnr_T)replacement.items[to_replace + i].data.string.size + 1;
+      inserted_bytes += lens[i];
+    }
+
+    if (ml_append_lines(buf, (linenr_T)lnum, lines + to_replace, lens, (linenr_T)count,
+                        false) == FAIL) {
       api_set_error(err, kErrorTypeException, "Failed to insert line");
       goto end;
     }
 
-    inserted_bytes += (bcount_t)strlen(lines[i]) + 1;
-
-    extra++;
+    extra += (ptrdiff_t)count;
   }
 
   // Adjust marks. Invalidate any which lie in the
@@ -191,6 +191,34 @@ static Array extmark_to_array(MTPair extmark, bool id, bool add_dict, bool hl_na
   return rv;
 }
 
+/// Lays out marks as one list per field, see the "columns" option of nvim_buf_get_extmarks().
+static Array extmarks_to_columns(ExtmarkInfoArray marks, Arena *arena)
+{
+  size_t n = kv_size(marks);
+  Array ids = arena_array(arena, n);
+  Array rows = arena_array(arena, n);
+  Array cols = arena_array(arena, n);
+  Array end_rows = arena_array(arena, n);
+  Array end_cols = arena_array(arena, n);
+  for (size_t i = 0; i < n; i++) {
+    MTPair mark = kv_A(marks, i);
+    bool paired = mt_paired(mark.start);
+    ADD_C(ids, INTEGER_OBJ((Integer)mark.start.id));
+    ADD_C(rows, INTEGER_OBJ(mark.start.pos.row));
+    ADD_C(cols, INTEGER_OBJ(mark.start.pos.col));
+    ADD_C(end_rows, INTEGER_OBJ(paired ? mark.end_pos.row : -1));
+    ADD_C(end_cols, INTEGER_OBJ(paired ? mark.end_pos.col : -1));
+  }
+
+  Array rv = arena_array(arena, 5);
+  ADD_C(rv, ARRAY_OBJ(ids));
+  ADD_C(rv, ARRAY_OBJ(rows));
+  ADD_C(rv, ARRAY_OBJ(cols));
+  ADD_C(rv, ARRAY_OBJ(end_rows));
+  ADD_C(rv, ARRAY_OBJ(end_cols));
+  return rv;
+}
+
 /// Gets the position (0-indexed) of an |extmark|.
 ///
 /// @param buffer  Buffer handle, or 0 for current buffer
@@ -283,6 +311,10 @@ ArrayOf(Integer) nvim_buf_get_extmark_by_id(Buffer buffer, Integer ns_id,
 ///          - overlap: Also include marks which overlap the range, even if
 ///                     their start position is less than `start`
 ///          - type: Filter marks by type: "highlight", "sign", "virt_text" and "virt_lines"
+///          - columns: Return the marks as `[ids, rows, cols, end_rows, end_cols]`,
+///                     five lists with one item per mark, instead of one tuple
+///                     per mark. `end_rows` and `end_cols` are -1 for marks
+///                     without an end position. Cannot be used with `details`.
 /// @param[out] err   Error details, if any
 /// @return List of `[extmark_id, row, col]` tuples in "traversal order".
 Array nvim_buf_get_extmarks(Buffer buffer, Integer ns_id, Object start, Object end,
@@ -302,6 +334,11 @@ Array nvim_buf_get_extmarks(Buffer buffer, Integer ns_id, Object start, Object e
 
   bool details = opts->details;
   bool hl_name = GET_BOOL_OR_TRUE(opts, get_extmarks, hl_name);
+  bool columns = opts->columns;
+
+  VALIDATE(!(details && columns), "%s", "cannot use both 'details' and 'columns'", {
+    return rv;
+  });
 
   ExtmarkType type = kExtmarkNone;
   if (HAS_KEY(opts, get_extmarks, type)) {
@@ -350,9 +387,13 @@ Array nvim_buf_get_extmarks(Buffer buffer, Integer ns_id, Object start, Object e
   ExtmarkInfoArray marks = extmark_get(buf, (uint32_t)ns_id, l_row, l_col, u_row,
                                        u_col, (int64_t)limit, reverse, type, opts->overlap);
 
-  rv = arena_array(arena, kv_size(marks));
-  for (size_t i = 0; i < kv_size(marks); i++) {
-    ADD_C(rv, ARRAY_OBJ(extmark_to_array(kv_A(marks, i), true, details, hl_name, arena)));
+  if (columns) {
+    rv = extmarks_to_columns(marks, arena);
+  } else {
+    rv = arena_array(arena, kv_size(marks));
+    for (size_t i = 0; i < kv_size(marks); i++) {
+      ADD_C(rv, ARRAY_OBJ(extmark_to_array(kv_A(marks, i), true, details, hl_name, arena)));
+    }
   }
 
   kv_destroy(marks);
@@ -497,6 +538,43 @@ Array nvim_buf_get_extmarks(Buffer buffer, Integer ns_id, Object start, Object e
 Integer nvim_buf_set_extmark(Buffer buffer, Integer ns_id, Integer line, Integer col,
                              Dict(set_extmark) *opts, Error *err)
   FUNC_API_SINCE(7)
+{
+  buf_T *buf = find_buffer_by_handle(buffer, err);
+  if (!buf) {
+    return 0;
+  }
+
+  VALIDATE_INT(ns_initialized((uint32_t)ns_id), "ns_id", ns_id, {
+    return 0;
+  });
+
+  MTPair mark;
+  if (!extmark_from_opts(buf, (uint32_t)ns_id, line, col, opts, &mark, err)) {
+    // error, or an ephemeral mark which was added to the current redraw
+    return ERROR_SET(err) ? 0 : opts->id;
+  }
+
+  uint32_t id = mark.start.id;
+  MTKey key = mark.start;
+  extmark_set(buf, (uint32_t)ns_id, &id, key.pos.row, key.pos.col, mark.end_pos.row,
+              mark.end_pos.col, mt_decor(key), key.flags & MT_FLAG_DECOR_MASK, mt_right(key),
+              mark.end_right_gravity, mt_no_undo(key), mt_invalidate(key), mt_scoped(key), err);
+  if (ERROR_SET(err)) {
+    decor_free(mt_decor(key));
+    return 0;
+  }
+
+  return (Integer)id;
+}
+
+/// Validates the options of an extmark at "line", "col" like nvim_buf_set_extmark(),
+/// and builds its decoration. An ephemeral mark is added to the current redraw directly.
+///
+/// @param[out] mark  The mark to set, with the "id" of "opts" or zero. The caller
+///                   takes ownership of its decoration.
+/// @return  false on error or for an ephemeral mark, otherwise true.
+static bool extmark_from_opts(buf_T *buf, uint32_t ns_id, Integer line, Integer col,
+                              Dict(set_extmark) *opts, MTPair *mark, Error *err)
 {
   DecorHighlightInline hl = DECOR_HIGHLIGHT_INLINE_INIT;
   // TODO(bfredl): in principle signs with max one (1) hl group and max 4 bytes of text.
@@ -507,15 +585,6 @@ Integer nvim_buf_set_extmark(Buffer buffer, Integer ns_id, Integer line, Integer
   char *url = NULL;
   bool has_hl = false;
 
-  buf_T *buf = find_buffer_by_handle(buffer, err);
-  if (!buf) {
-    goto error;
-  }
-
-  VALIDATE_INT(ns_initialized((uint32_t)ns_id), "ns_id", ns_id, {
-    goto error;
-  });
-
   uint32_t id = 0;
   if (HAS_KEY(opts, set_extmark, id)) {
     VALIDATE_EXP((opts->id > 0), "id", "positive Integer", NULL, {
@@ -774,7 +843,7 @@ Integer nvim_buf_set_extmark(Buffer buffer, Integer ns_id, Integer line, Integer
     }
     if (has_hl) {
       DecorSignHighlight sh = decor_sh_from_inline(hl);
-      decor_range_add_sh(&decor_state, r, c, line2, col2, &sh, true, (uint32_t)ns_id, id);
+      decor_range_add_sh(&decor_state, r, c, line2, col2, &sh, true, ns_id, id);
     }
   } else {
     if (opts->ephemeral) {
@@ -831,17 +900,18 @@ Integer nvim_buf_set_extmark(Buffer buffer, Integer ns_id, Integer line, Integer
       decor_flags |= MT_FLAG_DECOR_HL;
     }
 
-    extmark_set(buf, (uint32_t)ns_id, &id, (int)line, (colnr_T)col, line2, col2,
-                decor, decor_flags, right_gravity, opts->end_right_gravity,
-                !GET_BOOL_OR_TRUE(opts, set_extmark, undo_restore),
-                opts->invalidate, opts->scoped, err);
-    if (ERROR_SET(err)) {
-      decor_free(decor);
-      return 0;
-    }
+    bool no_undo = !GET_BOOL_OR_TRUE(opts, set_extmark, undo_restore);
+    uint16_t flags = mt_flags(right_gravity, no_undo, opts->invalidate, decor.ext, opts->scoped);
+    *mark = (MTPair){
+      .start = { { (int)line, (colnr_T)col }, ns_id, id, (uint16_t)(flags | decor_flags),
+                 decor.data },
+      .end_pos = { line2, col2 },
+      .end_right_gravity = opts->end_right_gravity,
+    };
+    return true;
   }
 
-  return (Integer)id;
+  return false;
 
 error:
   clear_virttext(&virt_text.data.virt_text);
@@ -850,7 +920,108 @@ error:
     xfree(url);
   }
 
-  return 0;
+  return false;
+}
+
+/// Creates or updates many |extmark|s at once.
+///
+/// Like calling |nvim_buf_set_extmark()| for each item of {marks}, but new marks
+/// are sorted and put in the buffer together. This is much faster than setting
+/// a large number of marks one by one, e.g. for semantic highlights or
+/// diagnostics of the whole buffer.
+///
+/// Example:
+///
+/// ```lua
+/// local ns = vim.api.nvim_create_namespace('my_marks')
+/// vim.api.nvim_buf_set_extmarks(0, ns, {
+///   { 0, 0, { end_col = 5, hl_group = 'Keyword' } },
+///   { 2, 4, { sign_text = '>>' } },
+/// }, { replace = true })
+/// ```
+///
+/// @param buffer  Buffer handle, or 0 for current buffer
+/// @param ns_id  Namespace id from |nvim_create_namespace()|
+/// @param marks  List of `[line, col, opts]` items, where {line}, {col} and
+///               the optional {opts} are as for |nvim_buf_set_extmark()|.
+///               "ephemeral" marks are not supported.
+/// @param opts  Optional parameters.
+///               - replace: delete all existing marks in {ns_id} first, like
+///                 |nvim_buf_clear_namespace()| for the whole buffer.
+/// @param[out] err   Error details, if any. No mark is set if an item is invalid.
+/// @return Ids of the created/updated extmarks, in the order of {marks}
+ArrayOf(Integer) nvim_buf_set_extmarks(uint64_t channel_id, Buffer buffer, Integer ns_id,
+                                       Array marks, Dict(set_extmarks) *opts, Arena *arena,
+                                       Error *err)
+  FUNC_API_SINCE(13)
+{
+  Array rv = ARRAY_DICT_INIT;
+
+  buf_T *buf = find_buffer_by_handle(buffer, err);
+  if (!buf) {
+    return rv;
+  }
+
+  VALIDATE_INT(ns_initialized((uint32_t)ns_id), "ns_id", ns_id, {
+    return rv;
+  });
+
+  kvec_t(MTPair) parsed = KV_INITIAL_VALUE;
+  kv_resize(parsed, marks.size);
+
+  for (size_t i = 0; i < marks.size; i++) {
+    Object item = marks.items[i];
+    VALIDATE_EXP((item.type == kObjectTypeArray
+                  && (item.data.array.size == 2 || item.data.array.size == 3)
+                  && item.data.array.items[0].type == kObjectTypeInteger
+                  && item.data.array.items[1].type == kObjectTypeInteger),
+                 "marks", "list of [line, col, opts] items", NULL, {
+      goto error;
+    });
+    Array a = item.data.array;
+
+    Dict(set_extmark) mark_opts[1] = KEYDICT_INIT;
+    if (a.size == 3) {
+      VALIDATE_T_DICT("opts", a.items[2], {
+        goto error;
+      });
+      if (a.items[2].type == kObjectTypeDictionary
+          && !api_dict_to_keydict(mark_opts, KeyDict_set_extmark_get_field,
+                                  a.items[2].data.dictionary, err)) {
+        goto error;
+      }
+    }
+    VALIDATE(!mark_opts->ephemeral, "%s", "cannot use 'ephemeral' with nvim_buf_set_extmarks", {
+      goto error;
+    });
+
+    MTPair mark;
+    if (!extmark_from_opts(buf, (uint32_t)ns_id, a.items[0].data.integer,
+                           a.items[1].data.integer, mark_opts, &mark, err)) {
+      goto error;
+    }
+    kv_push(parsed, mark);
+  }
+
+  extmark_set_many(buf, (uint32_t)ns_id, parsed.items, kv_size(parsed), opts->replace, err);
+  if (ERROR_SET(err)) {
+    kv_destroy(parsed);
+    return rv;
+  }
+
+  rv = arena_array(arena, kv_size(parsed));
+  for (size_t i = 0; i < kv_size(parsed); i++) {
+    ADD_C(rv, INTEGER_OBJ((Integer)kv_A(parsed, i).start.id));
+  }
+  kv_destroy(parsed);
+  return rv;
+
+error:
+  for (size_t i = 0; i < kv_size(parsed); i++) {
+    decor_free(mt_decor(kv_A(parsed, i).start));
+  }
+  kv_destroy(parsed);
+  return rv;
 }
 
 /// Removes an |extmark|.
@@ -1235,6 +1406,7 @@ Boolean nvim__win_add_ns(Window window, Integer ns_id, Error *err)
   });
 
   set_put(uint32_t, &win->w_ns_set, (uint32_t)ns_id);
+  decor_cache_free(win);
 
   if (map_has(uint32_t, win->w_buffer->b_extmark_ns, (uint32_t)ns_id)) {
     changed_window_setting(win);
@@ -1284,6 +1456,7 @@ Boolean nvim__win_del_ns(Window window, Integer ns_id, Error *err)
   }
 
   set_del(uint32_t, &win->w_ns_set, (uint32_t)ns_id);
+  decor_cache_free(win);
 
   if (map_has(uint32_t, win->w_buffer->b_extmark_ns, (uint32_t)ns_id)) {
     changed_window_setting(win);
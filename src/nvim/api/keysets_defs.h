@@ -58,6 +58,11 @@ typedef struct {
   Boolean scoped;
 } Dict(set_extmark);
 
+typedef struct {
+  OptionalKeys is_set__set_extmarks_;
+  Boolean replace;
+} Dict(set_extmarks);
+
 typedef struct {
   OptionalKeys is_set__get_extmark_;
   Boolean details;
@@ -71,6 +76,7 @@ typedef struct {
   Boolean hl_name;
   Boolean overlap;
   String type;
+  Boolean columns;
 } Dict(get_extmarks);
 
 typedef struct {
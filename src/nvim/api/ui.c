@@ -150,6 +150,7 @@ void nvim_ui_attach(uint64_t channel_id, Integer width, Integer height, Dictiona
   ui->pum_row = -1.0;
   ui->pum_col = -1.0;
   ui->rgb = true;
+  ui->channel_id = channel_id;
   CLEAR_FIELD(ui->ui_ext);
 
   for (size_t i = 0; i < options.size; i++) {
@@ -171,7 +172,6 @@ void nvim_ui_attach(uint64_t channel_id, Integer width, Integer height, Dictiona
     ui->ui_ext[kUICmdline] = true;
   }
 
-  ui->channel_id = channel_id;
   ui->cur_event = NULL;
   ui->hl_id = 0;
   ui->client_col = -1;
@@ -334,6 +334,19 @@ static void ui_set_option(RemoteUI *ui, bool init, String name, Object value, Er
     return;
   }
 
+  if (strequal(name.data, "shm_ring")) {
+    VALIDATE_T("shm_ring", kObjectTypeString, value.type, {
+      return;
+    });
+    VALIDATE(init, "%s", "shm_ring can only be used when attaching", {
+      return;
+    });
+    // Not an error if the ring can't be used, the client then keeps reading
+    // the channel as usual.
+    rpc_ring_attach(ui->channel_id, value.data.string.data);
+    return;
+  }
+
   if (strequal(name.data, "stdin_tty")) {
     VALIDATE_T("stdin_tty", kObjectTypeBoolean, value.type, {
       return;
@@ -876,6 +889,7 @@ static void ui_flush_buf(RemoteUI *ui)
     ui->nevents_pos = NULL;
   }
 
+  g_stats.ui_bytes += (int64_t)BUF_POS(ui);
   WBuffer *buf = wstream_new_buffer(ui->packer.startptr, BUF_POS(ui), 1, free_block);
   rpc_write_raw(ui->channel_id, buf);
 
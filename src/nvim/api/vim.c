@@ -50,8 +50,10 @@
 #include "nvim/mapping.h"
 #include "nvim/mark.h"
 #include "nvim/mark_defs.h"
+#include "nvim/marktree.h"
 #include "nvim/math.h"
 #include "nvim/mbyte.h"
+#include "nvim/memfile.h"
 #include "nvim/memline.h"
 #include "nvim/memory.h"
 #include "nvim/memory_defs.h"
@@ -1778,16 +1780,58 @@ Float nvim__id_float(Float flt)
 /// @return Map of various internal stats.
 Dictionary nvim__stats(Arena *arena)
 {
-  Dictionary rv = arena_dict(arena, 6);
+  mf_writer_stats();
+  Dictionary rv = arena_dict(arena, 30);
   PUT_C(rv, "fsync", INTEGER_OBJ(g_stats.fsync));
   PUT_C(rv, "log_skip", INTEGER_OBJ(g_stats.log_skip));
+  PUT_C(rv, "ml_cache_hit", INTEGER_OBJ(g_stats.ml_cache_hit));
+  PUT_C(rv, "ml_cache_miss", INTEGER_OBJ(g_stats.ml_cache_miss));
+  PUT_C(rv, "swap_sync", INTEGER_OBJ(g_stats.swap_sync));
+  PUT_C(rv, "swap_sync_us", INTEGER_OBJ(g_stats.swap_sync_us));
+  PUT_C(rv, "swap_sync_max_us", INTEGER_OBJ(g_stats.swap_sync_max_us));
+  PUT_C(rv, "compress_ratio", FLOAT_OBJ(g_stats.mf_compress_size == 0
+                                        ? 0.0
+                                        : (double)g_stats.mf_compress_bytes
+                                        / (double)g_stats.mf_compress_size));
+  PUT_C(rv, "compress_bytes", INTEGER_OBJ(g_stats.mf_compress_bytes));
+  PUT_C(rv, "decompress", INTEGER_OBJ(g_stats.mf_decompress));
+  PUT_C(rv, "decompress_us", INTEGER_OBJ(g_stats.mf_decompress_ns / 1000));
   PUT_C(rv, "lua_refcount", INTEGER_OBJ(nlua_get_global_ref_count()));
   PUT_C(rv, "redraw", INTEGER_OBJ(g_stats.redraw));
+  PUT_C(rv, "decor_cache_hit", INTEGER_OBJ(g_stats.decor_cache_hit));
+  PUT_C(rv, "decor_cache_miss", INTEGER_OBJ(g_stats.decor_cache_miss));
+  PUT_C(rv, "stream_writes", INTEGER_OBJ(g_stats.stream_writes));
+  PUT_C(rv, "stream_write_bufs", INTEGER_OBJ(g_stats.stream_write_bufs));
+  PUT_C(rv, "stream_write_bytes", INTEGER_OBJ(g_stats.stream_write_bytes));
+  PUT_C(rv, "redraw_frames", INTEGER_OBJ(g_stats.redraw_frames));
+  PUT_C(rv, "redraw_postponed", INTEGER_OBJ(g_stats.redraw_postponed));
+  PUT_C(rv, "redraw_win_update_us", INTEGER_OBJ(g_stats.redraw_win_update_ns / 1000));
+  PUT_C(rv, "redraw_lines", INTEGER_OBJ(g_stats.redraw_lines));
+  PUT_C(rv, "ui_bytes", INTEGER_OBJ(g_stats.ui_bytes));
+  PUT_C(rv, "plines_cache_hit", INTEGER_OBJ(g_stats.plines_cache_hit));
+  PUT_C(rv, "plines_cache_miss", INTEGER_OBJ(g_stats.plines_cache_miss));
+  PUT_C(rv, "timestamp_checks", INTEGER_OBJ(g_stats.timestamp_checks));
   PUT_C(rv, "arena_alloc_count", INTEGER_OBJ((Integer)arena_alloc_count));
   PUT_C(rv, "ts_query_parse_count", INTEGER_OBJ((Integer)tslua_query_parse_count));
+  PUT_C(rv, "marktree_nodes", INTEGER_OBJ((Integer)marktree_node_count(false)));
+  PUT_C(rv, "marktree_free_nodes", INTEGER_OBJ((Integer)marktree_node_count(true)));
   return rv;
 }
 
+/// Creates a shared memory ring through which the other side of RPC channel
+/// {chan} can send its output, see the "shm_ring" |ui-option|.
+///
+/// This API function is used for testing. One should not rely on its presence
+/// in plugins.
+///
+/// @param chan  RPC channel id
+/// @return path to pass as "shm_ring", or empty if no ring could be created.
+String nvim__chan_ring(Integer chan, Arena *arena)
+{
+  const char *path = rpc_ring_create((uint64_t)chan);
+  return path ? arena_string(arena, cstr_as_string(path)) : (String)STRING_INIT;
+}
+
 /// Gets a list of dictionaries representing attached UIs.
 ///
 /// @return Array of UI dictionaries, each with these keys:
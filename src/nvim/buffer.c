@@ -839,6 +839,7 @@ void buf_freeall(buf_T *buf, int flags)
     }
   }
 
+  buf_load_stop(buf);               // don't read the rest of the file
   ml_close(buf, true);              // close and delete the memline/memfile
   buf->b_ml.ml_line_count = 0;      // no lines in buffer
   if ((flags & BFA_KEEP_UNDO) == 0) {
@@ -855,6 +856,7 @@ void buf_freeall(buf_T *buf, int flags)
 static void free_buffer(buf_T *buf)
 {
   pmap_del(int)(&buffer_handles, buf->b_fnum, NULL);
+  buf_unwatch_file(buf);
   buf_free_count++;
   // b:changedtick uses an item in buf_T.
   free_buffer_stuff(buf, kBffClearWinInfo);
@@ -2987,6 +2989,7 @@ int setfname(buf_T *buf, char *ffname_arg, char *sfname_arg, bool message)
     buf->b_sfname = sfname;
   }
   buf->b_fname = buf->b_sfname;
+  buf_unwatch_file(buf);  // the file may be in another directory now
   if (!file_id_valid) {
     buf->file_id_valid = false;
   } else {
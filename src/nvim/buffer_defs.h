@@ -403,6 +403,8 @@ struct file_buffer {
 
   bool b_saving;                // Set to true if we are in the middle of
                                 // saving the buffer.
+  struct file_load *b_file_load;  // rest of the file that is being read in
+                                  // the background, see 'streamfilesize'
 
   // Changes to a buffer require updating of the display.  To minimize the
   // work, remember changes made and update everything at once.
@@ -424,6 +426,10 @@ struct file_buffer {
   int64_t b_mtime_read_ns;      // nanoseconds of last read time
   uint64_t b_orig_size;         // size of original file in bytes
   int b_orig_mode;              // mode of original file
+  struct dir_watcher *b_dir_watcher;  // watcher for the directory of the
+                                      // file, NULL when not watched
+  uint64_t b_dir_changes;       // b_dir_watcher->changes when the file was
+                                // last checked
   time_t b_last_used;           // time when the buffer was last used; used
                                 // for viminfo
 
@@ -816,6 +822,14 @@ typedef struct {
   linenr_T wl_lastlnum;         // last buffer line number for logical line
 } wline_T;
 
+// Entry in w_plines_cache[], the height of a buffer line computed by
+// plines_win_nofold().
+typedef struct {
+  linenr_T pc_lnum;             // buffer line number, zero when unused
+  colnr_T pc_len;               // length of the line in bytes
+  int pc_lines;                 // height in screen lines
+} plines_cache_T;
+
 // Windows are kept in a tree of frames.  Each frame has a column (FR_COL)
 // or row (FR_ROW) layout or is a leaf, which has a window.
 struct frame_S {
@@ -1036,6 +1050,7 @@ struct window_S {
   int *w_ns_hl_attr;
 
   Set(uint32_t) w_ns_set;
+  struct decor_cache *w_decor_cache;  ///< decorations of lines drawn before
 
   int w_hl_id_normal;               ///< 'winhighlight' normal id
   int w_hl_attr_normal;             ///< 'winhighlight' normal final attrs
@@ -1196,6 +1211,18 @@ struct window_S {
   int w_lines_valid;                // number of valid entries
   wline_T *w_lines;
 
+  // Heights of lines measured by plines_win_nofold(), also for lines outside
+  // of the window, so that scrolling doesn't have to go over the text of long
+  // wrapping lines again.  Indexed by the line number modulo
+  // PLINES_CACHE_SIZE, allocated when first used.  Entries are dropped by
+  // changed_lines_invalidate_win(), all of them when one of the values below
+  // no longer matches or by plines_cache_invalidate().
+  plines_cache_T *w_plines_cache;
+  handle_T w_plines_cache_buf;      // buffer the heights are for
+  varnumber_T w_plines_cache_tick;  // b:changedtick of that buffer
+  int w_plines_cache_width1;        // text width of the first screen line
+  int w_plines_cache_width2;        // text width of the other screen lines
+
   garray_T w_folds;                 // array of nested folds
   bool w_fold_manual;               // when true: some folds are opened/closed
                                     // manually
@@ -10,6 +10,7 @@
 #include <uv.h>
 
 #include "auto/config.h"
+#include "klib/kvec.h"
 #include "nvim/ascii_defs.h"
 #include "nvim/autocmd.h"
 #include "nvim/autocmd_defs.h"
@@ -20,6 +21,8 @@
 #include "nvim/drawscreen.h"
 #include "nvim/eval.h"
 #include "nvim/eval/typval_defs.h"
+#include "nvim/event/defs.h"
+#include "nvim/event/loop.h"
 #include "nvim/ex_cmds.h"
 #include "nvim/ex_cmds_defs.h"
 #include "nvim/ex_eval.h"
@@ -30,7 +33,9 @@
 #include "nvim/highlight_defs.h"
 #include "nvim/iconv_defs.h"
 #include "nvim/input.h"
+#include "nvim/log.h"
 #include "nvim/macros_defs.h"
+#include "nvim/main.h"
 #include "nvim/mbyte.h"
 #include "nvim/memline.h"
 #include "nvim/memline_defs.h"
@@ -89,8 +94,49 @@ struct bw_info {
   linenr_T bw_conv_error_lnum;    // first line with error or zero
   linenr_T bw_start_lnum;         // line number at start of buffer
   iconv_t bw_iconv_fd;            // descriptor for iconv() or -1
+  StringBuilder *bw_snapshot;     // when not NULL: collect the text here
+                                  // instead of writing it
 };
 
+/// A ":write ++async" that is in progress.  The text was copied to "data" by
+/// buf_write(), a worker thread writes it to "fd" and then
+/// buf_write_async_finish() does the rest on the main thread.
+typedef struct bw_async bw_async_T;
+struct bw_async {
+  bw_async_T *next;           ///< next write in progress
+  int id;                     ///< identifies the write in the done event
+  uv_thread_t thread;
+  bool threaded;              ///< "thread" was started
+
+  // Used by the worker thread.
+  int fd;
+  char *data;                 ///< text to write
+  size_t len;                 ///< length of "data"
+  bool do_fsync;              ///< 'fsync' was set
+  int write_error;            ///< libuv error from writing or zero
+  int fsync_error;            ///< libuv error from fsync() or zero
+
+  // Used to finish the write.
+  int fnum;                   ///< number of the buffer
+  varnumber_T changedtick;    ///< b:changedtick of the written text
+  char *fname;                ///< full name of the file
+  char *msg;                  ///< message to give when written
+  char *backup;               ///< backup file or NULL
+  bool backup_copy;
+  FileInfo file_info_old;
+  int perm;
+  bool made_writable;
+  vim_acl_T acl;
+  bool overwriting;           ///< writing the buffer's own file
+  bool reset_changed;         ///< reset 'modified' when written
+  bool write_undo_file;
+  uint8_t hash[UNDO_HASH_SIZE];  ///< for the undo file
+};
+
+/// Writes started with ":write ++async" that were not finished yet.
+static bw_async_T *bw_async_list = NULL;
+static int bw_async_last_id = 0;
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "bufwrite.c.generated.h"
 #endif
@@ -337,6 +383,11 @@ static int buf_write_bytes(struct bw_info *ip)
     }
   }
 
+  if (ip->bw_snapshot != NULL) {
+    // ":write ++async": the text is written later.
+    kv_concat_len(*ip->bw_snapshot, buf, (size_t)len);
+    return OK;
+  }
   if (ip->bw_fd < 0) {
     // Only checking conversion, which is OK if we get here.
     return OK;
@@ -1037,6 +1088,175 @@ nobackup:
   return OK;
 }
 
+/// Set the owner, permissions and ACL of the written file "wfname" like the
+/// original file and close "fd".
+///
+/// @return  FAIL when closing failed, "err" is set then.
+static int buf_write_close(buf_T *buf, int fd, char *wfname, char *backup, bool backup_copy,
+                           FileInfo *file_info_old, int perm, bool made_writable, vim_acl_T acl,
+                           Error_T *err)
+{
+  int retval = OK;
+
+  if (!backup_copy) {
+#ifdef HAVE_XATTR
+    os_copy_xattr(backup, wfname);
+#endif
+  }
+
+#ifdef UNIX
+  // When creating a new file, set its owner/group to that of the original
+  // file.  Get the new device and inode number.
+  if (backup != NULL && !backup_copy) {
+    // don't change the owner when it's already OK, some systems remove
+    // permission or ACL stuff
+    FileInfo file_info;
+    if (!os_fileinfo(wfname, &file_info)
+        || file_info.stat.st_uid != file_info_old->stat.st_uid
+        || file_info.stat.st_gid != file_info_old->stat.st_gid) {
+      os_fchown(fd, (uv_uid_t)file_info_old->stat.st_uid, (uv_gid_t)file_info_old->stat.st_gid);
+      if (perm >= 0) {  // Set permission again, may have changed.
+        os_setperm(wfname, perm);
+      }
+    }
+    if (buf != NULL) {
+      buf_set_file_id(buf);
+    }
+  } else if (buf != NULL && !buf->file_id_valid) {
+    // Set the file_id when creating a new file.
+    buf_set_file_id(buf);
+  }
+#endif
+
+  int error;
+  if ((error = os_close(fd)) != 0) {
+    *err = set_err_arg(_("E512: Close failed: %s"), error);
+    retval = FAIL;
+  }
+
+#ifdef UNIX
+  if (made_writable) {
+    perm &= ~0200;              // reset 'w' bit for security reasons
+  }
+#endif
+  if (perm >= 0) {  // Set perm. of new file same as old file.
+    os_setperm(wfname, perm);
+  }
+  // Probably need to set the ACL before changing the user (can't set the
+  // ACL on a file the user doesn't own).
+  if (!backup_copy) {
+    os_set_acl(wfname, acl);
+  }
+  return retval;
+}
+
+/// After a write error try to put the backup file in place of the new file,
+/// because the new file is probably corrupt.  This avoids losing the original
+/// file when trying to make a backup when writing the file a second time.
+/// When "backup_copy" is set the backup is copied over the new file.
+/// Otherwise the backup file is renamed.
+///
+/// @return  true when the original file was restored.
+static bool buf_write_restore_backup(char *backup, bool backup_copy, char *fname)
+{
+  if (backup == NULL) {
+    return false;
+  }
+  if (backup_copy) {
+    // This may take a while, if we were interrupted let the user
+    // know we got the message.
+    if (got_int) {
+      msg(_(e_interr), 0);
+      ui_flush();
+    }
+
+    // copy the file.
+    return os_copy(backup, fname, UV_FS_COPYFILE_FICLONE) == 0;
+  }
+  return vim_rename(backup, fname) == 0;
+}
+
+/// Give the warning for a write error when the original file could not be
+/// restored.
+static void buf_write_lost_warning(buf_T *buf, char *fname)
+{
+  const int attr = HL_ATTR(HLF_E);  // Set highlight for error messages.
+  msg_puts_attr(_("\nWARNING: Original file may be lost or damaged\n"),
+                attr | MSG_HIST);
+  msg_puts_attr(_("don't quit the editor until the file is successfully written!"),
+                attr | MSG_HIST);
+
+  // Update the timestamp to avoid an "overwrite changed file"
+  // prompt when writing again.
+  FileInfo file_info;
+  if (buf != NULL && os_fileinfo(fname, &file_info)) {
+    buf_store_file_info(buf, &file_info);
+    buf->b_mtime_read = buf->b_mtime;
+    buf->b_mtime_read_ns = buf->b_mtime_ns;
+  }
+}
+
+/// Put the message for writing "lnum" lines and "nchars" bytes to "fname" in
+/// IObuff.
+static void buf_write_msg(buf_T *buf, char *fname, struct bw_info *ip, bool converted,
+                          bool notconverted, bool device, bool newfile, bool no_eol,
+                          int fileformat, linenr_T lnum, int nchars, bool append)
+{
+  add_quoted_fname(IObuff, IOSIZE, buf, fname);
+  bool insert_space = false;
+  if (ip->bw_conv_error) {
+    xstrlcat(IObuff, _(" CONVERSION ERROR"), IOSIZE);
+    insert_space = true;
+    if (ip->bw_conv_error_lnum != 0) {
+      vim_snprintf_add(IObuff, IOSIZE, _(" in line %" PRId64 ";"),
+                       (int64_t)ip->bw_conv_error_lnum);
+    }
+  } else if (notconverted) {
+    xstrlcat(IObuff, _("[NOT converted]"), IOSIZE);
+    insert_space = true;
+  } else if (converted) {
+    xstrlcat(IObuff, _("[converted]"), IOSIZE);
+    insert_space = true;
+  }
+  if (device) {
+    xstrlcat(IObuff, _("[Device]"), IOSIZE);
+    insert_space = true;
+  } else if (newfile) {
+    xstrlcat(IObuff, _("[New]"), IOSIZE);
+    insert_space = true;
+  }
+  if (no_eol) {
+    xstrlcat(IObuff, _("[noeol]"), IOSIZE);
+    insert_space = true;
+  }
+  // may add [unix/dos/mac]
+  if (msg_add_fileformat(fileformat)) {
+    insert_space = true;
+  }
+  msg_add_lines(insert_space, lnum, nchars);       // add line/char count
+  if (!shortmess(SHM_WRITE)) {
+    if (append) {
+      xstrlcat(IObuff, shortmess(SHM_WRI) ? _(" [a]") : _(" appended"), IOSIZE);
+    } else {
+      xstrlcat(IObuff, shortmess(SHM_WRI) ? _(" [w]") : _(" written"), IOSIZE);
+    }
+  }
+}
+
+/// Reset 'modified' after writing the whole buffer.
+static void buf_write_unchanged(buf_T *buf)
+{
+  unchanged(buf, true, false);
+  const varnumber_T changedtick = buf_get_changedtick(buf);
+  if (buf->b_last_changedtick + 1 == changedtick) {
+    // b:changedtick may be incremented in unchanged() but that should not
+    // trigger a TextChanged event.
+    buf->b_last_changedtick = changedtick;
+  }
+  u_unchanged(buf);
+  u_update_save_nr(buf);
+}
+
 /// buf_write() - write to file "fname" lines "start" through "end"
 ///
 /// We do our own buffering here because fwrite() is so slow.
@@ -1070,6 +1290,18 @@ int buf_write(buf_T *buf, char *fname, char *sfname, linenr_T start, linenr_T en
   if (fname == NULL || *fname == NUL) {  // safety check
     return FAIL;
   }
+
+  // A ":write ++async" of this buffer must be finished first.  Its
+  // BufWritePost autocommands may delete the buffer.
+  bufref_T bufref;
+  set_bufref(&bufref, buf);
+  buf_write_async_wait(buf);
+  if (!bufref_valid(&bufref)) {
+    return FAIL;
+  }
+  // All of the file must have been read before it is written.
+  buf_load_wait(buf);
+
   if (buf->b_ml.ml_mfp == NULL) {
     // This can happen during startup when there is a stray "w" in the
     // vimrc file.
@@ -1193,6 +1425,8 @@ int buf_write(buf_T *buf, char *fname, char *sfname, linenr_T start, linenr_T en
   bool file_readonly = false;  // overwritten file is read-only
   char *backup = NULL;
   char *fenc_tofree = NULL;   // allocated "fenc"
+  StringBuilder snapshot = KV_INITIAL_VALUE;  // text for ":write ++async"
+  bool async_started = false;  // worker thread for ":write ++async" started
 
   // Get information about original file (if there is one).
   FileInfo file_info_old;
@@ -1218,6 +1452,11 @@ int buf_write(buf_T *buf, char *fname, char *sfname, linenr_T start, linenr_T en
 
   bool backup_copy = false;  // copy the original file?
 
+  // ":write ++async" is only done when writing the whole buffer to a file,
+  // the other cases are not worth the trouble.
+  const bool async = eap != NULL && eap->write_async && reset_changed && whole
+                     && !append && !filtering && !device && *p_pm == NUL;
+
   // Save the value of got_int and reset it.  We don't want a previous
   // interruption cancel writing, only hitting CTRL-C while writing should
   // abort it.
@@ -1241,9 +1480,9 @@ int buf_write(buf_T *buf, char *fname, char *sfname, linenr_T start, linenr_T en
     }
   }
 
-#if defined(UNIX)
   bool made_writable = false;  // 'w' bit has been set
 
+#if defined(UNIX)
   // When using ":w!" and the file was read-only: make it writable
   if (forceit && perm >= 0 && !(perm & 0200)
       && file_info_old.stat.st_uid == getuid()
@@ -1271,6 +1510,12 @@ int buf_write(buf_T *buf, char *fname, char *sfname, linenr_T start, linenr_T en
 
   char *wfname = NULL;       // name of file to write to
 
+  // The text of lines that were not changed may still come from the original
+  // file, see 'largefilesize'.  Copy it before the file is overwritten.
+  if (overwriting) {
+    ml_unmap(buf);
+  }
+
   // If the original file is being overwritten, there is a small chance that
   // we crash in the middle of writing. Therefore the file is preserved now.
   // This makes all block numbers positive so that recovery does not need
@@ -1481,6 +1726,11 @@ restore_backup:
     }
     err = set_err(NULL);
 
+    if (async && !checking_conversion && wfname == fname) {
+      // Collect the text, it is written by buf_write_async_main().
+      write_info.bw_snapshot = &snapshot;
+    }
+
     write_info.bw_buf = buffer;
     nchars = 0;
 
@@ -1602,7 +1852,11 @@ restore_backup:
 
     if (!buf->b_p_fixeol && buf->b_p_eof) {
       // write trailing CTRL-Z
-      write_eintr(write_info.bw_fd, "\x1a", 1);
+      if (write_info.bw_snapshot != NULL) {
+        kv_push(snapshot, '\x1a');
+      } else {
+        write_eintr(write_info.bw_fd, "\x1a", 1);
+      }
     }
 
     // Stop when writing done or an error was encountered.
@@ -1614,6 +1868,42 @@ restore_backup:
     // really write the buffer.
   }
 
+  if (write_info.bw_snapshot != NULL && end != 0) {
+    // ":write ++async": the file is written by a worker thread and
+    // buf_write_async_finish() does the rest.
+    bw_async_T *job = xcalloc(1, sizeof(bw_async_T));
+    job->fd = fd;
+    job->data = snapshot.items;
+    job->len = snapshot.size;
+    kv_init(snapshot);
+    job->do_fsync = p_fs;
+    job->fnum = buf->b_fnum;
+    job->changedtick = buf_get_changedtick(buf);
+    job->fname = xstrdup(ffname);
+    job->backup = backup;
+    backup = NULL;
+    job->backup_copy = backup_copy;
+    job->file_info_old = file_info_old;
+    job->perm = perm;
+    job->made_writable = made_writable;
+    job->acl = acl;
+    acl = NULL;
+    job->overwriting = overwriting;
+    job->reset_changed = !write_info.bw_conv_error
+                         && (overwriting || vim_strchr(p_cpo, CPO_PLUS) != NULL);
+    job->write_undo_file = write_undo_file;
+    if (write_undo_file) {
+      sha256_finish(&sha_ctx, job->hash);
+    }
+    buf_write_msg(buf, fname, &write_info, converted, notconverted, false, newfile, no_eol,
+                  fileformat, lnum - start, nchars, false);
+    job->msg = xstrdup(IObuff);
+
+    buf_write_async_start(job);
+    async_started = true;
+    goto fail;
+  }
+
   // If we started writing, finish writing. Also when an error was
   // encountered.
   if (!checking_conversion) {
@@ -1633,53 +1923,11 @@ restore_backup:
       end = 0;
     }
 
-    if (!backup_copy) {
-#ifdef HAVE_XATTR
-      os_copy_xattr(backup, wfname);
-#endif
-    }
-
-#ifdef UNIX
-    // When creating a new file, set its owner/group to that of the original
-    // file.  Get the new device and inode number.
-    if (backup != NULL && !backup_copy) {
-      // don't change the owner when it's already OK, some systems remove
-      // permission or ACL stuff
-      FileInfo file_info;
-      if (!os_fileinfo(wfname, &file_info)
-          || file_info.stat.st_uid != file_info_old.stat.st_uid
-          || file_info.stat.st_gid != file_info_old.stat.st_gid) {
-        os_fchown(fd, (uv_uid_t)file_info_old.stat.st_uid, (uv_gid_t)file_info_old.stat.st_gid);
-        if (perm >= 0) {  // Set permission again, may have changed.
-          os_setperm(wfname, perm);
-        }
-      }
-      buf_set_file_id(buf);
-    } else if (!buf->file_id_valid) {
-      // Set the file_id when creating a new file.
-      buf_set_file_id(buf);
-    }
-#endif
-
-    if ((error = os_close(fd)) != 0) {
-      err = set_err_arg(_("E512: Close failed: %s"), error);
+    if (buf_write_close(buf, fd, wfname, backup, backup_copy, &file_info_old, perm,
+                        made_writable, acl, &err) == FAIL) {
       end = 0;
     }
 
-#ifdef UNIX
-    if (made_writable) {
-      perm &= ~0200;              // reset 'w' bit for security reasons
-    }
-#endif
-    if (perm >= 0) {  // Set perm. of new file same as old file.
-      os_setperm(wfname, perm);
-    }
-    // Probably need to set the ACL before changing the user (can't set the
-    // ACL on a file the user doesn't own).
-    if (!backup_copy) {
-      os_set_acl(wfname, acl);
-    }
-
     if (wfname != fname) {
       // The file was written to a temp file, now it needs to be converted
       // with 'charconvert' to (overwrite) the output file.
@@ -1714,32 +1962,9 @@ restore_backup:
       }
     }
 
-    // If we have a backup file, try to put it in place of the new file,
-    // because the new file is probably corrupt.  This avoids losing the
-    // original file when trying to make a backup when writing the file a
-    // second time.
-    // When "backup_copy" is set we need to copy the backup over the new
-    // file.  Otherwise rename the backup file.
     // If this is OK, don't give the extra warning message.
-    if (backup != NULL) {
-      if (backup_copy) {
-        // This may take a while, if we were interrupted let the user
-        // know we got the message.
-        if (got_int) {
-          msg(_(e_interr), 0);
-          ui_flush();
-        }
-
-        // copy the file.
-        if (os_copy(backup, fname, UV_FS_COPYFILE_FICLONE)
-            == 0) {
-          end = 1;  // success
-        }
-      } else {
-        if (vim_rename(backup, fname) == 0) {
-          end = 1;
-        }
-      }
+    if (buf_write_restore_backup(backup, backup_copy, fname)) {
+      end = 1;  // success
     }
     goto fail;
   }
@@ -1751,46 +1976,8 @@ restore_backup:
   fname = sfname;           // use shortname now, for the messages
 #endif
   if (!filtering) {
-    add_quoted_fname(IObuff, IOSIZE, buf, fname);
-    bool insert_space = false;
-    if (write_info.bw_conv_error) {
-      xstrlcat(IObuff, _(" CONVERSION ERROR"), IOSIZE);
-      insert_space = true;
-      if (write_info.bw_conv_error_lnum != 0) {
-        vim_snprintf_add(IObuff, IOSIZE, _(" in line %" PRId64 ";"),
-                         (int64_t)write_info.bw_conv_error_lnum);
-      }
-    } else if (notconverted) {
-      xstrlcat(IObuff, _("[NOT converted]"), IOSIZE);
-      insert_space = true;
-    } else if (converted) {
-      xstrlcat(IObuff, _("[converted]"), IOSIZE);
-      insert_space = true;
-    }
-    if (device) {
-      xstrlcat(IObuff, _("[Device]"), IOSIZE);
-      insert_space = true;
-    } else if (newfile) {
-      xstrlcat(IObuff, _("[New]"), IOSIZE);
-      insert_space = true;
-    }
-    if (no_eol) {
-      xstrlcat(IObuff, _("[noeol]"), IOSIZE);
-      insert_space = true;
-    }
-    // may add [unix/dos/mac]
-    if (msg_add_fileformat(fileformat)) {
-      insert_space = true;
-    }
-    msg_add_lines(insert_space, lnum, nchars);       // add line/char count
-    if (!shortmess(SHM_WRITE)) {
-      if (append) {
-        xstrlcat(IObuff, shortmess(SHM_WRI) ? _(" [a]") : _(" appended"), IOSIZE);
-      } else {
-        xstrlcat(IObuff, shortmess(SHM_WRI) ? _(" [w]") : _(" written"), IOSIZE);
-      }
-    }
-
+    buf_write_msg(buf, fname, &write_info, converted, notconverted, device, newfile, no_eol,
+                  fileformat, lnum, nchars, append);
     set_keep_msg(msg_trunc(IObuff, false, 0), 0);
   }
 
@@ -1799,15 +1986,7 @@ restore_backup:
   if (reset_changed && whole && !append
       && !write_info.bw_conv_error
       && (overwriting || vim_strchr(p_cpo, CPO_PLUS) != NULL)) {
-    unchanged(buf, true, false);
-    const varnumber_T changedtick = buf_get_changedtick(buf);
-    if (buf->b_last_changedtick + 1 == changedtick) {
-      // b:changedtick may be incremented in unchanged() but that should not
-      // trigger a TextChanged event.
-      buf->b_last_changedtick = changedtick;
-    }
-    u_unchanged(buf);
-    u_update_save_nr(buf);
+    buf_write_unchanged(buf);
   }
 
   // If written to the current file, update the timestamp of the swap file
@@ -1874,10 +2053,12 @@ fail:
   no_wait_return--;             // may wait for return now
 nofail:
 
-  // Done saving, we accept changed buffer warnings again
-  buf->b_saving = false;
+  // Done saving, we accept changed buffer warnings again.  For ":write
+  // ++async" not until buf_write_async_finish().
+  buf->b_saving = async_started;
 
   xfree(backup);
+  kv_destroy(snapshot);
   if (buffer != smallbuf) {
     xfree(buffer);
   }
@@ -1900,33 +2081,21 @@ nofail:
 
     retval = FAIL;
     if (end == 0) {
-      const int attr = HL_ATTR(HLF_E);  // Set highlight for error messages.
-      msg_puts_attr(_("\nWARNING: Original file may be lost or damaged\n"),
-                    attr | MSG_HIST);
-      msg_puts_attr(_("don't quit the editor until the file is successfully written!"),
-                    attr | MSG_HIST);
-
-      // Update the timestamp to avoid an "overwrite changed file"
-      // prompt when writing again.
-      if (os_fileinfo(fname, &file_info_old)) {
-        buf_store_file_info(buf, &file_info_old);
-        buf->b_mtime_read = buf->b_mtime;
-        buf->b_mtime_read_ns = buf->b_mtime_ns;
-      }
+      buf_write_lost_warning(buf, fname);
     }
   }
   msg_scroll = msg_save;
 
   // When writing the whole file and 'undofile' is set, also write the undo
   // file.
-  if (retval == OK && write_undo_file) {
+  if (retval == OK && write_undo_file && !async_started) {
     uint8_t hash[UNDO_HASH_SIZE];
 
     sha256_finish(&sha_ctx, hash);
     u_write_undo(NULL, false, buf, hash);
   }
 
-  if (!should_abort(retval)) {
+  if (!async_started && !should_abort(retval)) {
     buf_write_do_post_autocmds(buf, fname, eap, append, filtering, reset_changed, whole);
     if (aborting()) {       // autocmds may abort script processing
       retval = false;
@@ -1937,3 +2106,156 @@ nofail:
 
   return retval;
 }
+
+/// Start the worker thread for ":write ++async".  When that fails the file is
+/// written right away, it is still finished by buf_write_async_event().
+static void buf_write_async_start(bw_async_T *job)
+{
+  job->id = ++bw_async_last_id;
+  job->next = bw_async_list;
+  bw_async_list = job;
+
+  if (uv_thread_create(&job->thread, buf_write_async_main, job) == 0) {
+    job->threaded = true;
+    return;
+  }
+  ELOG("could not start a thread for \":write ++async\", writing directly");
+  buf_write_async_main(job);
+}
+
+/// Write the text of "job" and sync it.  Must not use any global state of the
+/// editor.
+static void buf_write_async_write(bw_async_T *job)
+{
+  ptrdiff_t written = job->len == 0 ? 0 : os_pwrite(job->fd, job->data, job->len, 0);
+  if (written < 0) {
+    job->write_error = (int)written;
+  } else if ((size_t)written != job->len) {
+    job->write_error = UV_EIO;
+  } else if (job->do_fsync) {
+    uv_fs_t req;
+    job->fsync_error = uv_fs_fsync(NULL, &req, job->fd, NULL);
+    uv_fs_req_cleanup(&req);
+  }
+}
+
+/// Main function of the worker thread of a ":write ++async".
+static void buf_write_async_main(void *arg)
+{
+  bw_async_T *job = arg;
+  buf_write_async_write(job);
+  loop_schedule_deferred(&main_loop,
+                         event_create(buf_write_async_event, (void *)(intptr_t)job->id));
+}
+
+/// Event from the worker thread: the text of a ":write ++async" was written.
+static void buf_write_async_event(void **argv)
+{
+  int id = (int)(intptr_t)argv[0];
+  for (bw_async_T **pp = &bw_async_list; *pp != NULL; pp = &(*pp)->next) {
+    if ((*pp)->id == id) {
+      bw_async_T *job = *pp;
+      *pp = job->next;
+      buf_write_async_finish(job);
+      return;
+    }
+  }
+  // Already finished by buf_write_async_wait().
+}
+
+/// Wait for the ":write ++async" of "buf" to be done, or of all buffers when
+/// "buf" is NULL, and finish it.  Used before the buffer is written or read
+/// again, abandoned or the editor exits.
+void buf_write_async_wait(buf_T *buf)
+{
+  // Autocommands may delete "buf".
+  const int fnum = buf == NULL ? 0 : buf->b_fnum;
+  bw_async_T **pp = &bw_async_list;
+  while (*pp != NULL) {
+    bw_async_T *job = *pp;
+    if (fnum != 0 && job->fnum != fnum) {
+      pp = &job->next;
+      continue;
+    }
+    *pp = job->next;
+    buf_write_async_finish(job);
+    // Autocommands may have started another write.
+    pp = &bw_async_list;
+  }
+}
+
+/// Finish a ":write ++async" after the text was written: close the file, give
+/// the message, reset 'modified', write the undo file and trigger
+/// BufWritePost.  The buffer may have been changed or deleted in the
+/// meantime.
+static void buf_write_async_finish(bw_async_T *job)
+{
+  if (job->threaded) {
+    uv_thread_join(&job->thread);
+  }
+
+  buf_T *buf = buflist_findnr(job->fnum);
+  // Changes made while writing are not in the file.
+  const bool same_text = buf != NULL && buf_get_changedtick(buf) == job->changedtick;
+  Error_T err = { 0 };
+  bool ok = true;
+
+  if (job->write_error != 0) {
+    err = set_err(_(e_write_error_file_system_full));
+    ok = false;
+  } else if (job->do_fsync) {
+    g_stats.fsync++;
+    if (job->fsync_error != 0 && job->fsync_error != UV_ENOTSUP) {
+      err = set_err_arg(e_fsync, job->fsync_error);
+      ok = false;
+    }
+  }
+  if (buf_write_close(buf, job->fd, job->fname, job->backup, job->backup_copy,
+                      &job->file_info_old, job->perm, job->made_writable, job->acl,
+                      &err) == FAIL) {
+    ok = false;
+  }
+
+  if (ok) {
+    xstrlcpy(IObuff, job->msg, IOSIZE);
+    set_keep_msg(msg_trunc(IObuff, false, 0), 0);
+
+    if (buf != NULL) {
+      if (job->reset_changed && same_text) {
+        buf_write_unchanged(buf);
+      }
+      if (job->overwriting) {
+        ml_timestamp(buf);
+        buf->b_flags &= ~BF_WRITE_MASK;
+      }
+    }
+
+    // Remove the backup unless 'backup' option is set
+    if (!p_bk && job->backup != NULL && os_remove(job->backup) != 0) {
+      emsg(_("E207: Can't delete backup file"));
+    }
+  } else {
+    add_quoted_fname(IObuff, IOSIZE - 100, buf, job->fname);
+    emit_err(&err);
+    if (!buf_write_restore_backup(job->backup, job->backup_copy, job->fname)) {
+      buf_write_lost_warning(buf, job->fname);
+    }
+  }
+
+  if (buf != NULL) {
+    buf->b_saving = false;
+    if (ok && job->write_undo_file && same_text) {
+      u_write_undo(NULL, false, buf, job->hash);
+    }
+    if (!should_abort(ok ? OK : FAIL)) {
+      buf_write_do_post_autocmds(buf, job->fname, NULL, false, false, true, true);
+    }
+  }
+
+  xfree(job->data);
+  xfree(job->fname);
+  xfree(job->msg);
+  xfree(job->backup);
+  os_free_acl(job->acl);
+  xfree(job);
+}
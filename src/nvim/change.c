@@ -187,6 +187,8 @@ static void changed_lines_invalidate_win(win_T *wp, linenr_T lnum, colnr_T col,
     approximate_botline_win(wp);
   }
 
+  plines_cache_changed(wp, lnum, lnume, xtra);
+
   // Check if any w_lines[] entries have become invalid.
   // For entries below the change: Correct the lnums for inserted/deleted lines.
   // Makes it possible to stop displaying after the change.
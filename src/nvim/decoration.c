@@ -15,6 +15,7 @@
 #include "nvim/drawscreen.h"
 #include "nvim/extmark.h"
 #include "nvim/fold.h"
+#include "nvim/globals.h"
 #include "nvim/grid.h"
 #include "nvim/grid_defs.h"
 #include "nvim/highlight.h"
@@ -94,6 +95,7 @@ void bufhl_add_hl_pos_offset(buf_T *buf, int src_id, int hl_id, lpos_T pos_start
 
 void decor_redraw(buf_T *buf, int row1, int row2, int col1, DecorInline decor)
 {
+  buf->b_marktree->changedtick++;
   if (decor.ext) {
     DecorVirtText *vt = decor.data.ext.vt;
     while (vt) {
@@ -174,6 +176,7 @@ DecorSignHighlight decor_sh_from_inline(DecorHighlightInline item)
 
 void buf_put_decor(buf_T *buf, DecorInline decor, int row, int row2)
 {
+  buf->b_marktree->changedtick++;
   if (decor.ext) {
     uint32_t idx = decor.data.ext.sh_idx;
     while (idx != DECOR_ID_INVALID) {
@@ -416,6 +419,7 @@ bool decor_redraw_start(win_T *wp, int top_row, DecorState *state)
 {
   buf_T *buf = wp->w_buffer;
   state->top_row = top_row;
+  state->changedtick = buf->b_marktree->changedtick;
   if (!marktree_itr_get_overlap(buf->b_marktree, top_row, 0, state->itr)) {
     return false;
   }
@@ -437,8 +441,14 @@ bool decor_redraw_start(win_T *wp, int top_row, DecorState *state)
 
 bool decor_redraw_line(win_T *wp, int row, DecorState *state)
 {
-  if (state->row == -1) {
-    decor_redraw_start(wp, row, state);
+  // At the start of a redraw, or when skipping lines that don't need to be
+  // redrawn, try to reuse what an earlier redraw found for this line.
+  bool skipped = state->row == -1 || row != state->row + 1;
+  if (!skipped || !decor_cache_restore(wp, row, state)) {
+    if (state->row == -1) {
+      decor_redraw_start(wp, row, state);
+    }
+    decor_cache_store(wp, row, state);
   }
   state->row = row;
   state->col_until = -1;
@@ -452,6 +462,115 @@ bool decor_redraw_line(win_T *wp, int row, DecorState *state)
   return (k.pos.row >= 0 && k.pos.row <= row);
 }
 
+/// Decoration state at the start of a line, kept in the window so that redrawing
+/// the line again doesn't need to look up the marks overlapping it.
+typedef struct {
+  int row;  ///< -1 when unused
+  MarkTreeIter itr[1];
+  kvec_t(DecorRange) ranges;  ///< the non-ephemeral ranges in DecorState.active
+} DecorCacheLine;
+
+enum { DECOR_CACHE_SIZE = 128, };  ///< must be a power of two
+
+struct decor_cache {
+  handle_T buf;          ///< buffer of the cached lines
+  uint64_t changedtick;  ///< of its marktree, when the lines were cached
+  DecorCacheLine lines[DECOR_CACHE_SIZE];
+};
+
+/// Get the decoration cache of window "wp", cleared when marks have changed.
+static struct decor_cache *decor_cache_get(win_T *wp)
+{
+  buf_T *buf = wp->w_buffer;
+  struct decor_cache *cache = wp->w_decor_cache;
+  if (cache == NULL) {
+    cache = wp->w_decor_cache = xcalloc(1, sizeof(*cache));
+  } else if (cache->buf == buf->handle && cache->changedtick == buf->b_marktree->changedtick) {
+    return cache;
+  }
+
+  cache->buf = buf->handle;
+  cache->changedtick = buf->b_marktree->changedtick;
+  for (size_t i = 0; i < DECOR_CACHE_SIZE; i++) {
+    cache->lines[i].row = -1;
+    kv_size(cache->lines[i].ranges) = 0;
+  }
+  return cache;
+}
+
+void decor_cache_free(win_T *wp)
+{
+  struct decor_cache *cache = wp->w_decor_cache;
+  if (cache == NULL) {
+    return;
+  }
+  for (size_t i = 0; i < DECOR_CACHE_SIZE; i++) {
+    kv_destroy(cache->lines[i].ranges);
+  }
+  XFREE_CLEAR(wp->w_decor_cache);
+}
+
+/// Restore the state at the start of line "row" from an earlier redraw.
+///
+/// @return false if the line is not cached
+static bool decor_cache_restore(win_T *wp, int row, DecorState *state)
+{
+  if (!wp->w_buffer->b_marktree->n_keys) {
+    return false;
+  }
+  struct decor_cache *cache = decor_cache_get(wp);
+  DecorCacheLine *line = &cache->lines[row & (DECOR_CACHE_SIZE - 1)];
+  if (line->row != row) {
+    g_stats.decor_cache_miss++;
+    return false;
+  }
+  g_stats.decor_cache_hit++;
+
+  // keep ephemeral ranges, they were added by decoration providers in this redraw
+  size_t j = 0;
+  for (size_t i = 0; i < kv_size(state->active); i++) {
+    if (kv_A(state->active, i).owned) {
+      kv_A(state->active, j++) = kv_A(state->active, i);
+    }
+  }
+  kv_size(state->active) = j;
+
+  for (size_t i = 0; i < kv_size(line->ranges); i++) {
+    DecorRange range = kv_A(line->ranges, i);
+    if (range.kind == kDecorKindHighlight && range.data.sh.hl_id) {
+      // highlight groups might have been redefined since
+      range.attr_id = syn_id2attr(range.data.sh.hl_id);
+    }
+    decor_range_insert(state, range);
+  }
+  *state->itr = *line->itr;
+  state->changedtick = cache->changedtick;
+  return true;
+}
+
+/// Save the state at the start of line "row" for later redraws.
+static void decor_cache_store(win_T *wp, int row, DecorState *state)
+{
+  MarkTree *b = wp->w_buffer->b_marktree;
+  if (!b->n_keys || state->changedtick != b->changedtick) {
+    return;
+  }
+  struct decor_cache *cache = decor_cache_get(wp);
+  DecorCacheLine *line = &cache->lines[row & (DECOR_CACHE_SIZE - 1)];
+  line->row = -1;
+  kv_size(line->ranges) = 0;
+  for (size_t i = 0; i < kv_size(state->active); i++) {
+    DecorRange item = kv_A(state->active, i);
+    if (item.kind == kDecorKindUIWatched) {
+      return;  // its attr_id can't be looked up again, don't cache the line
+    } else if (!item.owned) {
+      kv_push(line->ranges, item);
+    }
+  }
+  *line->itr = *state->itr;
+  line->row = row;
+}
+
 static void decor_range_add_from_inline(DecorState *state, int start_row, int start_col,
                                         int end_row, int end_col, DecorInline decor, bool owned,
                                         uint32_t ns, uint32_t mark_id)
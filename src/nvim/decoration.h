@@ -59,6 +59,7 @@ typedef struct {
 
 typedef struct {
   MarkTreeIter itr[1];
+  uint64_t changedtick;  ///< of the marktree when "itr" was positioned
   kvec_t(DecorRange) active;
   win_T *win;
   int top_row;
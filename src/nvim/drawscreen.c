@@ -76,6 +76,9 @@
 #include "nvim/drawline.h"
 #include "nvim/drawscreen.h"
 #include "nvim/eval.h"
+#include "nvim/event/defs.h"
+#include "nvim/event/multiqueue.h"
+#include "nvim/event/time.h"
 #include "nvim/ex_getln.h"
 #include "nvim/fold.h"
 #include "nvim/fold_defs.h"
@@ -88,6 +91,7 @@
 #include "nvim/highlight_defs.h"
 #include "nvim/highlight_group.h"
 #include "nvim/insexpand.h"
+#include "nvim/main.h"
 #include "nvim/marktree_defs.h"
 #include "nvim/match.h"
 #include "nvim/mbyte.h"
@@ -99,6 +103,7 @@
 #include "nvim/option.h"
 #include "nvim/option_vars.h"
 #include "nvim/os/os_defs.h"
+#include "nvim/os/time.h"
 #include "nvim/plines.h"
 #include "nvim/popupmenu.h"
 #include "nvim/pos_defs.h"
@@ -136,6 +141,13 @@ static bool redraw_popupmenu = false;
 static bool msg_grid_invalid = false;
 static bool resizing_autocmd = false;
 
+// Frame scheduling for 'redrawrate', see redraw_frame_wait().
+static TimeWatcher frame_timer;
+static bool frame_timer_pending = false;
+static bool frame_due = false;    ///< frame_timer expired since the last frame
+static bool frame_input = false;  ///< a key was typed since the last frame
+static uint64_t frame_time = 0;   ///< start of the last frame, os_hrtime()
+
 /// Check if the cursor line needs to be redrawn because of 'concealcursor'.
 ///
 /// When cursor is moved at the same time, both lines will be redrawn regardless.
@@ -415,6 +427,60 @@ bool redrawing(void)
          && !(p_lz && char_avail() && !KeyTyped && !do_redraw);
 }
 
+void drawscreen_init(void)
+{
+  time_watcher_init(&main_loop, &frame_timer, NULL);
+  frame_timer.events = multiqueue_new_child(main_loop.events);
+}
+
+void drawscreen_teardown(void)
+{
+  time_watcher_stop(&frame_timer);
+  multiqueue_free(frame_timer.events);
+  time_watcher_close(&frame_timer, NULL);
+}
+
+/// Called for every key which is not K_EVENT, so that the next redraw shows
+/// its effect without waiting for 'redrawrate'.
+void redraw_frame_input(void)
+{
+  frame_input = true;
+}
+
+/// Checks whether a redraw which was not caused by typing, e.g. output of a
+/// job arriving in a buffer or terminal, should wait to keep the number of
+/// frames below 'redrawrate' per second.  Redraw requests arriving meanwhile
+/// are coalesced into one frame, which is done when the main loop wakes up
+/// after frame_timer expired.
+///
+/// @return true if the caller should not call update_screen() now.
+bool redraw_frame_wait(void)
+{
+  if (p_rdr <= 0 || frame_input || frame_due || exiting) {
+    return false;
+  }
+  uint64_t interval = 1000000000 / (uint64_t)p_rdr;
+  uint64_t elapsed = os_hrtime() - frame_time;
+  if (elapsed >= interval) {
+    return false;
+  }
+  if (!frame_timer_pending) {
+    frame_timer_pending = true;
+    uint64_t delay = (interval - elapsed + 999999) / 1000000;
+    time_watcher_start(&frame_timer, frame_timer_cb, delay, 0);
+  }
+  g_stats.redraw_postponed++;
+  return true;
+}
+
+static void frame_timer_cb(TimeWatcher *watcher, void *data)
+{
+  // Nothing else to do, processing this event returns K_EVENT from the
+  // main loop, which then redraws.
+  frame_timer_pending = false;
+  frame_due = true;
+}
+
 /// Redraw the parts of the screen that is marked for redraw.
 ///
 /// Most code shouldn't call this directly, rather use redraw_later() and
@@ -460,6 +526,11 @@ int update_screen(void)
 
   updating_screen = true;
 
+  frame_time = os_hrtime();
+  frame_input = false;
+  frame_due = false;
+  g_stats.redraw_frames++;
+
   display_tick++;  // let syntax code know we're in a next round of
                    // display updating
 
@@ -644,7 +715,9 @@ int update_screen(void)
         did_one = true;
         start_search_hl();
       }
+      uint64_t start = os_hrtime();
       win_update(wp);
+      g_stats.redraw_win_update_ns += (int64_t)(os_hrtime() - start);
     }
 
     // redraw status line and window bar after the window to minimize cursor movement
@@ -1391,7 +1391,7 @@ void ins_redraw(bool ready)
 
   pum_check_clear();
   show_cursor_info_later(false);
-  if (must_redraw) {
+  if (must_redraw && !redraw_frame_wait()) {
     update_screen();
   } else {
     redraw_statuslines();
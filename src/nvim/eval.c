@@ -7392,6 +7392,9 @@ char *set_cmdarg(exarg_T *eap, char *oldarg)
   if (eap->mkdir_p != 0) {
     len += 4;  // " ++p"
   }
+  if (eap->write_async != 0) {
+    len += 8;  // " ++async"
+  }
 
   const size_t newval_len = len + 1;
   char *newval = xmalloc(newval_len);
@@ -7464,6 +7467,13 @@ char *set_cmdarg(exarg_T *eap, char *oldarg)
     }
     xlen += (size_t)rc;
   }
+  if (eap->write_async != 0) {
+    rc = snprintf(newval + xlen, newval_len - xlen, " ++async");
+    if (rc < 0) {
+      goto error;
+    }
+    xlen += (size_t)rc;
+  }
   assert(xlen <= newval_len);
 
   vimvars[VV_CMDARG].vv_str = newval;
@@ -5,6 +5,7 @@
 #include <stdbool.h>
 #include <uv.h>
 
+#include "klib/kvec.h"
 #include "nvim/eval/typval_defs.h"
 #include "nvim/rbuffer_defs.h"
 #include "nvim/types_defs.h"
@@ -99,8 +100,14 @@ struct stream {
   size_t pending_reqs;
   size_t num_bytes;
   MultiQueue *events;
+  /// Buffers waiting for the write in flight to finish, written together
+  /// with a single write request.
+  kvec_t(WBuffer *) write_queue;
 };
 
+/// Shared memory ring buffer, see event/shmring.c
+typedef struct shm_ring ShmRing;
+
 #define ADDRESS_MAX_SIZE 256
 
 typedef struct socket_watcher SocketWatcher;
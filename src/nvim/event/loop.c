@@ -14,6 +14,24 @@
 # include "event/loop.c.generated.h"
 #endif
 
+// Atomic operations used by the thread event queue. Exchanges are full
+// barriers, loads acquire and stores release.
+#ifdef _MSC_VER
+# define ATOMIC_LOAD_PTR(p) InterlockedCompareExchangePointer((void *volatile *)(p), NULL, NULL)
+# define ATOMIC_STORE_PTR(p, v) (void)InterlockedExchangePointer((void *volatile *)(p), (v))
+# define ATOMIC_XCHG_PTR(p, v) InterlockedExchangePointer((void *volatile *)(p), (v))
+# define ATOMIC_LOAD_INT(p) InterlockedCompareExchange((volatile LONG *)(p), 0, 0)
+# define ATOMIC_XCHG_INT(p, v) InterlockedExchange((volatile LONG *)(p), (v))
+# define ATOMIC_ADD_INT(p, v) InterlockedExchangeAdd((volatile LONG *)(p), (v))
+#else
+# define ATOMIC_LOAD_PTR(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+# define ATOMIC_STORE_PTR(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+# define ATOMIC_XCHG_PTR(p, v) __atomic_exchange_n((p), (v), __ATOMIC_ACQ_REL)
+# define ATOMIC_LOAD_INT(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+# define ATOMIC_XCHG_INT(p, v) __atomic_exchange_n((p), (v), __ATOMIC_ACQ_REL)
+# define ATOMIC_ADD_INT(p, v) __atomic_fetch_add((p), (v), __ATOMIC_RELAXED)
+#endif
+
 void loop_init(Loop *loop, void *data)
 {
   uv_loop_init(&loop->uv);
@@ -23,8 +41,7 @@ void loop_init(Loop *loop, void *data)
   loop->children = kl_init(WatcherPtr);
   loop->events = multiqueue_new_parent(loop_on_put, loop);
   loop->fast_events = multiqueue_new_child(loop->events);
-  loop->thread_events = multiqueue_new_parent(NULL, NULL);
-  uv_mutex_init(&loop->mutex);
+  thread_events_init(&loop->thread_events);
   uv_async_init(&loop->uv, &loop->async, async_cb);
   uv_signal_init(&loop->uv, &loop->children_watcher);
   uv_timer_init(&loop->uv, &loop->children_kill_timer);
@@ -94,10 +111,14 @@ bool loop_poll_events(Loop *loop, int64_t ms)
 /// @see loop_schedule_deferred
 void loop_schedule_fast(Loop *loop, Event event)
 {
-  uv_mutex_lock(&loop->mutex);
-  multiqueue_put_event(loop->thread_events, event);
-  uv_async_send(&loop->async);
-  uv_mutex_unlock(&loop->mutex);
+  ThreadEvent *item = xmalloc(sizeof(*item));
+  item->event = event;
+  thread_events_push(&loop->thread_events, item);
+  // Only the first event after async_cb() started draining needs a wakeup,
+  // later ones are picked up by the same async_cb() call.
+  if (!ATOMIC_XCHG_INT(&loop->thread_events.wakeup_pending, 1)) {
+    uv_async_send(&loop->async);
+  }
 }
 
 /// Schedules an event from another thread. Unlike loop_schedule_fast(), the
@@ -148,7 +169,6 @@ bool loop_close(Loop *loop, bool wait)
 {
   bool rv = true;
   loop->closing = true;
-  uv_mutex_destroy(&loop->mutex);
   uv_close((uv_handle_t *)&loop->children_watcher, NULL);
   uv_close((uv_handle_t *)&loop->children_kill_timer, NULL);
   uv_close((uv_handle_t *)&loop->poll_timer, timer_close_cb);
@@ -184,39 +204,103 @@ bool loop_close(Loop *loop, bool wait)
     }
 #endif
   }
+  thread_events_clear(&loop->thread_events);
   multiqueue_free(loop->fast_events);
-  multiqueue_free(loop->thread_events);
   multiqueue_free(loop->events);
   kl_destroy(WatcherPtr, loop->children);
   return rv;
 }
 
+/// Drops pending events. Must be called from the thread running the loop.
 void loop_purge(Loop *loop)
 {
-  uv_mutex_lock(&loop->mutex);
-  multiqueue_purge_events(loop->thread_events);
+  thread_events_clear(&loop->thread_events);
   multiqueue_purge_events(loop->fast_events);
-  uv_mutex_unlock(&loop->mutex);
 }
 
+/// Number of events scheduled from other threads, which were not yet moved to
+/// `fast_events`.
 size_t loop_size(Loop *loop)
 {
-  uv_mutex_lock(&loop->mutex);
-  size_t rv = multiqueue_size(loop->thread_events);
-  uv_mutex_unlock(&loop->mutex);
-  return rv;
+  return (size_t)ATOMIC_LOAD_INT(&loop->thread_events.size);
 }
 
 static void async_cb(uv_async_t *handle)
 {
   Loop *l = handle->loop->data;
-  uv_mutex_lock(&l->mutex);
+  // Reset before draining: an event pushed after this point sends a new
+  // wakeup, and one pushed before it is visible to thread_events_pop().
+  (void)ATOMIC_XCHG_INT(&l->thread_events.wakeup_pending, 0);
   // Flush thread_events to fast_events for processing on main loop.
-  while (!multiqueue_empty(l->thread_events)) {
-    Event ev = multiqueue_get(l->thread_events);
-    multiqueue_put_event(l->fast_events, ev);
+  ThreadEvent *item;
+  while ((item = thread_events_pop(&l->thread_events)) != NULL) {
+    multiqueue_put_event(l->fast_events, item->event);
+    xfree(item);
+  }
+}
+
+static void thread_events_init(ThreadEventQueue *q)
+{
+  q->stub.next = NULL;
+  q->head = &q->stub;
+  q->tail = &q->stub;
+  q->size = 0;
+  q->wakeup_pending = 0;
+}
+
+/// Pushes "item" to "q". Can be called from any thread.
+static void thread_events_push(ThreadEventQueue *q, ThreadEvent *item)
+{
+  if (item != &q->stub) {
+    ATOMIC_ADD_INT(&q->size, 1);
+  }
+  item->next = NULL;
+  ThreadEvent *prev = ATOMIC_XCHG_PTR(&q->head, item);
+  // Until this store, the item is not reachable from "tail" yet.
+  ATOMIC_STORE_PTR(&prev->next, item);
+}
+
+/// Pops the oldest item from "q". Must only be called from the loop thread.
+///
+/// @return NULL if "q" is empty, or if the next item is still being pushed.
+///         In the latter case the producer sends a wakeup after it is done.
+static ThreadEvent *thread_events_pop(ThreadEventQueue *q)
+{
+  ThreadEvent *tail = q->tail;
+  ThreadEvent *next = ATOMIC_LOAD_PTR(&tail->next);
+  if (tail == &q->stub) {
+    if (next == NULL) {
+      return NULL;
+    }
+    q->tail = next;
+    tail = next;
+    next = ATOMIC_LOAD_PTR(&tail->next);
+  }
+
+  if (next == NULL) {
+    if (tail != ATOMIC_LOAD_PTR(&q->head)) {
+      return NULL;
+    }
+    // "tail" is the last item. Push the stub behind it, so that it can be
+    // unlinked from the queue.
+    thread_events_push(q, &q->stub);
+    next = ATOMIC_LOAD_PTR(&tail->next);
+    if (next == NULL) {
+      return NULL;
+    }
+  }
+
+  q->tail = next;
+  ATOMIC_ADD_INT(&q->size, -1);
+  return tail;
+}
+
+static void thread_events_clear(ThreadEventQueue *q)
+{
+  ThreadEvent *item;
+  while ((item = thread_events_pop(q)) != NULL) {
+    xfree(item);
   }
-  uv_mutex_unlock(&l->mutex);
 }
 
 static void timer_cb(uv_timer_t *handle)
@@ -12,10 +12,28 @@ typedef void *WatcherPtr;
 #define _NOOP(x)
 KLIST_INIT(WatcherPtr, WatcherPtr, _NOOP)
 
+typedef struct thread_event ThreadEvent;
+struct thread_event {
+  ThreadEvent *next;
+  Event event;
+};
+
+/// Lock-free queue of events scheduled from other threads. Any thread can
+/// push, but only the thread running the loop pops (Vyukov's intrusive MPSC
+/// queue). "stub" sits between "head" and "tail" to keep the fields written by
+/// producers and by the consumer apart.
+typedef struct {
+  ThreadEvent *head;  ///< last pushed item, swapped by producers
+  ThreadEvent stub;
+  ThreadEvent *tail;  ///< next item to pop, only used by the loop thread
+  int size;
+  int wakeup_pending;  ///< loop->async was sent but async_cb() didn't run yet
+} ThreadEventQueue;
+
 struct loop {
   uv_loop_t uv;
   MultiQueue *events;
-  MultiQueue *thread_events;
+  ThreadEventQueue thread_events;
   // Immediate events:
   //    "Processed after exiting uv_run() (to avoid recursion), but before
   //    returning from loop_poll_events()." 502aee690c98
@@ -38,7 +56,6 @@ struct loop {
   uv_timer_t exit_delay_timer;
 
   uv_async_t async;
-  uv_mutex_t mutex;
   int recursive;
   bool closing;  ///< Set to true if loop_close() has been called
 };
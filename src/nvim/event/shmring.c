@@ -0,0 +1,336 @@
+/// Shared memory ring buffer, used by an RPC channel to pass data to another
+/// process on the same machine without copying it through the kernel.
+///
+/// The ring is a memfd holding a header page followed by "size" bytes of data.
+/// The data is mapped twice in a row, so the readable and writable parts are
+/// always contiguous, even when they wrap around the end of the ring. There is
+/// a single writer and a single reader. "head" and "tail" count the bytes
+/// written and read so far and are only increased, by the writer and the
+/// reader respectively.
+///
+/// The ring cannot wake up the other side by itself. A side which runs out of
+/// data (reader) or space (writer) sets its "waiting" flag. The other side
+/// clears the flag when it makes progress, and then has to notify the waiting
+/// side some other way.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "auto/config.h"
+#include "nvim/event/defs.h"
+#include "nvim/event/shmring.h"
+
+#ifdef HAVE_MEMFD_CREATE
+# include <errno.h>
+# include <fcntl.h>
+# include <inttypes.h>
+# include <stdio.h>
+# include <string.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+
+# include "nvim/log.h"
+# include "nvim/macros_defs.h"
+# include "nvim/memory.h"
+# include "nvim/os/os.h"
+
+# define SHMRING_MAGIC 0x6e76696dU  // "nvim"
+# define SHMRING_VERSION 1U
+# define SHMRING_SEALS (F_SEAL_SHRINK | F_SEAL_GROW)
+
+/// Start of the memfd. Fields changed by the writer and by the reader are kept
+/// on separate cache lines.
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t size;         ///< bytes of data, a power of two
+  uint64_t data_offset;  ///< offset of the data in the memfd
+  char pad0[40];
+  uint64_t head;            ///< bytes written, only changed by the writer
+  uint32_t reader_waiting;  ///< set by the reader when it ran out of data
+  char pad1[52];
+  uint64_t tail;            ///< bytes read, only changed by the reader
+  uint32_t writer_waiting;  ///< set by the writer when it ran out of space
+} ShmRingHeader;
+
+struct shm_ring {
+  int fd;
+  ShmRingHeader *hdr;
+  size_t hdr_size;
+  char *data;  ///< "size" bytes, mapped twice
+  size_t size;
+  uint64_t pos;   ///< own copy of "head" (writer) or "tail" (reader)
+  uint64_t seen;  ///< reader: "head" when data was last looked at
+  char path[64];
+};
+
+# ifdef INCLUDE_GENERATED_DECLARATIONS
+#  include "event/shmring.c.generated.h"
+# endif
+
+/// Creates a ring of "size" bytes, to be read by this process.
+///
+/// @param size  A power of two and a multiple of the page size.
+/// @return NULL if the ring could not be created.
+ShmRing *shmring_new(size_t size)
+{
+  int fd = memfd_create("nvim-rpc-ring", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+  if (fd < 0) {
+    WLOG("memfd_create failed: %s", strerror(errno));
+    return NULL;
+  }
+  size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  if (ftruncate(fd, (off_t)(page + size)) != 0
+      || fcntl(fd, F_ADD_SEALS, SHMRING_SEALS | F_SEAL_SEAL) != 0) {
+    WLOG("could not set up ring: %s", strerror(errno));
+    close(fd);
+    return NULL;
+  }
+
+  ShmRing *ring = map_ring(fd, page, size);
+  if (ring == NULL) {
+    close(fd);
+    return NULL;
+  }
+  ShmRingHeader *hdr = ring->hdr;
+  hdr->magic = SHMRING_MAGIC;
+  hdr->version = SHMRING_VERSION;
+  hdr->size = size;
+  hdr->data_offset = page;
+  // Nothing was read yet, the first write must notify the reader.
+  hdr->reader_waiting = 1;
+  snprintf(ring->path, sizeof(ring->path), "/proc/%" PRId64 "/fd/%d", os_get_pid(), fd);
+  return ring;
+}
+
+/// Opens the ring at "path", created by another process with shmring_new(),
+/// for writing.
+///
+/// @return NULL if "path" is not a usable ring.
+ShmRing *shmring_open(const char *path)
+{
+  int fd = open(path, O_RDWR | O_CLOEXEC);
+  if (fd < 0) {
+    WLOG("could not open ring %s: %s", path, strerror(errno));
+    return NULL;
+  }
+
+  // Only accept a memfd which cannot be resized, accessing the mapping after
+  // the other side truncated it would crash.
+  int seals = fcntl(fd, F_GET_SEALS);
+  size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  struct stat st;
+  ShmRingHeader hdr;
+  if (seals < 0 || (seals & SHMRING_SEALS) != SHMRING_SEALS
+      || fstat(fd, &st) != 0 || (size_t)st.st_size <= page
+      || pread(fd, &hdr, sizeof(hdr), 0) != sizeof(hdr)
+      || hdr.magic != SHMRING_MAGIC || hdr.version != SHMRING_VERSION
+      || hdr.data_offset != page || hdr.size != (size_t)st.st_size - page
+      || hdr.size % page != 0 || (hdr.size & (hdr.size - 1)) != 0) {
+    WLOG("not a usable ring: %s", path);
+    close(fd);
+    return NULL;
+  }
+
+  ShmRing *ring = map_ring(fd, page, (size_t)hdr.size);
+  if (ring == NULL) {
+    close(fd);
+    return NULL;
+  }
+  ring->pos = __atomic_load_n(&ring->hdr->head, __ATOMIC_ACQUIRE);
+  xstrlcpy(ring->path, path, sizeof(ring->path));
+  return ring;
+}
+
+static ShmRing *map_ring(int fd, size_t page, size_t size)
+{
+  void *hdr = mmap(NULL, page, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (hdr == MAP_FAILED) {
+    WLOG("mmap failed: %s", strerror(errno));
+    return NULL;
+  }
+
+  // Reserve twice the size, then map the data into both halves.
+  char *data = mmap(NULL, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (data == MAP_FAILED
+      || mmap(data, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd,
+              (off_t)page) == MAP_FAILED
+      || mmap(data + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd,
+              (off_t)page) == MAP_FAILED) {
+    WLOG("mmap failed: %s", strerror(errno));
+    if (data != MAP_FAILED) {
+      munmap(data, 2 * size);
+    }
+    munmap(hdr, page);
+    return NULL;
+  }
+
+  ShmRing *ring = xcalloc(1, sizeof(ShmRing));
+  ring->fd = fd;
+  ring->hdr = hdr;
+  ring->hdr_size = page;
+  ring->data = data;
+  ring->size = size;
+  return ring;
+}
+
+void shmring_free(ShmRing *ring)
+{
+  if (ring == NULL) {
+    return;
+  }
+  munmap(ring->data, 2 * ring->size);
+  munmap(ring->hdr, ring->hdr_size);
+  close(ring->fd);
+  xfree(ring);
+}
+
+/// Path under which another process can open the ring with shmring_open().
+const char *shmring_path(ShmRing *ring)
+{
+  return ring->path;
+}
+
+/// Copies as much of "data" into the ring as fits.
+///
+/// @return number of bytes written, or -1 if the reader broke the ring.
+ptrdiff_t shmring_write(ShmRing *ring, const char *data, size_t size)
+{
+  uint64_t used = ring->pos - __atomic_load_n(&ring->hdr->tail, __ATOMIC_ACQUIRE);
+  if (used > ring->size) {
+    return -1;
+  }
+  size_t n = MIN(size, ring->size - (size_t)used);
+  if (n == 0) {
+    return 0;
+  }
+  memcpy(ring->data + (ring->pos & (ring->size - 1)), data, n);
+  ring->pos += n;
+  __atomic_store_n(&ring->hdr->head, ring->pos, __ATOMIC_SEQ_CST);
+  return (ptrdiff_t)n;
+}
+
+/// Called by the writer after writing.
+///
+/// @return true if the reader waits for data and must be notified.
+bool shmring_wake_reader(ShmRing *ring)
+{
+  return __atomic_exchange_n(&ring->hdr->reader_waiting, 0, __ATOMIC_SEQ_CST) != 0;
+}
+
+/// Called by the writer when the ring is full.
+///
+/// @return true if the reader made room meanwhile. Otherwise the reader will
+///         notify the writer when it does.
+bool shmring_wait_space(ShmRing *ring)
+{
+  __atomic_store_n(&ring->hdr->writer_waiting, 1, __ATOMIC_SEQ_CST);
+  uint64_t tail = __atomic_load_n(&ring->hdr->tail, __ATOMIC_SEQ_CST);
+  if (ring->pos - tail >= ring->size) {
+    return false;
+  }
+  __atomic_store_n(&ring->hdr->writer_waiting, 0, __ATOMIC_SEQ_CST);
+  return true;
+}
+
+/// Gets the data which can be read.
+///
+/// @param[out] size  number of bytes
+/// @return NULL if the writer broke the ring.
+char *shmring_read_ptr(ShmRing *ring, size_t *size)
+{
+  ring->seen = __atomic_load_n(&ring->hdr->head, __ATOMIC_ACQUIRE);
+  uint64_t avail = ring->seen - ring->pos;
+  if (avail > ring->size) {
+    return NULL;
+  }
+  *size = (size_t)avail;
+  return ring->data + (ring->pos & (ring->size - 1));
+}
+
+/// Marks "count" bytes returned by shmring_read_ptr() as read.
+///
+/// @return true if the writer waits for space and must be notified.
+bool shmring_consumed(ShmRing *ring, size_t count)
+{
+  ring->pos += count;
+  __atomic_store_n(&ring->hdr->tail, ring->pos, __ATOMIC_SEQ_CST);
+  return __atomic_exchange_n(&ring->hdr->writer_waiting, 0, __ATOMIC_SEQ_CST) != 0;
+}
+
+/// Called by the reader when it needs more data than shmring_read_ptr() gave.
+///
+/// @return true if more data was written meanwhile. Otherwise the writer will
+///         notify the reader when it writes.
+bool shmring_wait_data(ShmRing *ring)
+{
+  __atomic_store_n(&ring->hdr->reader_waiting, 1, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(&ring->hdr->head, __ATOMIC_SEQ_CST) == ring->seen) {
+    return false;
+  }
+  __atomic_store_n(&ring->hdr->reader_waiting, 0, __ATOMIC_SEQ_CST);
+  return true;
+}
+
+#else
+
+// Without memfd_create() a ring is never created, so none of the functions
+// below is reached.
+
+# ifdef INCLUDE_GENERATED_DECLARATIONS
+#  include "event/shmring.c.generated.h"
+# endif
+
+ShmRing *shmring_new(size_t size)
+{
+  return NULL;
+}
+
+ShmRing *shmring_open(const char *path)
+{
+  return NULL;
+}
+
+void shmring_free(ShmRing *ring)
+{
+}
+
+const char *shmring_path(ShmRing *ring)
+{
+  abort();
+}
+
+ptrdiff_t shmring_write(ShmRing *ring, const char *data, size_t size)
+{
+  abort();
+}
+
+bool shmring_wake_reader(ShmRing *ring)
+{
+  abort();
+}
+
+bool shmring_wait_space(ShmRing *ring)
+{
+  abort();
+}
+
+char *shmring_read_ptr(ShmRing *ring, size_t *size)
+{
+  abort();
+}
+
+bool shmring_consumed(ShmRing *ring, size_t count)
+{
+  abort();
+}
+
+bool shmring_wait_data(ShmRing *ring)
+{
+  abort();
+}
+
+#endif
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <stdbool.h>  // IWYU pragma: keep
+#include <stddef.h>  // IWYU pragma: keep
+
+#include "nvim/event/defs.h"  // IWYU pragma: keep
+
+#ifdef INCLUDE_GENERATED_DECLARATIONS
+# include "event/shmring.h.generated.h"
+#endif
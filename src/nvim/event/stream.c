@@ -4,10 +4,13 @@
 #include <uv.h>
 #include <uv/version.h>
 
+#include "klib/kvec.h"
 #include "nvim/event/defs.h"
 #include "nvim/event/loop.h"
 #include "nvim/event/stream.h"
+#include "nvim/event/wstream.h"
 #include "nvim/log.h"
+#include "nvim/memory.h"
 #include "nvim/rbuffer.h"
 #include "nvim/types_defs.h"
 #ifdef MSWIN
@@ -97,6 +100,7 @@ void stream_init(Loop *loop, Stream *stream, int fd, uv_stream_t *uvstream)
   stream->buffer = NULL;
   stream->events = NULL;
   stream->num_bytes = 0;
+  kv_init(stream->write_queue);
 }
 
 void stream_close(Stream *stream, stream_close_cb on_stream_close, void *data)
@@ -155,10 +159,19 @@ static void close_cb(uv_handle_t *handle)
   if (stream->buffer) {
     rbuffer_free(stream->buffer);
   }
+  // Queued writes are issued before the handle is closed, unless the stream
+  // failed.
+  for (size_t i = 0; i < kv_size(stream->write_queue); i++) {
+    wstream_release_wbuffer(kv_A(stream->write_queue, i));
+  }
+  kv_destroy(stream->write_queue);
+  // "close_cb" may free the memory of the stream.
+  stream_close_cb internal_close_cb = stream->internal_close_cb;
+  void *internal_data = stream->internal_data;
   if (stream->close_cb) {
     stream->close_cb(stream, stream->close_cb_data);
   }
-  if (stream->internal_close_cb) {
-    stream->internal_close_cb(stream, stream->internal_data);
+  if (internal_close_cb) {
+    internal_close_cb(stream, internal_data);
   }
 }
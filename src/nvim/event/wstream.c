@@ -3,9 +3,11 @@
 #include <stddef.h>
 #include <uv.h>
 
+#include "klib/kvec.h"
 #include "nvim/event/defs.h"
 #include "nvim/event/stream.h"
 #include "nvim/event/wstream.h"
+#include "nvim/globals.h"
 #include "nvim/macros_defs.h"
 #include "nvim/memory.h"
 #include "nvim/types_defs.h"
@@ -14,8 +16,9 @@
 
 typedef struct {
   Stream *stream;
-  WBuffer *buffer;
   uv_write_t uv_req;
+  size_t nbufs;
+  WBuffer *buffers[];
 } WRequest;
 
 #ifdef INCLUDE_GENERATED_DECLARATIONS
@@ -63,6 +66,11 @@ void wstream_set_write_cb(Stream *stream, stream_write_cb cb, void *data)
 /// instance. This will fail if the write would cause the Stream use more
 /// memory than specified by `maxmem`.
 ///
+/// When no write is in flight, the data is written right away. Otherwise it
+/// waits for that write to finish, and all buffers queued in the meantime are
+/// written together by a single request (writev), so that many small buffers,
+/// as produced by a remote UI during a big redraw, don't cost a syscall each.
+///
 /// @param stream The `Stream` instance
 /// @param buffer The buffer which contains data to be written
 /// @return false if the write failed
@@ -79,21 +87,19 @@ bool wstream_write(Stream *stream, WBuffer *buffer)
 
   stream->curmem += buffer->size;
 
-  WRequest *data = xmalloc(sizeof(WRequest));
-  data->stream = stream;
-  data->buffer = buffer;
-  data->uv_req.data = data;
-
-  uv_buf_t uvbuf;
-  uvbuf.base = buffer->data;
-  uvbuf.len = UV_BUF_LEN(buffer->size);
+  if (kv_size(stream->write_queue) > 0
+      || uv_stream_get_write_queue_size(stream->uvstream) > 0) {
+    // The previous write is waiting for the other side to read. Its callback
+    // writes the queued buffers.
+    kv_push(stream->write_queue, buffer);
+    return true;
+  }
 
-  if (uv_write(&data->uv_req, stream->uvstream, &uvbuf, 1, write_cb)) {
-    xfree(data);
+  if (write_buffers(stream, &buffer, 1) != 0) {
+    stream->curmem -= buffer->size;
     goto err;
   }
 
-  stream->pending_reqs++;
   return true;
 
 err:
@@ -101,6 +107,70 @@ err:
   return false;
 }
 
+/// Writes "nbufs" buffers with a single write request.
+///
+/// @return libuv error code if the request could not be made. The buffers are
+///         not released then.
+static int write_buffers(Stream *stream, WBuffer **buffers, size_t nbufs)
+{
+  WRequest *data = xmalloc(sizeof(WRequest) + nbufs * sizeof(WBuffer *));
+  data->stream = stream;
+  data->uv_req.data = data;
+  data->nbufs = nbufs;
+
+  uv_buf_t stackbufs[16];
+  uv_buf_t *uvbufs = nbufs > ARRAY_SIZE(stackbufs) ? xmalloc(nbufs * sizeof(uv_buf_t)) : stackbufs;
+  size_t size = 0;
+  for (size_t i = 0; i < nbufs; i++) {
+    data->buffers[i] = buffers[i];
+    uvbufs[i].base = buffers[i]->data;
+    uvbufs[i].len = UV_BUF_LEN(buffers[i]->size);
+    size += buffers[i]->size;
+  }
+
+  // libuv copies the uv_buf_t array, only the data must stay valid.
+  int err = uv_write(&data->uv_req, stream->uvstream, uvbufs, (unsigned)nbufs, write_cb);
+  if (uvbufs != stackbufs) {
+    xfree(uvbufs);
+  }
+  if (err) {
+    xfree(data);
+    return err;
+  }
+
+  g_stats.stream_writes++;
+  g_stats.stream_write_bufs += (int64_t)nbufs;
+  g_stats.stream_write_bytes += (int64_t)size;
+  stream->pending_reqs++;
+  return 0;
+}
+
+/// Writes all queued buffers of "stream" with a single request.
+///
+/// @return libuv error code if the request could not be made. The queued
+///         buffers are dropped then.
+static int write_queued(Stream *stream)
+{
+  size_t nbufs = kv_size(stream->write_queue);
+  if (nbufs == 0) {
+    return 0;
+  }
+  int err = write_buffers(stream, stream->write_queue.items, nbufs);
+  if (err) {
+    release_buffers(stream, stream->write_queue.items, nbufs);
+  }
+  kv_size(stream->write_queue) = 0;
+  return err;
+}
+
+static void release_buffers(Stream *stream, WBuffer **buffers, size_t nbufs)
+{
+  for (size_t i = 0; i < nbufs; i++) {
+    stream->curmem -= buffers[i]->size;
+    wstream_release_wbuffer(buffers[i]);
+  }
+}
+
 /// Creates a WBuffer object for holding output data. Instances of this
 /// object can be reused across Stream instances, and the memory is freed
 /// automatically when no longer needed (it tracks the number of references
@@ -128,20 +198,27 @@ WBuffer *wstream_new_buffer(char *data, size_t size, size_t refcount, wbuffer_da
 static void write_cb(uv_write_t *req, int status)
 {
   WRequest *data = req->data;
+  Stream *stream = data->stream;
 
-  data->stream->curmem -= data->buffer->size;
+  release_buffers(stream, data->buffers, data->nbufs);
 
-  wstream_release_wbuffer(data->buffer);
+  if (status == 0) {
+    status = write_queued(stream);
+  } else {
+    // The stream failed, queued data can't be written either.
+    release_buffers(stream, stream->write_queue.items, kv_size(stream->write_queue));
+    kv_size(stream->write_queue) = 0;
+  }
 
-  if (data->stream->write_cb) {
-    data->stream->write_cb(data->stream, data->stream->cb_data, status);
+  if (stream->write_cb) {
+    stream->write_cb(stream, stream->cb_data, status);
   }
 
-  data->stream->pending_reqs--;
+  stream->pending_reqs--;
 
-  if (data->stream->closed && data->stream->pending_reqs == 0) {
+  if (stream->closed && stream->pending_reqs == 0) {
     // Last pending write, free the stream;
-    stream_close_handle(data->stream);
+    stream_close_handle(stream);
   }
 
   xfree(data);
@@ -153,6 +153,13 @@ bool check_changed(buf_T *buf, int flags)
   bufref_T bufref;
   set_bufref(&bufref, buf);
 
+  // 'modified' is reset when a ":write ++async" is done.
+  buf_write_async_wait(buf);
+  if (!bufref_valid(&bufref)) {
+    // Autocommand deleted buffer, oops!  It's not changed now.
+    return false;
+  }
+
   if (!forceit
       && bufIsChanged(buf)
       && ((flags & CCGD_MULTWIN) || buf->b_nwindows <= 1)
@@ -316,6 +323,9 @@ bool check_changed_any(bool hidden, bool unload)
   int bufnum = 0;
   size_t bufcount = 0;
 
+  // 'modified' is reset when a ":write ++async" is done.
+  buf_write_async_wait(NULL);
+
   // Make a list of all buffers, with the most important ones first.
   FOR_ALL_BUFFERS(buf) {
     bufcount++;
@@ -1323,6 +1323,7 @@ void set_cmd_dflall_range(exarg_T *eap)
   switch (eap->addr_type) {
   case ADDR_LINES:
   case ADDR_OTHER:
+    buf_load_wait(curbuf);
     eap->line2 = curbuf->b_ml.ml_line_count;
     break;
   case ADDR_LOADED_BUFFERS:
@@ -2810,6 +2811,7 @@ int parse_cmd_address(exarg_T *eap, const char **errormsg, bool silent)
         switch (eap->addr_type) {
         case ADDR_LINES:
         case ADDR_OTHER:
+          buf_load_wait(curbuf);
           eap->line1 = 1;
           eap->line2 = curbuf->b_ml.ml_line_count;
           break;
@@ -3389,6 +3391,7 @@ static linenr_T get_address(exarg_T *eap, char **ptr, cmd_addr_T addr_type, bool
       switch (addr_type) {
       case ADDR_LINES:
       case ADDR_OTHER:
+        buf_load_wait(curbuf);
         lnum = curbuf->b_ml.ml_line_count;
         break;
       case ADDR_WINDOWS:
@@ -4215,6 +4218,13 @@ static int getargopt(exarg_T *eap)
     return OK;
   }
 
+  // ":write ++async file"
+  if (strncmp(arg, "async", 5) == 0) {
+    eap->write_async = true;
+    eap->arg = skipwhite(arg + 5);
+    return OK;
+  }
+
   // ":write ++p foo/bar/file
   if (strncmp(arg, "p", 1) == 0) {
     eap->mkdir_p = true;
@@ -4283,6 +4293,7 @@ static char *get_argopt_name(expand_T *xp FUNC_ATTR_UNUSED, int idx)
     "bad=",
     "edit",
     "p",
+    "async",
   };
 
   if (idx < (int)ARRAY_SIZE(p_opt_values)) {
@@ -29,6 +29,7 @@
 #include <stddef.h>
 
 #include "nvim/api/private/defs.h"
+#include "nvim/buffer.h"
 #include "nvim/buffer_defs.h"
 #include "nvim/buffer_updates.h"
 #include "nvim/decoration.h"
@@ -112,6 +113,89 @@ revised:
   }
 }
 
+/// Create or update many extmarks in "ns_id" at once
+///
+/// Each of "marks" is a start key with flags from mt_flags() and the decor flags,
+/// and the end position (row -1 for a mark without end). Marks with id zero are
+/// new: they get an id and are put in the marktree together. Marks with an id
+/// are set like extmark_set() does, afterwards. The id is stored in the key.
+///
+/// @param replace  delete all existing marks in the namespace first
+///
+/// must not be used during iteration!
+void extmark_set_many(buf_T *buf, uint32_t ns_id, MTPair *marks, size_t n, bool replace,
+                      Error *err)
+{
+  bool has_signtext = false;
+  for (size_t i = 0; i < n; i++) {
+    has_signtext |= marks[i].start.flags & MT_FLAG_DECOR_SIGNTEXT;
+  }
+  // Counting the sign columns for every single mark scans the tree each time.
+  // Count them for the whole buffer at the next redraw instead.
+  if (buf->b_signcols.autom
+      && (has_signtext || (replace && buf_meta_total(buf, kMTMetaSignText)))) {
+    buf->b_signcols.autom = false;
+    buf->b_signcols.max = 0;
+    CLEAR_FIELD(buf->b_signcols.count);
+  }
+
+  if (replace && map_has(uint32_t, buf->b_extmark_ns, ns_id)) {
+    MarkTreeIter itr[1] = { 0 };
+    marktree_itr_first(buf->b_marktree, itr);
+    for (; itr->x; marktree_itr_next(buf->b_marktree, itr)) {
+      MTKey mark = marktree_itr_current(itr);
+      if (mark.ns != ns_id || mt_end(mark) || !mt_decor_any(mark)) {
+        continue;
+      }
+      if (mt_invalid(mark)) {
+        decor_free(mt_decor(mark));
+      } else {
+        MTPos end = mt_paired(mark) ? marktree_get_altpos(buf->b_marktree, mark, NULL) : mark.pos;
+        buf_decor_remove(buf, mark.pos.row, end.row, mark.pos.col, mt_decor(mark), true);
+      }
+    }
+    // like extmark_clear() on the whole buffer: ids start over
+    map_del(uint32_t, uint32_t)(buf->b_extmark_ns, ns_id, NULL);
+  }
+
+  // new ids must not clash with the given ones
+  uint32_t *ns = map_put_ref(uint32_t, uint32_t)(buf->b_extmark_ns, ns_id, NULL, NULL);
+  kvec_t(MTPair) new_marks = KV_INITIAL_VALUE;
+  for (size_t i = 0; i < n; i++) {
+    if (marks[i].start.id == 0) {
+      kv_push(new_marks, marks[i]);
+    } else {
+      *ns = MAX(*ns, marks[i].start.id);
+    }
+  }
+  for (size_t i = 0; i < kv_size(new_marks); i++) {
+    kv_A(new_marks, i).start.ns = ns_id;
+    kv_A(new_marks, i).start.id = ++*ns;
+  }
+
+  marktree_put_many(buf->b_marktree, new_marks.items, kv_size(new_marks), replace ? ns_id : 0);
+
+  size_t k = 0;
+  for (size_t i = 0; i < n; i++) {
+    MTKey mark = marks[i].start;
+    int end_row = marks[i].end_pos.row;
+    if (mark.id == 0) {
+      marks[i].start.id = kv_A(new_marks, k++).start.id;
+      if (mark.flags & MT_FLAG_DECOR_MASK) {
+        end_row = end_row > -1 ? end_row : mark.pos.row;
+        buf_put_decor(buf, mt_decor(mark), mark.pos.row, end_row);
+        decor_redraw(buf, mark.pos.row, end_row, mark.pos.col, mt_decor(mark));
+      }
+    } else {
+      extmark_set(buf, ns_id, &marks[i].start.id, mark.pos.row, mark.pos.col, end_row,
+                  marks[i].end_pos.col, mt_decor(mark), mark.flags & MT_FLAG_DECOR_MASK,
+                  mt_right(mark), marks[i].end_right_gravity, mt_no_undo(mark),
+                  mt_invalidate(mark), mt_scoped(mark), err);
+    }
+  }
+  kv_destroy(new_marks);
+}
+
 static void extmark_setraw(buf_T *buf, uint64_t mark, int row, colnr_T col, bool invalid)
 {
   MarkTreeIter itr[1] = { 0 };
@@ -241,6 +325,8 @@ bool extmark_clear(buf_T *buf, uint32_t ns_id, int l_row, colnr_T l_col, int u_r
   return marks_cleared_any;
 }
 
+static const uint32_t lines_filter[kMTMetaCount] = {[kMTMetaLines] = kMTFilterSelect };
+
 /// @return  the position of marks between a range,
 ///          marks found at the start or end index will be included.
 ///
@@ -255,6 +341,10 @@ ExtmarkInfoArray extmark_get(buf_T *buf, uint32_t ns_id, int l_row, colnr_T l_co
   ExtmarkInfoArray array = KV_INITIAL_VALUE;
   MarkTreeIter itr[1];
 
+  // Of the mark types only virt_lines are counted exactly in the marktree meta,
+  // use it to skip subtrees without any such mark.
+  MetaFilter meta_filter = (type_filter == kExtmarkVirtLines && !reverse) ? lines_filter : NULL;
+
   if (overlap) {
     // Find all the marks overlapping the start position
     if (!marktree_itr_get_overlap(buf->b_marktree, l_row, l_col, itr)) {
@@ -265,6 +355,14 @@ ExtmarkInfoArray extmark_get(buf_T *buf, uint32_t ns_id, int l_row, colnr_T l_co
     while (marktree_itr_step_overlap(buf->b_marktree, itr, &pair)) {
       push_mark(&array, ns_id, type_filter, pair);
     }
+    if (meta_filter) {
+      marktree_itr_step_out_filter(buf->b_marktree, itr, meta_filter);
+    }
+  } else if (meta_filter) {
+    if (!marktree_itr_get_filter(buf->b_marktree, l_row, l_col, MAXLNUM, MAXCOL,
+                                 meta_filter, itr)) {
+      return array;
+    }
   } else {
     // Find all the marks beginning with the start position
     marktree_itr_get_ext(buf->b_marktree, MTPos(l_row, l_col),
@@ -288,6 +386,8 @@ ExtmarkInfoArray extmark_get(buf_T *buf, uint32_t ns_id, int l_row, colnr_T l_co
 next_mark:
     if (reverse) {
       marktree_itr_prev(buf->b_marktree, itr);
+    } else if (meta_filter) {
+      marktree_itr_next_filter(buf->b_marktree, itr, MAXLNUM, MAXCOL, meta_filter);
     } else {
       marktree_itr_next(buf->b_marktree, itr);
     }
@@ -16,11 +16,13 @@
 #include <uv.h>
 
 #include "auto/config.h"
+#include "klib/kvec.h"
 #include "nvim/ascii_defs.h"
 #include "nvim/autocmd.h"
 #include "nvim/autocmd_defs.h"
 #include "nvim/buffer.h"
 #include "nvim/buffer_defs.h"
+#include "nvim/bufwrite.h"
 #include "nvim/buffer_updates.h"
 #include "nvim/change.h"
 #include "nvim/cursor.h"
@@ -28,8 +30,14 @@
 #include "nvim/drawscreen.h"
 #include "nvim/edit.h"
 #include "nvim/eval.h"
+#include "nvim/event/defs.h"
+#include "nvim/event/rstream.h"
+#include "nvim/event/stream.h"
+#include "nvim/event/time.h"
 #include "nvim/ex_cmds_defs.h"
 #include "nvim/ex_eval.h"
+#include "nvim/extmark.h"
+#include "nvim/extmark_defs.h"
 #include "nvim/fileio.h"
 #include "nvim/fold.h"
 #include "nvim/garray.h"
@@ -41,6 +49,8 @@
 #include "nvim/highlight_defs.h"
 #include "nvim/iconv_defs.h"
 #include "nvim/log.h"
+#include "nvim/main.h"
+#include "nvim/map_defs.h"
 #include "nvim/macros_defs.h"
 #include "nvim/mbyte.h"
 #include "nvim/mbyte_defs.h"
@@ -62,6 +72,8 @@
 #include "nvim/os/time.h"
 #include "nvim/path.h"
 #include "nvim/pos_defs.h"
+#include "nvim/rbuffer.h"
+#include "nvim/rbuffer_defs.h"
 #include "nvim/regexp.h"
 #include "nvim/regexp_defs.h"
 #include "nvim/sha256.h"
@@ -190,6 +202,7 @@ int readfile(char *fname, char *sfname, linenr_T from, linenr_T lines_to_skip,
   int split = 0;  // number of split lines
   linenr_T linecnt;
   bool error = false;                   // errors encountered
+  bool loading = false;                 // rest is read in the background
   int ff_error = EOL_UNKNOWN;           // file format with errors
   ptrdiff_t linerest = 0;               // remaining chars in line
   int perm = 0;
@@ -213,6 +226,8 @@ int readfile(char *fname, char *sfname, linenr_T from, linenr_T lines_to_skip,
   // BAD_KEEP, BAD_DROP or character to
   // replace with
   char *tmpname = NULL;          // name of 'charconvert' output file
+  kvec_t(char *) new_lines = KV_INITIAL_VALUE;     // lines found in "buffer"
+  kvec_t(colnr_T) new_lens = KV_INITIAL_VALUE;     // their lengths with NUL
   int fio_flags = 0;
   char *fenc;                    // fileencoding to use
   bool fenc_alloced;                    // fenc_next is in allocated memory
@@ -234,6 +249,16 @@ int readfile(char *fname, char *sfname, linenr_T from, linenr_T lines_to_skip,
   int using_b_fname;
   static char *msg_is_a_directory = N_("is a directory");
 
+  // A ":write ++async" of the buffer must be done before the file is read.
+  buf_write_async_wait(curbuf);
+  // Text still being read in the background is not needed when the buffer
+  // is loaded again, it must be complete before inserting another file.
+  if (newfile) {
+    buf_load_stop(curbuf);
+  } else {
+    buf_load_wait(curbuf);
+  }
+
   curbuf->b_au_did_filetype = false;  // reset before triggering any autocommands
 
   curbuf->b_no_eol_lnum = 0;    // in case it was set by the previous read
@@ -1336,6 +1361,15 @@ retry:
           if (todo <= 0) {
             break;
           }
+          // Skip over valid text quickly, only an illegal byte or an
+          // incomplete character needs the checks below.
+          size_t valid = utf_valid_prefix((char *)p, (size_t)todo);
+          if (valid == (size_t)todo) {
+            p += valid;
+            break;
+          }
+          p += valid;
+          todo -= (int)valid;
           if (*p >= 0x80) {
             // A length of 1 means it's an illegal byte.  Accept
             // an incomplete character at the end though, the next
@@ -1475,15 +1509,47 @@ rewind_retry:
       }
     }
 
+    // A large file that doesn't need to be converted: use the text from a
+    // mapping of the file instead of reading it, see 'largefilesize'.
+    if (p_lfs > 0 && filesize == size && linerest == 0
+        && fileformat == EOL_UNIX && !converted && fio_flags == 0
+        && newfile && wasempty && from == 0 && !filtering && !read_undo_file
+        && !read_stdin && !read_buffer && !read_fifo
+        && lines_to_skip == 0 && lines_to_read == MAXLNUM) {
+      bool no_eol = false;
+      off_T mapped_size = 0;
+      linenr_T n = readfile_mapped(curbuf, fd, !curbuf->b_p_bin, !(flags & READ_DUMMY),
+                                   &mapped_size, &no_eol, &loading);
+      if (n > 0) {
+        lnum += n;
+        filesize = mapped_size;
+        if (no_eol) {
+          if (set_options) {
+            curbuf->b_p_eol = false;
+          }
+          if (!loading) {
+            read_no_eol_lnum = lnum;
+          }
+        }
+        break;
+      }
+    }
+
     // This loop is executed once for every character read.
     // Keep it fast!
     if (fileformat == EOL_MAC) {
       ptr--;
       while (++ptr, --size >= 0) {
-        // catch most common case first
-        if ((c = *ptr) != NUL && c != CAR && c != NL) {
-          continue;
+        // catch most common case first: skip to the next special byte
+        char *next = xmemchr3(ptr, (size_t)size + 1, NUL, CAR, NL);
+        if (next == NULL) {
+          ptr += size + 1;
+          size = -1;
+          break;
         }
+        size -= next - ptr;
+        ptr = next;
+        c = *ptr;
         if (c == NUL) {
           *ptr = NL;            // NULs are replaced by newlines!
         } else if (c == NL) {
@@ -1492,10 +1558,8 @@ rewind_retry:
           if (skip_count == 0) {
             *ptr = NUL;                     // end of line
             len = (colnr_T)(ptr - line_start + 1);
-            if (ml_append(lnum, line_start, len, newfile) == FAIL) {
-              error = true;
-              break;
-            }
+            kv_push(new_lines, line_start);
+            kv_push(new_lens, len);
             if (read_undo_file) {
               sha256_update(&sha_ctx, (uint8_t *)line_start, (size_t)len);
             }
@@ -1514,9 +1578,16 @@ rewind_retry:
     } else {
       ptr--;
       while (++ptr, --size >= 0) {
-        if ((c = *ptr) != NUL && c != NL) {        // catch most common case
-          continue;
+        // catch most common case: skip to the next NUL or NL
+        char *next = xmemchr3(ptr, (size_t)size + 1, NUL, NL, NL);
+        if (next == NULL) {
+          ptr += size + 1;
+          size = -1;
+          break;
         }
+        size -= next - ptr;
+        ptr = next;
+        c = *ptr;
         if (c == NUL) {
           *ptr = NL;            // NULs are replaced by newlines!
         } else {
@@ -1542,15 +1613,17 @@ rewind_retry:
                   }
                   file_rewind = true;
                   keep_fileformat = true;
+                  // The lines found so far were not appended yet.
+                  lnum -= (linenr_T)kv_size(new_lines);
+                  kv_size(new_lines) = 0;
+                  kv_size(new_lens) = 0;
                   goto retry;
                 }
                 ff_error = EOL_DOS;
               }
             }
-            if (ml_append(lnum, line_start, len, newfile) == FAIL) {
-              error = true;
-              break;
-            }
+            kv_push(new_lines, line_start);
+            kv_push(new_lens, len);
             if (read_undo_file) {
               sha256_update(&sha_ctx, (uint8_t *)line_start, (size_t)len);
             }
@@ -1567,6 +1640,32 @@ rewind_retry:
         }
       }
     }
+    // Append all lines found in this block of text at once, "buffer" may
+    // be reallocated for the next block.
+    if (kv_size(new_lines) > 0) {
+      linenr_T count = (linenr_T)kv_size(new_lines);
+      if (ml_append_lines(curbuf, lnum - count, new_lines.items, new_lens.items,
+                          count, newfile) == FAIL) {
+        error = true;
+      }
+      kv_size(new_lines) = 0;
+      kv_size(new_lens) = 0;
+    }
+
+    // A large file that doesn't need to be converted: the first lines can
+    // be displayed already, read the rest in the background, see
+    // 'streamfilesize'.
+    if (p_sfs > 0 && !error && lnum > from && conv_restlen == 0
+        && fileformat == EOL_UNIX && !converted && fio_flags == 0
+        && newfile && wasempty && from == 0 && !filtering && !read_undo_file
+        && !read_stdin && !read_buffer && !read_fifo && !(flags & READ_DUMMY)
+        && lines_to_skip == 0 && lines_to_read == MAXLNUM
+        && readfile_stream(curbuf, fd, line_start, (size_t)(ptr - line_start),
+                           illegal_byte, bad_char_behavior)) {
+      loading = true;
+      linerest = 0;
+      break;
+    }
     linerest = (ptr - line_start);
     os_breakcheck();
   }
@@ -1635,6 +1734,8 @@ failed:
     os_set_cloexec(fd);
   }
   xfree(buffer);
+  kv_destroy(new_lines);
+  kv_destroy(new_lens);
 
   if (read_stdin) {
     close(fd);
@@ -1726,6 +1827,10 @@ failed:
         xstrlcat(IObuff, _("[noeol]"), IOSIZE);
         c = true;
       }
+      if (loading) {
+        xstrlcat(IObuff, _("[loading]"), IOSIZE);
+        c = true;
+      }
       if (ff_error == EOL_DOS) {
         xstrlcat(IObuff, _("[CR missing]"), IOSIZE);
         c = true;
@@ -1921,6 +2026,463 @@ static linenr_T readfile_linenr(linenr_T linecnt, char *p, const char *endp)
   return lnum;
 }
 
+/// Size of the ring buffer used to read a file in the background.
+#define FILE_LOAD_BUFSIZE (1024 * 1024)
+/// Number of bytes of a mapped file in which lines are found at a time.
+#define FILE_LOAD_MAPSIZE (8 * FILE_LOAD_BUFSIZE)
+
+/// State of a file that is read in the background, see 'streamfilesize'.
+/// Also used to find the lines of a mapped file, see 'largefilesize'.
+struct file_load {
+  Stream stream;
+  TimeWatcher timer;          ///< mapped: finds more lines every tick
+  bool mapped;                ///< lines are found in a mapping, not read
+  bool no_eol;                ///< mapped: the last line has no end-of-line
+  int fnum;                   ///< number of the buffer being loaded
+  int fd;                     ///< dup of the file descriptor, closed when done
+  StringBuilder text;         ///< text read, not appended to the buffer yet
+  uint64_t size;              ///< size of the file when loading started
+  uint64_t done;              ///< number of bytes read so far
+  linenr_T illegal_byte;      ///< line nr with illegal byte
+  int bad_char_behavior;      ///< see "++bad"
+  bool check_utf8;            ///< the text must be valid UTF-8
+  bool closed;                ///< not reading anymore, ignore read events
+};
+
+/// Use the text of file "fd" for the empty buffer "buf" without reading it,
+/// when the file is at least 'largefilesize' Kbyte.  Lines are built from a
+/// read-only mapping of the file only when they are used, see
+/// ml_append_mapped().  When "background" is true only the lines at the start
+/// are found now, the rest is found from the event loop.
+///
+/// @param check_utf8    the text must be valid UTF-8
+/// @param[out] sizep    number of bytes used
+/// @param[out] no_eol   set when the last line has no end-of-line
+/// @param[out] loading  set when lines are added in the background
+///
+/// @return  number of lines appended, 0 when the file must be read normally.
+static linenr_T readfile_mapped(buf_T *buf, int fd, bool check_utf8, bool background,
+                                off_T *sizep, bool *no_eol, bool *loading)
+{
+  FileInfo file_info;
+  if (!os_fileinfo_fd(fd, &file_info)
+      || !S_ISREG(file_info.stat.st_mode)) {
+    return 0;
+  }
+  uint64_t size = os_fileinfo_size(&file_info);
+  if (size < (uint64_t)p_lfs * 1024 || size != (size_t)size) {
+    return 0;
+  }
+
+  const char *map = os_mmap_readonly(fd, (size_t)size);
+  if (map == NULL) {
+    return 0;
+  }
+  int map_fd = os_dup(fd);
+  if (map_fd < 0) {
+    goto fail;
+  }
+  os_set_cloexec(map_fd);
+  size_t done = 0;
+  linenr_T n = ml_append_mapped(buf, map, (size_t)size, map_fd,
+                                background ? FILE_LOAD_BUFSIZE : (size_t)size, check_utf8,
+                                &done);
+  if (n == 0) {
+    goto fail;
+  }
+  *sizep = (off_T)done;
+  *no_eol = map[size - 1] != NL;
+
+  if (done < size) {
+    struct file_load *fl = xcalloc(1, sizeof(*fl));
+    fl->fnum = buf->b_fnum;
+    fl->fd = -1;
+    fl->size = size;
+    fl->done = done;
+    fl->bad_char_behavior = BAD_KEEP;
+    fl->check_utf8 = check_utf8;
+    fl->mapped = true;
+    fl->no_eol = *no_eol;
+    time_watcher_init(&main_loop, &fl->timer, fl);
+    fl->timer.events = main_loop.events;
+    fl->timer.blockable = true;
+    time_watcher_start(&fl->timer, file_load_timer_cb, 0, 1);
+    buf->b_file_load = fl;
+    *loading = true;
+  }
+  return n;
+
+fail:
+  if (map_fd >= 0) {
+    close(map_fd);
+  }
+  os_munmap(map, (size_t)size);
+  return 0;
+}
+
+/// Read the rest of file "fd" into the empty buffer "buf" from the event loop,
+/// when the file is at least 'streamfilesize' Kbyte.  The lines found so far
+/// have already been appended, "rest[restlen]" is the incomplete line after
+/// them.
+///
+/// @param illegal_byte  line nr with illegal byte found so far
+///
+/// @return  true when the rest of the file is read in the background.
+static bool readfile_stream(buf_T *buf, int fd, const char *rest, size_t restlen,
+                            linenr_T illegal_byte, int bad_char_behavior)
+{
+  FileInfo file_info;
+  if (!os_fileinfo_fd(fd, &file_info)
+      || !S_ISREG(file_info.stat.st_mode)) {
+    return false;
+  }
+  uint64_t size = os_fileinfo_size(&file_info);
+  off_T offset = vim_lseek(fd, 0, SEEK_CUR);
+  if (size < (uint64_t)p_sfs * 1024 || offset < 0 || (uint64_t)offset >= size
+      || (uint64_t)offset != (size_t)offset) {
+    return false;
+  }
+
+  int load_fd = os_dup(fd);
+  if (load_fd < 0) {
+    return false;
+  }
+  os_set_cloexec(load_fd);
+
+  struct file_load *fl = xcalloc(1, sizeof(*fl));
+  fl->fnum = buf->b_fnum;
+  fl->fd = load_fd;
+  fl->size = size;
+  fl->done = (uint64_t)offset;
+  fl->illegal_byte = illegal_byte;
+  fl->bad_char_behavior = bad_char_behavior;
+  fl->check_utf8 = !buf->b_p_bin;
+  kv_concat_len(fl->text, rest, restlen);
+
+  rstream_init_fd(&main_loop, &fl->stream, load_fd, FILE_LOAD_BUFSIZE);
+  fl->stream.fpos = (size_t)offset;
+  fl->stream.events = main_loop.events;
+  rstream_start(&fl->stream, file_load_read_cb, fl);
+  buf->b_file_load = fl;
+  return true;
+}
+
+/// Called from the event loop with more text of a file read in the background.
+static void file_load_read_cb(Stream *stream, RBuffer *rbuf, size_t count, void *data, bool eof)
+{
+  struct file_load *fl = data;
+  if (fl->closed) {
+    return;  // event was queued before loading was stopped
+  }
+  buf_T *buf = buflist_findnr(fl->fnum);
+  assert(buf != NULL && buf->b_file_load == fl);
+
+  RBUFFER_UNTIL_EMPTY(rbuf, ptr, cnt) {
+    kv_concat_len(fl->text, ptr, cnt);
+    fl->done += cnt;
+    rbuffer_consumed(rbuf, cnt);
+  }
+  file_load_append(fl, buf, eof);
+  if (eof) {
+    file_load_finish(fl, buf);
+  }
+}
+
+/// Append the complete lines in the text read to the buffer, and the
+/// incomplete last line when at the end of the file.
+static void file_load_append(struct file_load *fl, buf_T *buf, bool eof)
+{
+  bool no_eol = false;
+  if (eof && kv_size(fl->text) > 0 && kv_last(fl->text) != NL) {
+    kv_push(fl->text, NL);
+    no_eol = true;
+  }
+
+  char *text = fl->text.items;
+  size_t len = kv_size(fl->text);
+  size_t textlen = len;
+  while (textlen > 0 && text[textlen - 1] != NL) {
+    textlen--;
+  }
+  if (textlen == 0) {
+    return;
+  }
+
+  linenr_T before = buf->b_ml.ml_line_count;
+
+  if (fl->check_utf8) {
+    // Like readfile() handles an illegal byte when it can't retry with
+    // another encoding.
+    size_t off = 0;
+    while ((off += utf_valid_prefix(text + off, textlen - off)) < textlen) {
+      if (fl->illegal_byte == 0) {
+        fl->illegal_byte = before + 1;
+        for (size_t i = 0; i < off; i++) {
+          if (text[i] == NL) {
+            fl->illegal_byte++;
+          }
+        }
+      }
+      if (fl->bad_char_behavior == BAD_DROP) {
+        memmove(text + off, text + off + 1, len - off - 1);
+        len--;
+        textlen--;
+        kv_size(fl->text) = len;
+      } else {
+        if (fl->bad_char_behavior != BAD_KEEP) {
+          text[off] = (char)fl->bad_char_behavior;
+        }
+        off++;
+      }
+    }
+  }
+
+  kvec_t(char *) lines = KV_INITIAL_VALUE;
+  kvec_t(colnr_T) lens = KV_INITIAL_VALUE;
+  char *line_start = text;
+  char *end = text + textlen;
+  for (char *p = text; p < end; p++) {
+    p = xmemchr3(p, (size_t)(end - p), NUL, NL, NL);
+    if (*p == NUL) {
+      *p = NL;            // NULs are replaced by newlines!
+      continue;
+    }
+    *p = NUL;             // end of line
+    kv_push(lines, line_start);
+    kv_push(lens, (colnr_T)(p - line_start + 1));
+    line_start = p + 1;
+  }
+
+  linenr_T count = (linenr_T)kv_size(lines);
+  if (ml_append_lines(buf, before, lines.items, lens.items, count, true) == OK) {
+    if (no_eol) {
+      // Like readfile() does, also for 'binary'.  The file still matches
+      // the buffer, file_ff_differs() must not see a change.
+      buf->b_p_eol = false;
+      buf->b_start_eol = false;
+      buf->b_no_eol_lnum = before + count;
+    }
+    file_load_appended(buf, before, count, (bcount_t)textlen);
+  }
+  kv_destroy(lines);
+  kv_destroy(lens);
+
+  // Keep the incomplete last line for the next read.
+  memmove(text, text + textlen, len - textlen);
+  kv_size(fl->text) = len - textlen;
+  redraw_buf_status_later(buf);
+}
+
+/// Update what depends on the text after "count" lines with "bytes" bytes of
+/// the file were appended after line "before".
+static void file_load_appended(buf_T *buf, linenr_T before, linenr_T count, bcount_t bytes)
+{
+  // The lines are part of the file, don't use changed_lines(), that would
+  // set 'modified'.
+  buf_inc_changedtick(buf);
+  extmark_splice(buf, before, 0, 0, 0, 0, count, 0, bytes, kExtmarkNoUndo);
+  buf_updates_send_changes(buf, before + 1, count, 0);
+
+  changed_lines_redraw_buf(buf, before + 1, before + 1, count);
+  changed_lines_invalidate_buf(buf, before + 1, 0, before + 1, count);
+  FOR_ALL_TAB_WINDOWS(tp, wp) {
+    if (wp->w_buffer == buf) {
+      invalidate_botline(wp);
+    }
+  }
+  redraw_buf_later(buf, UPD_VALID);
+}
+
+/// Called from the event loop to find more lines of a mapped file.
+static void file_load_timer_cb(TimeWatcher *watcher, void *data)
+{
+  struct file_load *fl = data;
+  if (fl->closed) {
+    return;  // event was queued before loading was stopped
+  }
+  buf_T *buf = buflist_findnr(fl->fnum);
+  assert(buf != NULL && buf->b_file_load == fl);
+  file_load_mapped(fl, buf);
+}
+
+/// Append the lines of the next part of a mapped file to the buffer.  When
+/// the end of the file is reached loading is finished.
+static void file_load_mapped(struct file_load *fl, buf_T *buf)
+{
+  size_t off = (size_t)fl->done;
+  linenr_T before = buf->b_ml.ml_line_count;
+  linenr_T count = ml_append_mapped_more(buf, &off, FILE_LOAD_MAPSIZE, fl->check_utf8,
+                                         &fl->illegal_byte);
+  if (count < 0) {
+    // Only happens for a line that is too long, the mapping may also have
+    // been dropped.
+    filemess(buf, buf->b_fname, _("[long line, not read completely]"), 0);
+    buf->b_p_ro = true;  // must use "w!" now
+    file_load_close(fl, buf);
+    return;
+  }
+
+  bool eof = off >= fl->size;
+  bcount_t bytes = (bcount_t)(off - fl->done) + (eof && fl->no_eol ? 1 : 0);
+  fl->done = off;
+  if (count > 0) {
+    file_load_appended(buf, before, count, bytes);
+  }
+  redraw_buf_status_later(buf);
+  if (eof) {
+    if (fl->no_eol) {
+      buf->b_no_eol_lnum = buf->b_ml.ml_line_count;
+    }
+    file_load_finish(fl, buf);
+  }
+}
+
+/// Done reading a file in the background: give the file message and close it.
+static void file_load_finish(struct file_load *fl, buf_T *buf)
+{
+  if (fl->illegal_byte > 0 && fl->bad_char_behavior != BAD_KEEP) {
+    buf->b_p_ro = true;  // with errors writing the file requires ":w!"
+  }
+
+  if (buf == curbuf && !shortmess(SHM_FILEINFO) && !(State & MODE_CMDLINE)) {
+    add_quoted_fname(IObuff, IOSIZE, buf, buf->b_fname);
+    bool c = false;
+    if (buf->b_p_ro) {
+      xstrlcat(IObuff, shortmess(SHM_RO) ? _("[RO]") : _("[readonly]"), IOSIZE);
+      c = true;
+    }
+    if (buf->b_no_eol_lnum) {
+      xstrlcat(IObuff, _("[noeol]"), IOSIZE);
+      c = true;
+    }
+    if (fl->illegal_byte > 0) {
+      snprintf(IObuff + strlen(IObuff), IOSIZE - strlen(IObuff),
+               _("[ILLEGAL BYTE in line %" PRId64 "]"), (int64_t)fl->illegal_byte);
+      c = true;
+    }
+    msg_add_lines(c, buf->b_ml.ml_line_count, (off_T)fl->done);
+    msg_scrolled_ign = true;
+    msg_trunc(IObuff, false, 0);
+    msg_scrolled_ign = false;
+  }
+
+  file_load_close(fl, buf);
+}
+
+/// Stop reading in the background and free "fl" when the stream is closed.
+static void file_load_close(struct file_load *fl, buf_T *buf)
+{
+  buf->b_file_load = NULL;
+  redraw_buf_status_later(buf);
+  fl->closed = true;
+  if (fl->mapped) {
+    time_watcher_stop(&fl->timer);
+    time_watcher_close(&fl->timer, file_load_timer_close_cb);
+    return;
+  }
+  rstream_stop(&fl->stream);
+  close(fl->fd);
+  stream_close(&fl->stream, file_load_close_cb, fl);
+}
+
+static void file_load_close_cb(Stream *stream, void *data)
+{
+  struct file_load *fl = data;
+  kv_destroy(fl->text);
+  xfree(fl);
+}
+
+static void file_load_timer_close_cb(TimeWatcher *watcher, void *data)
+{
+  xfree(data);
+}
+
+/// Wait until the file of buffer "buf" has been read completely, when it is
+/// being read in the background.  See 'streamfilesize'.
+void buf_load_wait(buf_T *buf)
+  FUNC_ATTR_NONNULL_ALL
+{
+  struct file_load *fl = buf->b_file_load;
+  if (fl == NULL) {
+    return;
+  }
+
+  if (fl->mapped) {
+    while (buf->b_file_load == fl && !got_int) {
+      file_load_mapped(fl, buf);
+      os_breakcheck();
+    }
+    if (buf->b_file_load == fl) {
+      // Interrupted: keep the lines found, like readfile() does.
+      filemess(buf, buf->b_fname, _(e_interr), 0);
+      buf->b_p_ro = true;  // must use "w!" now
+      file_load_close(fl, buf);
+    }
+    return;
+  }
+
+  // Use what was read already, then read the rest directly.
+  rstream_stop(&fl->stream);
+  RBUFFER_UNTIL_EMPTY(fl->stream.buffer, ptr, cnt) {
+    kv_concat_len(fl->text, ptr, cnt);
+    fl->done += cnt;
+    rbuffer_consumed(fl->stream.buffer, cnt);
+  }
+  // Consuming restarted the stream, no more reads are wanted.
+  rstream_stop(&fl->stream);
+
+  bool eof = vim_lseek(fl->fd, (off_T)fl->stream.fpos, SEEK_SET) < 0;
+  while (!eof && !got_int) {
+    size_t n = kv_size(fl->text);
+    kv_ensure_space(fl->text, FILE_LOAD_BUFSIZE);
+    int nread = read_eintr(fl->fd, fl->text.items + n, FILE_LOAD_BUFSIZE);
+    if (nread > 0) {
+      kv_size(fl->text) = n + (size_t)nread;
+      fl->done += (uint64_t)nread;
+    } else {
+      eof = true;
+    }
+    file_load_append(fl, buf, eof);
+    os_breakcheck();
+  }
+
+  if (eof) {
+    file_load_finish(fl, buf);
+  } else {
+    // Interrupted: keep what was read, like readfile() does.
+    filemess(buf, buf->b_fname, _(e_interr), 0);
+    buf->b_p_ro = true;  // must use "w!" now
+    file_load_close(fl, buf);
+  }
+}
+
+/// Stop reading the file of buffer "buf" in the background, the text read so
+/// far is kept.  When "buf" is NULL do this for all buffers.
+void buf_load_stop(buf_T *buf)
+{
+  if (buf == NULL) {
+    FOR_ALL_BUFFERS(bp) {
+      buf_load_stop(bp);
+    }
+    return;
+  }
+  if (buf->b_file_load != NULL) {
+    file_load_close(buf->b_file_load, buf);
+  }
+}
+
+/// @return  percentage of the file of buffer "buf" that has been read, or -1
+///          when it is not being read in the background.
+int buf_load_percent(const buf_T *buf)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_PURE
+{
+  const struct file_load *fl = buf->b_file_load;
+  if (fl == NULL) {
+    return -1;
+  }
+  return fl->done >= fl->size ? 99 : (int)(fl->done * 100 / fl->size);
+}
+
 /// Fill "*eap" to force the 'fileencoding', 'fileformat' and 'binary' to be
 /// equal to the buffer "buf".  Used for calling readfile().
 void prep_exarg(exarg_T *eap, const buf_T *buf)
@@ -2793,9 +3355,15 @@ int check_timestamps(int focus)
     no_wait_return++;
     did_check_timestamps = true;
     already_warned = false;
+    // Handle pending events of the directory watchers, a shell command may
+    // have just changed a file.
+    if (map_size(&dir_watchers) > 0) {
+      loop_poll_events(&main_loop, 0);
+    }
     FOR_ALL_BUFFERS(buf) {
-      // Only check buffers in a window.
-      if (buf->b_nwindows > 0) {
+      // Only check buffers in a window.  Don't check a file when nothing
+      // changed in its directory.
+      if (buf->b_nwindows > 0 && buf_file_may_have_changed(buf)) {
         bufref_T bufref;
         set_bufref(&bufref, buf);
         const int n = buf_check_timestamp(buf);
@@ -2898,6 +3466,12 @@ int buf_check_timestamp(buf_T *buf)
     return 0;
   }
 
+  // Changes in the directory up to now are seen.
+  if (buf->b_dir_watcher != NULL) {
+    buf->b_dir_changes = buf->b_dir_watcher->changes;
+  }
+  g_stats.timestamp_checks++;
+
   FileInfo file_info;
   bool file_info_ok;
   if (!(buf->b_flags & BF_NOTEDITED)
@@ -3231,6 +3805,144 @@ void buf_store_file_info(buf_T *buf, FileInfo *file_info)
   buf->b_mtime_ns = file_info->stat.st_mtim.tv_nsec;
   buf->b_orig_size = os_fileinfo_size(file_info);
   buf->b_orig_mode = (int)file_info->stat.st_mode;
+  buf_watch_file(buf, file_info);
+}
+
+/// Watcher for a directory with files that are edited, so that
+/// check_timestamps() only needs to check the files in directories where
+/// something changed.  Shared by all buffers with a file in the directory.
+struct dir_watcher {
+  uv_fs_event_t uv;
+  char *dir;                  ///< key in "dir_watchers"
+  int refcount;               ///< number of buffers using the watcher
+  uint64_t changes;           ///< incremented for every event
+  bool failed;                ///< events may be missed, always check
+  bool remote;                ///< not watched, on a network filesystem
+};
+
+/// Directory name -> struct dir_watcher.
+static PMap(cstr_t) dir_watchers = MAP_INIT;
+
+/// Start watching the directory of the file of "buf", which was just checked
+/// and has "file_info".
+///
+/// Only done on Linux, where inotify delivers the events for a change before
+/// the call that made the change returns.  Elsewhere events can arrive late
+/// and check_timestamps() would miss the change.
+static void buf_watch_file(buf_T *buf, const FileInfo *file_info)
+{
+#ifdef __linux__
+  if (buf->b_ffname == NULL || !path_is_absolute(buf->b_ffname)) {
+    buf_unwatch_file(buf);
+    return;
+  }
+  char *tail = path_tail(buf->b_ffname);
+  char *dir = xmemdupz(buf->b_ffname, (size_t)(tail - buf->b_ffname));
+  if (tail - buf->b_ffname > 1) {
+    dir[tail - buf->b_ffname - 1] = NUL;  // remove trailing slash
+  }
+
+  if (buf->b_dir_watcher != NULL && strcmp(buf->b_dir_watcher->dir, dir) == 0) {
+    buf->b_dir_changes = buf->b_dir_watcher->changes;
+    xfree(dir);
+    return;
+  }
+  buf_unwatch_file(buf);
+
+  // A file that is a symbolic link or has several names can be changed
+  // without an event for this directory.
+  FileInfo link_info;
+  if (os_fileinfo_hardlinks(file_info) > 1
+      || !os_fileinfo_link(buf->b_ffname, &link_info)
+      || S_ISLNK(link_info.stat.st_mode)) {
+    xfree(dir);
+    return;
+  }
+
+  struct dir_watcher *w = pmap_get(cstr_t)(&dir_watchers, dir);
+  if (w == NULL) {
+    w = xcalloc(1, sizeof(*w));
+    w->dir = dir;
+    if (os_path_is_remote(dir)) {
+      // Changes made on another machine cause no events: the files are
+      // always checked (polled).  Remembered to avoid a statfs() per check.
+      w->remote = true;
+      w->failed = true;
+    } else {
+      uv_fs_event_init(&main_loop.uv, &w->uv);
+      w->uv.data = w;
+      if (uv_fs_event_start(&w->uv, dir_watcher_cb, dir, 0) != 0) {
+        // Can't watch this directory (e.g., no inotify watches left): the
+        // file is always checked.
+        uv_close((uv_handle_t *)&w->uv, dir_watcher_close_cb);
+        return;
+      }
+    }
+    pmap_put(cstr_t)(&dir_watchers, w->dir, w);
+  } else {
+    xfree(dir);
+  }
+  w->refcount++;
+  buf->b_dir_watcher = w;
+  buf->b_dir_changes = w->changes;
+#endif
+}
+
+/// Stop watching the directory of the file of "buf".
+void buf_unwatch_file(buf_T *buf)
+  FUNC_ATTR_NONNULL_ALL
+{
+  struct dir_watcher *w = buf->b_dir_watcher;
+  if (w == NULL) {
+    return;
+  }
+  buf->b_dir_watcher = NULL;
+  if (--w->refcount == 0) {
+    pmap_del(cstr_t)(&dir_watchers, w->dir, NULL);
+    if (w->remote) {
+      xfree(w->dir);
+      xfree(w);
+    } else {
+      uv_close((uv_handle_t *)&w->uv, dir_watcher_close_cb);
+    }
+  }
+}
+
+/// Stop watching directories of all buffers, before exiting.
+void buf_unwatch_all(void)
+{
+  FOR_ALL_BUFFERS(buf) {
+    buf_unwatch_file(buf);
+  }
+}
+
+#ifdef __linux__
+static void dir_watcher_cb(uv_fs_event_t *handle, const char *filename, int events, int status)
+{
+  struct dir_watcher *w = handle->data;
+  w->changes++;
+  // When the directory itself was moved or deleted the files can't be
+  // watched anymore.
+  if (status < 0 || filename == NULL || strcmp(filename, path_tail(w->dir)) == 0) {
+    w->failed = true;
+  }
+}
+#endif
+
+static void dir_watcher_close_cb(uv_handle_t *handle)
+{
+  struct dir_watcher *w = handle->data;
+  xfree(w->dir);
+  xfree(w);
+}
+
+/// @return  false when the file of "buf" can't have changed since it was
+///          last checked, according to its directory watcher.
+static bool buf_file_may_have_changed(const buf_T *buf)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_PURE
+{
+  const struct dir_watcher *w = buf->b_dir_watcher;
+  return w == NULL || w->failed || w->changes != buf->b_dir_changes;
 }
 
 /// Adjust the line with missing eol, used for the next write.
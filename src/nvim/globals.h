@@ -85,7 +85,29 @@ EXTERN struct nvim_stats_s {
   int64_t fsync;
   int64_t redraw;
   int16_t log_skip;  // How many logs were tried and skipped before log_init.
-} g_stats INIT( = { 0, 0, 0 });
+  int64_t ml_cache_hit;   // ml_find_line() found a remembered data block
+  int64_t ml_cache_miss;  // ml_find_line() walked the tree of blocks
+  int64_t swap_sync;      // number of mf_sync() calls that wrote to a swap file
+  int64_t swap_sync_us;   // time the main thread spent in them, microseconds
+  int64_t swap_sync_max_us;  // longest time spent in one of them
+  int64_t mf_compress_bytes;  // size of memfile blocks before compressing
+  int64_t mf_compress_size;   // size of the same blocks after compressing
+  int64_t mf_decompress;      // number of blocks decompressed
+  int64_t mf_decompress_ns;   // time spent decompressing, nanoseconds
+  int64_t decor_cache_hit;    // decorations of a line reused from an earlier redraw
+  int64_t decor_cache_miss;   // decorations of a line found in the marktree
+  int64_t stream_writes;      // write requests (writev calls) on streams
+  int64_t stream_write_bufs;  // buffers written by them
+  int64_t stream_write_bytes;  // bytes written by them
+  int64_t redraw_frames;        // update_screen() calls which redrew the screen
+  int64_t redraw_postponed;     // redraws delayed by 'redrawrate'
+  int64_t redraw_win_update_ns;  // time spent in win_update(), nanoseconds
+  int64_t redraw_lines;         // screen lines sent to UIs
+  int64_t ui_bytes;             // bytes of UI events sent to remote UIs
+  int64_t plines_cache_hit;     // height of a line found in w_plines_cache[]
+  int64_t plines_cache_miss;    // height of a line computed from its text
+  int64_t timestamp_checks;     // files checked by buf_check_timestamp()
+} g_stats INIT( = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 });
 
 // Values for "starting".
 #define NO_SCREEN       2       // no screen updating yet
@@ -17,6 +17,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+
 #include "nvim/api/private/defs.h"
 #include "nvim/arabic.h"
 #include "nvim/ascii_defs.h"
@@ -36,6 +40,10 @@
 #include "nvim/ui.h"
 #include "nvim/ui_defs.h"
 
+#ifdef HAVE_AVX2_DISPATCH
+# include <immintrin.h>
+#endif
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "grid.c.generated.h"
 #endif
@@ -619,6 +627,137 @@ static int grid_char_needs_redraw(ScreenGrid *grid, int col, size_t off_to, int
               || rdb_flags & RDB_NODELTA));
 }
 
+#ifdef __SSE2__
+/// Compares 8 cells of "chars1"/"attrs1" and "chars2"/"attrs2".
+///
+/// @return  4 bits for each cell, set if the cell is equal.
+static inline uint32_t cells_equal_sse2(const schar_T *chars1, const sattr_T *attrs1,
+                                        const schar_T *chars2, const sattr_T *attrs2)
+{
+  uint32_t mask = 0;
+  for (int i = 0; i < 8; i += 4) {
+    __m128i eq = _mm_and_si128(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(chars1 + i)),
+                                               _mm_loadu_si128((const __m128i *)(chars2 + i))),
+                               _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(attrs1 + i)),
+                                               _mm_loadu_si128((const __m128i *)(attrs2 + i))));
+    mask |= (uint32_t)_mm_movemask_epi8(eq) << (4 * i);
+  }
+  return mask;
+}
+#endif
+
+#ifdef HAVE_AVX2_DISPATCH
+/// Part of cells_diff_start() for CPUs with AVX2: compare blocks of 16 cells.
+///
+/// @return  index of the first differing cell, or of the first cell not checked.
+AVX2_TARGET static int cells_diff_start_avx2(const schar_T *chars1, const sattr_T *attrs1,
+                                             const schar_T *chars2, const sattr_T *attrs2, int n)
+{
+  int i = 0;
+  for (; i + 16 <= n; i += 16) {
+    uint64_t mask = 0;
+    for (int j = 0; j < 16; j += 8) {
+      __m256i eq = _mm256_and_si256(
+        _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(chars1 + i + j)),
+                           _mm256_loadu_si256((const __m256i *)(chars2 + i + j))),
+        _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(attrs1 + i + j)),
+                           _mm256_loadu_si256((const __m256i *)(attrs2 + i + j))));
+      mask |= (uint64_t)(uint32_t)_mm256_movemask_epi8(eq) << (4 * j);
+    }
+    if (mask != UINT64_MAX) {
+      return i + __builtin_ctzll(~mask) / 4;
+    }
+  }
+  return i;
+}
+
+/// Part of cells_diff_end() for CPUs with AVX2: compare blocks of 16 cells,
+/// starting at the end.
+///
+/// @return  index after the last differing cell, or after the last cell not
+///          checked.
+AVX2_TARGET static int cells_diff_end_avx2(const schar_T *chars1, const sattr_T *attrs1,
+                                           const schar_T *chars2, const sattr_T *attrs2, int n)
+{
+  int i = n;
+  for (; i >= 16; i -= 16) {
+    uint64_t mask = 0;
+    for (int j = 0; j < 16; j += 8) {
+      int k = i - 16 + j;
+      __m256i eq = _mm256_and_si256(
+        _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(chars1 + k)),
+                           _mm256_loadu_si256((const __m256i *)(chars2 + k))),
+        _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(attrs1 + k)),
+                           _mm256_loadu_si256((const __m256i *)(attrs2 + k))));
+      mask |= (uint64_t)(uint32_t)_mm256_movemask_epi8(eq) << (4 * j);
+    }
+    if (mask != UINT64_MAX) {
+      return i - 16 + (63 - __builtin_clzll(~mask)) / 4 + 1;
+    }
+  }
+  return i;
+}
+#endif
+
+/// Finds the first of "n" cells where "chars1"/"attrs1" and
+/// "chars2"/"attrs2" differ.  Compares 8 cells at a time with SSE2 and 16
+/// with AVX2.
+///
+/// @return  index of the cell, "n" when all cells are equal.
+static int cells_diff_start(const schar_T *chars1, const sattr_T *attrs1, const schar_T *chars2,
+                            const sattr_T *attrs2, int n)
+{
+  int i = 0;
+#ifdef HAVE_AVX2_DISPATCH
+  if (n >= 16 && __builtin_cpu_supports("avx2")) {
+    i = cells_diff_start_avx2(chars1, attrs1, chars2, attrs2, n);
+  }
+#endif
+#ifdef __SSE2__
+  for (; i + 8 <= n; i += 8) {
+    uint32_t mask = cells_equal_sse2(chars1 + i, attrs1 + i, chars2 + i, attrs2 + i);
+    if (mask != UINT32_MAX) {
+      return i + __builtin_ctz(~mask) / 4;
+    }
+  }
+#endif
+  for (; i < n; i++) {
+    if (chars1[i] != chars2[i] || attrs1[i] != attrs2[i]) {
+      return i;
+    }
+  }
+  return n;
+}
+
+/// Like cells_diff_start(), but finds the last differing cell.
+///
+/// @return  index after the cell, 0 when all cells are equal.
+static int cells_diff_end(const schar_T *chars1, const sattr_T *attrs1, const schar_T *chars2,
+                          const sattr_T *attrs2, int n)
+{
+  int i = n;
+#ifdef HAVE_AVX2_DISPATCH
+  if (n >= 16 && __builtin_cpu_supports("avx2")) {
+    i = cells_diff_end_avx2(chars1, attrs1, chars2, attrs2, n);
+  }
+#endif
+#ifdef __SSE2__
+  for (; i >= 8; i -= 8) {
+    uint32_t mask = cells_equal_sse2(chars1 + i - 8, attrs1 + i - 8, chars2 + i - 8,
+                                     attrs2 + i - 8);
+    if (mask != UINT32_MAX) {
+      return i - 8 + (31 - __builtin_clz(~mask)) / 4 + 1;
+    }
+  }
+#endif
+  for (; i > 0; i--) {
+    if (chars1[i - 1] != chars2[i - 1] || attrs1[i - 1] != attrs2[i - 1]) {
+      return i;
+    }
+  }
+  return 0;
+}
+
 /// Move one buffered line to the window grid, but only the characters that
 /// have actually changed.  Handle insert/delete character.
 ///
@@ -682,12 +821,38 @@ void grid_put_linebuf(ScreenGrid *grid, int row, int coloff, int col, int endcol
     }
   }
 
-  redraw_next = grid_char_needs_redraw(grid, col, off_to + (size_t)col, endcol - col);
-
   int start_dirty = -1;
   int end_dirty = 0;
 
-  while (col < endcol) {
+  if (endcol > col) {
+    memcpy(grid->vcols + off_to + (size_t)col, linebuf_vcol + col,
+           (size_t)(endcol - col) * sizeof(*grid->vcols));
+  }
+
+  // Only the cells from the first to the last changed one need to be looked
+  // at one by one.
+  int diff_end = endcol;
+  if (endcol > col && !exmode_active && !(rdb_flags & RDB_NODELTA)) {
+    size_t off = off_to + (size_t)col;
+    int n = endcol - col;
+    int first = cells_diff_start(linebuf_char + col, linebuf_attr + col,
+                                 grid->chars + off, grid->attrs + off, n);
+    if (first == n) {
+      diff_end = col;
+    } else {
+      diff_end = col + cells_diff_end(linebuf_char + col, linebuf_attr + col,
+                                      grid->chars + off, grid->attrs + off, n);
+      // Start at the left half of a changed doublewidth char.
+      if (first > 0 && linebuf_char[col + first] == 0) {
+        first--;
+      }
+      col += first;
+    }
+  }
+
+  redraw_next = grid_char_needs_redraw(grid, col, off_to + (size_t)col, endcol - col);
+
+  while (col < diff_end) {
     int char_cells = 1;  // 1: normal char
                          // 2: occupies two display cells
     if (col + 1 < endcol && linebuf_char[col + 1] == 0) {
@@ -727,13 +892,9 @@ void grid_put_linebuf(ScreenGrid *grid, int row, int coloff, int col, int endcol
       }
     }
 
-    grid->vcols[off] = linebuf_vcol[col];
-    if (char_cells == 2) {
-      grid->vcols[off + 1] = linebuf_vcol[col + 1];
-    }
-
     col += char_cells;
   }
+  col = endcol;
 
   if (clear_next) {
     // Clear the second half of a double-wide character of which the left
@@ -44,6 +44,20 @@ static Map(int, int) blend_attr_entries = MAP_INIT;
 static Map(int, int) blendthrough_attr_entries = MAP_INIT;
 static Set(cstr_t) urls = SET_INIT;
 
+/// Recent results of hl_blend_attrs(). Neighbouring cells mostly have the
+/// same attributes, this avoids looking up the attributes and the maps above
+/// for every cell.
+typedef struct {
+  int back_attr;
+  int front_attr;
+  bool through;      ///< "*through" when called
+  bool through_out;  ///< "*through" when returning
+  int id;            ///< result, 0 for an unused entry
+} BlendCacheEntry;
+
+#define BLEND_CACHE_SIZE 64
+static BlendCacheEntry blend_cache[BLEND_CACHE_SIZE];
+
 #define attr_entry(i) attr_entries.keys[i]
 
 /// highlight entries private to a namespace
@@ -544,6 +558,7 @@ void clear_hl_tables(bool reinit)
     map_clear(int, &combine_attr_entries);
     map_clear(int, &blend_attr_entries);
     map_clear(int, &blendthrough_attr_entries);
+    memset(blend_cache, 0, sizeof(blend_cache));
     set_clear(cstr_t, &urls);
     memset(highlight_attr_last, -1, sizeof(highlight_attr_last));
     highlight_attr_set_all();
@@ -563,6 +578,7 @@ void hl_invalidate_blends(void)
 {
   map_clear(int, &blend_attr_entries);
   map_clear(int, &blendthrough_attr_entries);
+  memset(blend_cache, 0, sizeof(blend_cache));
   highlight_changed();
   update_window_hl(curwin, true);
 }
@@ -701,10 +717,23 @@ int hl_blend_attrs(int back_attr, int front_attr, bool *through)
     return -1;
   }
 
+  BlendCacheEntry *entry
+    = &blend_cache[((unsigned)back_attr * 31 + (unsigned)front_attr * 2 + *through)
+                   % BLEND_CACHE_SIZE];
+  if (entry->id > 0 && entry->back_attr == back_attr && entry->front_attr == front_attr
+      && entry->through == *through) {
+    *through = entry->through_out;
+    return entry->id;
+  }
+  BlendCacheEntry new_entry = { .back_attr = back_attr, .front_attr = front_attr,
+                                .through = *through };
+
   HlAttrs fattrs = get_colors_force(front_attr);
   int ratio = fattrs.hl_blend;
   if (ratio <= 0) {
     *through = false;
+    new_entry.id = front_attr;
+    *entry = new_entry;
     return front_attr;
   }
 
@@ -714,6 +743,9 @@ int hl_blend_attrs(int back_attr, int front_attr, bool *through)
                         : &blend_attr_entries);
   int id = map_get(int, int)(map, combine_tag);
   if (id > 0) {
+    new_entry.through_out = *through;
+    new_entry.id = id;
+    *entry = new_entry;
     return id;
   }
 
@@ -761,6 +793,9 @@ int hl_blend_attrs(int back_attr, int front_attr, bool *through)
                                  .id1 = back_attr, .id2 = front_attr });
   if (id > 0) {
     map_put(int, int)(map, combine_tag, id);
+    new_entry.through_out = *through;
+    new_entry.id = id;
+    *entry = new_entry;
   }
   return id;
 }
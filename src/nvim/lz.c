@@ -0,0 +1,196 @@
+/// @file lz.c
+///
+/// A small and fast LZ77 compressor, used for memfile blocks that are kept in
+/// memory, see mf_compress_cold().  The compressed data is only used by the
+/// running Nvim, the format can change at any time.
+///
+/// The data is a sequence of items, each one is:
+/// - A token byte.  The high four bits are the number of literal bytes, the
+///   low four bits the length of the match minus LZ_MIN_MATCH.  The value 15
+///   means more bytes follow that are added: 255 means another byte follows.
+/// - More bytes for the literal length.
+/// - The literal bytes.
+/// - Two bytes: offset of the match back from the current position, least
+///   significant byte first.
+/// - More bytes for the match length.
+/// The last item only has literal bytes, it ends where the data ends.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "nvim/lz.h"
+#include "nvim/macros_defs.h"
+
+#define LZ_MIN_MATCH  4       ///< shortest match that is used
+#define LZ_MAX_OFFSET 65535   ///< furthest match that can be used
+#define LZ_HASH_BITS  12      ///< size of the table of positions
+
+#ifdef INCLUDE_GENERATED_DECLARATIONS
+# include "lz.c.generated.h"
+#endif
+
+static inline uint32_t lz_read32(const uint8_t *p)
+{
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline unsigned lz_hash(uint32_t v)
+{
+  return (v * 2654435761U) >> (32 - LZ_HASH_BITS);
+}
+
+/// Write the extra bytes for a length "len" that does not fit in a token.
+static uint8_t *lz_put_len(uint8_t *out, size_t len)
+{
+  if (len < 15) {
+    return out;
+  }
+  len -= 15;
+  while (len >= 255) {
+    *out++ = 255;
+    len -= 255;
+  }
+  *out++ = (uint8_t)len;
+  return out;
+}
+
+/// Write an item with "lit_len" bytes at "lit" and a match of "match_len"
+/// bytes at "offset".  "match_len" is zero for the last item.
+///
+/// @return  false when it does not fit before "out_end".
+static bool lz_put_item(uint8_t **outp, const uint8_t *out_end, const uint8_t *lit,
+                        size_t lit_len, size_t offset, size_t match_len)
+{
+  uint8_t *out = *outp;
+  size_t extra = match_len == 0 ? 0 : match_len - LZ_MIN_MATCH;
+  size_t needed = 1 + lit_len / 255 + 1 + lit_len + (match_len == 0 ? 0 : 2 + extra / 255 + 1);
+  if (needed > (size_t)(out_end - out)) {
+    return false;
+  }
+
+  *out++ = (uint8_t)((MIN(lit_len, 15) << 4) | MIN(extra, 15));
+  out = lz_put_len(out, lit_len);
+  memcpy(out, lit, lit_len);
+  out += lit_len;
+  if (match_len != 0) {
+    *out++ = (uint8_t)(offset & 0xff);
+    *out++ = (uint8_t)(offset >> 8);
+    out = lz_put_len(out, extra);
+  }
+  *outp = out;
+  return true;
+}
+
+/// Compress "len" bytes at "src" into "dst", which has room for "size" bytes.
+///
+/// @return  number of bytes in "dst", zero when the compressed data does not
+///          fit.
+size_t lz_compress(const char *src, size_t len, char *dst, size_t size)
+  FUNC_ATTR_NONNULL_ALL
+{
+  const uint8_t *in = (const uint8_t *)src;
+  uint8_t *out = (uint8_t *)dst;
+  const uint8_t *const out_end = out + size;
+  // Position plus one of the last group of bytes with the same hash.
+  uint32_t table[1 << LZ_HASH_BITS] = { 0 };
+
+  size_t anchor = 0;  // first byte not written yet
+  size_t pos = 0;
+  while (len >= LZ_MIN_MATCH && pos <= len - LZ_MIN_MATCH) {
+    uint32_t v = lz_read32(in + pos);
+    unsigned h = lz_hash(v);
+    size_t cand = table[h];
+    table[h] = (uint32_t)pos + 1;
+    if (cand == 0 || pos - (cand - 1) > LZ_MAX_OFFSET || lz_read32(in + cand - 1) != v) {
+      pos++;
+      continue;
+    }
+    cand--;
+    size_t match_len = LZ_MIN_MATCH;
+    while (pos + match_len < len && in[cand + match_len] == in[pos + match_len]) {
+      match_len++;
+    }
+    if (!lz_put_item(&out, out_end, in + anchor, pos - anchor, pos - cand, match_len)) {
+      return 0;
+    }
+    pos += match_len;
+    anchor = pos;
+  }
+  if (!lz_put_item(&out, out_end, in + anchor, len - anchor, 0, 0)) {
+    return 0;
+  }
+  return (size_t)(out - (uint8_t *)dst);
+}
+
+/// Read the extra bytes of a length and add them to "len".
+static bool lz_get_len(const uint8_t **inp, const uint8_t *in_end, size_t *len)
+{
+  const uint8_t *in = *inp;
+  uint8_t b;
+  do {
+    if (in == in_end) {
+      return false;
+    }
+    b = *in++;
+    *len += b;
+  } while (b == 255);
+  *inp = in;
+  return true;
+}
+
+/// Decompress "len" bytes at "src", produced by lz_compress(), into "dst",
+/// which has room for "size" bytes.
+///
+/// @return  number of bytes in "dst", zero when the data is invalid or does
+///          not fit.
+size_t lz_decompress(const char *src, size_t len, char *dst, size_t size)
+  FUNC_ATTR_NONNULL_ALL
+{
+  const uint8_t *in = (const uint8_t *)src;
+  const uint8_t *const in_end = in + len;
+  uint8_t *out = (uint8_t *)dst;
+  const uint8_t *const out_end = out + size;
+
+  while (in < in_end) {
+    unsigned token = *in++;
+    size_t lit_len = token >> 4;
+    if (lit_len == 15 && !lz_get_len(&in, in_end, &lit_len)) {
+      return 0;
+    }
+    if (lit_len > (size_t)(in_end - in) || lit_len > (size_t)(out_end - out)) {
+      return 0;
+    }
+    memcpy(out, in, lit_len);
+    in += lit_len;
+    out += lit_len;
+    if (in == in_end) {
+      break;  // last item
+    }
+
+    if (in_end - in < 2) {
+      return 0;
+    }
+    size_t offset = (size_t)in[0] | ((size_t)in[1] << 8);
+    in += 2;
+    size_t match_len = token & 15;
+    if (match_len == 15 && !lz_get_len(&in, in_end, &match_len)) {
+      return 0;
+    }
+    match_len += LZ_MIN_MATCH;
+    if (offset == 0 || offset > (size_t)(out - (uint8_t *)dst)
+        || match_len > (size_t)(out_end - out)) {
+      return 0;
+    }
+    // The match may overlap with the bytes being written, copy byte by byte.
+    const uint8_t *from = out - offset;
+    for (size_t i = 0; i < match_len; i++) {
+      out[i] = from[i];
+    }
+    out += match_len;
+  }
+  return (size_t)(out - (uint8_t *)dst);
+}
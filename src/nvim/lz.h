@@ -0,0 +1,7 @@
+#pragma once
+
+#include <stddef.h>  // IWYU pragma: keep
+
+#ifdef INCLUDE_GENERATED_DECLARATIONS
+# include "lz.h.generated.h"
+#endif
@@ -136,6 +136,14 @@
 # define IO_COUNT(x)  (x)
 #endif
 
+// On x86-64 some functions have a version that uses AVX2, selected at runtime
+// with __builtin_cpu_supports("avx2").  Put AVX2_TARGET before "static" of
+// such a function, it must be defined before it is used.
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(_MSC_VER)
+# define HAVE_AVX2_DISPATCH
+# define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
 ///
 /// PRAGMA_DIAG_PUSH_IGNORE_MISSING_PROTOTYPES
 ///
@@ -30,6 +30,7 @@
 #include "nvim/autocmd_defs.h"
 #include "nvim/buffer.h"
 #include "nvim/buffer_defs.h"
+#include "nvim/bufwrite.h"
 #include "nvim/channel.h"
 #include "nvim/channel_defs.h"
 #include "nvim/decoration.h"
@@ -159,6 +160,7 @@ void event_init(void)
   // mspgack-rpc initialization
   channel_init();
   terminal_init();
+  drawscreen_init();
   ui_init();
   TIME_MSG("event init");
 }
@@ -180,6 +182,7 @@ bool event_teardown(void)
   server_teardown();
   signal_teardown();
   terminal_teardown();
+  drawscreen_teardown();
 
   return loop_close(&main_loop, true);
 }
@@ -683,6 +686,7 @@ void os_exit(int r)
     ui_flush();
     ui_call_stop();
     ml_close_all(true);           // remove all memfiles
+    buf_unwatch_all();            // close directory watchers
   }
 
   if (!event_teardown() && r == 0) {
@@ -725,6 +729,11 @@ void getout(int exitval)
   // Optionally print hashtable efficiency.
   hash_debug_results();
 
+  // Finish writing files with ":write ++async".
+  buf_write_async_wait(NULL);
+  // Stop reading files in the background, see 'streamfilesize'.
+  buf_load_stop(NULL);
+
   if (v_dying <= 1) {
     const tabpage_T *next_tp;
 
@@ -68,6 +68,20 @@
 
 #define rawkey(itr) ((itr)->x->key[(itr)->i])
 
+// Free nodes are kept for reuse, so that clearing and filling a tree again, like
+// when a plugin replaces all its marks on every change, does not go through the
+// allocator for each node. Leaf and internal nodes have different sizes and are
+// kept apart. No more free nodes are kept than there are nodes in use.
+enum { MT_POOL_MIN = 64, };
+
+typedef struct {
+  MTNode *free;  ///< linked by "parent"
+  size_t n_free;
+  size_t n_live;
+} MTNodePool;
+
+static MTNodePool node_pool[2] = { 0 };  // leaf nodes, internal nodes
+
 static bool pos_leq(MTPos a, MTPos b)
 {
   return a.row < b.row || (a.row == b.row && a.col <= b.col);
@@ -328,6 +342,210 @@ void marktree_put(MarkTree *b, MTKey key, int end_row, int end_col, bool end_rig
   }
 }
 
+static int key_cmp_ptr(const void *s1, const void *s2)
+{
+  return key_cmp(*(MTKey *)s1, *(MTKey *)s2);
+}
+
+/// Insert many marks at once. Each of "marks" is a start key and the end
+/// position (row < 0 for a mark without end), like arguments of marktree_put().
+/// If "del_ns" is non-zero, all marks in that namespace are deleted first.
+///
+/// When this changes a large part of the tree, the remaining keys and the new
+/// keys (sorted once) are merged and the tree is rebuilt bottom-up, instead of
+/// descending and splitting nodes for every single key.
+void marktree_put_many(MarkTree *b, MTPair *marks, size_t n, uint32_t del_ns)
+{
+  size_t n_del = 0;
+  if (del_ns && b->root) {
+    MarkTreeIter itr[1];
+    marktree_itr_first(b, itr);
+    for (; itr->x; marktree_itr_next(b, itr)) {
+      n_del += (rawkey(itr).ns == del_ns);
+    }
+  }
+
+  size_t n_put = 0;
+  for (size_t i = 0; i < n; i++) {
+    n_put += marks[i].end_pos.row >= 0 ? 2 : 1;
+  }
+
+  // a rebuild visits every key, only do it when the change is big enough
+  if (n_put + n_del < 2 * T || (n_put + n_del) * 4 < b->n_keys) {
+    if (n_del) {
+      marktree_del_ns(b, del_ns);
+    }
+    for (size_t i = 0; i < n; i++) {
+      marktree_put(b, marks[i].start, marks[i].end_pos.row, marks[i].end_pos.col,
+                   marks[i].end_right_gravity);
+    }
+    return;
+  }
+
+  bool paired = false;
+  MTKey *new_keys = xmalloc(MAX(n_put, 1) * sizeof(*new_keys));
+  size_t k = 0;
+  for (size_t i = 0; i < n; i++) {
+    MTKey key = marks[i].start;
+    assert(!(key.flags & ~(MT_FLAG_EXTERNAL_MASK | MT_FLAG_RIGHT_GRAVITY)));
+    key.flags |= MT_FLAG_REAL;
+    if (marks[i].end_pos.row >= 0) {
+      bool end_right = marks[i].end_right_gravity;
+      key.flags |= MT_FLAG_PAIRED;
+      MTKey end_key = key;
+      end_key.flags = (uint16_t)((uint16_t)(key.flags & ~MT_FLAG_RIGHT_GRAVITY)
+                                 |(uint16_t)MT_FLAG_END
+                                 |(uint16_t)(end_right ? MT_FLAG_RIGHT_GRAVITY : 0));
+      end_key.pos = marks[i].end_pos;
+      new_keys[k++] = end_key;
+      paired = true;
+    }
+    new_keys[k++] = key;
+  }
+  qsort(new_keys, n_put, sizeof(*new_keys), key_cmp_ptr);
+
+  // merge with the remaining keys, which are already in order
+  size_t n_keys = b->n_keys - n_del + n_put;
+  MTKey *keys = xmalloc(MAX(n_keys, 1) * sizeof(*keys));
+  size_t j = 0;
+  k = 0;
+  if (b->root) {
+    MarkTreeIter itr[1];
+    marktree_itr_first(b, itr);
+    for (; itr->x; marktree_itr_next(b, itr)) {
+      MTKey key = marktree_itr_current(itr);
+      if (del_ns && key.ns == del_ns) {
+        continue;
+      }
+      while (j < n_put && key_cmp(new_keys[j], key) < 0) {
+        keys[k++] = new_keys[j++];
+      }
+      paired |= mt_paired(key);
+      keys[k++] = key;
+    }
+  }
+  while (j < n_put) {
+    keys[k++] = new_keys[j++];
+  }
+  assert(k == n_keys);
+  xfree(new_keys);
+
+  marktree_clear(b);
+  if (n_keys > 0) {
+    // lowest height where the keys fit, (2T)^(height+1) - 1 keys
+    int height = 0;
+    for (size_t max = 2 * T - 1; max < n_keys; max = max * 2 * T + 2 * T - 1) {
+      height++;
+    }
+    b->root = marktree_build_node(b, keys, n_keys, height, MTPos(0, 0), true);
+    meta_describe_node(b->meta_root, b->root);
+    b->n_keys = n_keys;
+  }
+  xfree(keys);
+
+  if (paired) {
+    marktree_intersect_all(b);
+  }
+}
+
+/// Build a subtree of height "level" from "n" sorted keys with absolute positions.
+/// Nodes are filled evenly, so that each has at least T-1 keys (one for the root).
+static MTNode *marktree_build_node(MarkTree *b, MTKey *keys, size_t n, int level, MTPos base,
+                                   bool root)
+{
+  MTNode *x = marktree_alloc_node(b, level > 0);
+  x->level = (int16_t)level;
+
+  if (level == 0) {
+    assert(n <= 2 * T - 1);
+    x->n = (int32_t)n;
+    for (int i = 0; i < x->n; i++) {
+      x->key[i] = keys[i];
+      relative(base, &x->key[i].pos);
+      refkey(b, x, i);
+    }
+    return x;
+  }
+
+  // a child subtree holds at most "cap" - 1 keys
+  size_t cap = 1;
+  for (int l = 0; l < level; l++) {
+    cap *= 2 * T;
+  }
+  size_t c = MAX((n + cap) / cap, (size_t)(root ? 2 : T));
+  assert(c <= 2 * T);
+  size_t q = (n + 1 - c) / c;
+  size_t r = (n + 1 - c) % c;
+
+  MTPos child_base = base;
+  size_t k = 0;
+  for (size_t i = 0; i < c; i++) {
+    size_t m = q + (i < r ? 1 : 0);
+    MTNode *y = marktree_build_node(b, keys + k, m, level - 1, child_base, false);
+    y->parent = x;
+    y->p_idx = (int16_t)i;
+    x->ptr[i] = y;
+    meta_describe_node(x->meta[i], y);
+    k += m;
+    if (i < c - 1) {
+      x->key[i] = keys[k];
+      child_base = keys[k].pos;
+      relative(base, &x->key[i].pos);
+      refkey(b, x, (int)i);
+      k++;
+    }
+  }
+  assert(k == n);
+  x->n = (int32_t)(c - 1);
+  return x;
+}
+
+/// Delete all marks in namespace "ns".
+static void marktree_del_ns(MarkTree *b, uint32_t ns)
+{
+  MarkTreeIter itr[1];
+  marktree_itr_first(b, itr);
+  while (itr->x) {
+    MTKey key = marktree_itr_current(itr);
+    if (key.ns != ns) {
+      marktree_itr_next(b, itr);
+      continue;
+    }
+    uint64_t other = marktree_del_itr(b, itr, false);
+    if (other) {
+      marktree_lookup(b, other, itr);
+      marktree_del_itr(b, itr, false);
+      marktree_itr_get(b, key.pos.row, key.pos.col, itr);
+    }
+  }
+}
+
+/// Intersect the nodes between the start and end of every pair.
+static void marktree_intersect_all(MarkTree *b)
+{
+  MarkTreeIter itr[1];
+  marktree_itr_first(b, itr);
+  while (true) {
+    MTKey mark = marktree_itr_current(itr);
+    if (mark.pos.row < 0) {
+      break;
+    }
+
+    if (mt_start(mark)) {
+      MarkTreeIter start_itr[1];
+      MarkTreeIter end_itr[1];
+      uint64_t end_id = mt_lookup_id(mark.ns, mark.id, true);
+      MTKey k = marktree_lookup(b, end_id, end_itr);
+      if (k.pos.row >= 0) {
+        *start_itr = *itr;
+        marktree_intersect_pair(b, mt_lookup_key(mark), start_itr, end_itr, false);
+      }
+    }
+
+    marktree_itr_next(b, itr);
+  }
+}
+
 // this is currently not used very often, but if it was it should use binary search
 static bool intersection_has(Intersection *x, uint64_t id)
 {
@@ -437,7 +655,16 @@ void marktree_intersect_pair(MarkTree *b, uint64_t id, MarkTreeIter *itr, MarkTr
 
 static MTNode *marktree_alloc_node(MarkTree *b, bool internal)
 {
-  MTNode *x = xcalloc(1, internal ? ILEN : sizeof(MTNode));
+  MTNodePool *pool = &node_pool[internal];
+  MTNode *x = pool->free;
+  if (x) {
+    pool->free = x->parent;
+    pool->n_free--;
+    memset(x, 0, internal ? ILEN : sizeof(MTNode));
+  } else {
+    x = xcalloc(1, internal ? ILEN : sizeof(MTNode));
+  }
+  pool->n_live++;
   kvi_init(x->intersect);
   b->n_nodes++;
   return x;
@@ -487,9 +714,10 @@ static bool meta_has(const uint32_t *meta_count, MetaFilter meta_filter)
 
 void marktree_put_key(MarkTree *b, MTKey k)
 {
+  b->changedtick++;
   k.flags |= MT_FLAG_REAL;  // let's be real.
   if (!b->root) {
-    b->root = marktree_alloc_node(b, true);
+    b->root = marktree_alloc_node(b, false);
   }
   MTNode *r = b->root;
   if (r->n == 2 * T - 1) {
@@ -540,6 +768,7 @@ void marktree_put_key(MarkTree *b, MTKey k)
 ///            recommended strategy is to always iterate forward)
 uint64_t marktree_del_itr(MarkTree *b, MarkTreeIter *itr, bool rev)
 {
+  b->changedtick++;
   int adjustment = 0;
 
   MTNode *cur = itr->x;
@@ -776,6 +1005,7 @@ uint64_t marktree_del_itr(MarkTree *b, MarkTreeIter *itr, bool rev)
 
 void marktree_revise_flags(MarkTree *b, MarkTreeIter *itr, uint16_t new_flags)
 {
+  b->changedtick++;
   uint32_t meta_old[4];
   meta_describe_key(meta_old, rawkey(itr));
   rawkey(itr).flags &= (uint16_t) ~MT_FLAG_EXTERNAL_MASK;
@@ -1289,6 +1519,7 @@ static void pivot_left(MarkTree *b, MTPos p_pos, MTNode *p, int i)
 /// frees all mem, resets tree to valid empty state
 void marktree_clear(MarkTree *b)
 {
+  b->changedtick++;
   if (b->root) {
     marktree_free_subtree(b, b->root);
     b->root = NULL;
@@ -1312,13 +1543,45 @@ void marktree_free_subtree(MarkTree *b, MTNode *x)
 static void marktree_free_node(MarkTree *b, MTNode *x)
 {
   kvi_destroy(x->intersect);
-  xfree(x);
+  // only nodes above the leaves are allocated with space for children
+  MTNodePool *pool = &node_pool[x->level > 0];
+  pool->n_live--;
+  if (pool->n_free < MAX(MT_POOL_MIN, pool->n_live)) {
+    x->parent = pool->free;
+    pool->free = x;
+    pool->n_free++;
+  } else {
+    xfree(x);
+  }
   b->n_nodes--;
 }
 
+/// Number of nodes in use by all trees ("free" false),
+/// or number of free nodes kept for reuse ("free" true).
+size_t marktree_node_count(bool free)
+{
+  return free ? node_pool[0].n_free + node_pool[1].n_free
+              : node_pool[0].n_live + node_pool[1].n_live;
+}
+
+#if defined(EXITFREE)
+void marktree_free_all_mem(void)
+{
+  for (int i = 0; i < 2; i++) {
+    while (node_pool[i].free) {
+      MTNode *x = node_pool[i].free;
+      node_pool[i].free = x->parent;
+      xfree(x);
+    }
+    node_pool[i].n_free = 0;
+  }
+}
+#endif
+
 /// @param itr iterator is invalid after call
 void marktree_move(MarkTree *b, MarkTreeIter *itr, int row, int col)
 {
+  b->changedtick++;
   MTKey key = rawkey(itr);
   MTNode *x = itr->x;
   if (!x->level) {
@@ -1917,6 +2180,7 @@ bool marktree_splice(MarkTree *b, int32_t start_line, int start_col, int old_ext
   MTPos old_extent = { old_extent_line, old_extent_col };
   MTPos new_extent = { new_extent_line, new_extent_col };
 
+  b->changedtick++;
   bool may_delete = (old_extent.row != 0 || old_extent.col != 0);
   bool same_line = old_extent.row == 0 && new_extent.row == 0;
   unrelative(start, &old_extent);
@@ -2043,6 +2307,14 @@ past_continue_same_node:
     unrelative(oldbase[itr->lvl], &rawkey(itr).pos);
     int realrow = rawkey(itr).pos.row;
     assert(realrow >= old_extent.row);
+    if (delta.row == 0 && (delta.col == 0 || realrow > old_extent.row)
+        && !pos_leq(start, oldbase[itr->lvl])) {
+      // optimization: replacing text with text of the same height. Neither this key nor
+      // any key after it moves, and as the base of this node is before the edit, so are
+      // the bases of its parents, which thus didn't move either.
+      relative(itr->pos, &rawkey(itr).pos);
+      break;
+    }
     bool done = false;
     if (realrow == old_extent.row) {
       if (delta.col) {
@@ -2399,27 +2671,7 @@ bool marktree_check_intersections(MarkTree *b)
 
   // 2. iterate over all marks. for each START mark of a pair,
   // intersect the nodes between the pair
-  MarkTreeIter itr[1];
-  marktree_itr_first(b, itr);
-  while (true) {
-    MTKey mark = marktree_itr_current(itr);
-    if (mark.pos.row < 0) {
-      break;
-    }
-
-    if (mt_start(mark)) {
-      MarkTreeIter start_itr[1];
-      MarkTreeIter end_itr[1];
-      uint64_t end_id = mt_lookup_id(mark.ns, mark.id, true);
-      MTKey k = marktree_lookup(b, end_id, end_itr);
-      if (k.pos.row >= 0) {
-        *start_itr = *itr;
-        marktree_intersect_pair(b, mt_lookup_key(mark), start_itr, end_itr, false);
-      }
-    }
-
-    marktree_itr_next(b, itr);
-  }
+  marktree_intersect_all(b);
 
   // 3. for each node check if the recreated intersection
   // matches the old checked[x] intersection.
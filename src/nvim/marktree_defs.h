@@ -99,5 +99,8 @@ typedef struct {
   MTNode *root;
   uint32_t meta_root[kMTMetaCount];
   size_t n_keys, n_nodes;
+  /// incremented on every change of marks or of their decorations, iterators
+  /// saved with an older value are invalid
+  uint64_t changedtick;
   PMap(uint64_t) id2node[1];
 } MarkTree;
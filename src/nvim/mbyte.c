@@ -68,6 +68,10 @@
 #include "nvim/types_defs.h"
 #include "nvim/vim_defs.h"
 
+#ifdef HAVE_AVX2_DISPATCH
+# include <immintrin.h>
+#endif
+
 typedef struct {
   int rangeStart;
   int rangeEnd;
@@ -2034,6 +2038,82 @@ bool utf_valid_string(const char *s, const char *end)
   return true;
 }
 
+#ifdef HAVE_AVX2_DISPATCH
+/// Part of utf_ascii_len() for CPUs with AVX2: checks blocks of 32 bytes.
+///
+/// @return  index of the first non-ASCII byte, or of the first byte that was
+///          not checked.
+AVX2_TARGET static size_t utf_ascii_len_avx2(const char *s, size_t len)
+{
+  size_t i = 0;
+  for (; i + 32 <= len; i += 32) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)(s + i));
+    unsigned mask = (unsigned)_mm256_movemask_epi8(v);
+    if (mask != 0) {
+      return i + (size_t)__builtin_ctz(mask);
+    }
+  }
+  return i;
+}
+#endif
+
+/// @return  the number of ASCII bytes (below 0x80) at the start of "s[len]".
+static size_t utf_ascii_len(const char *s, size_t len)
+{
+  size_t i = 0;
+#ifdef HAVE_AVX2_DISPATCH
+  if (len >= 32 && __builtin_cpu_supports("avx2")) {
+    i = utf_ascii_len_avx2(s, len);
+  }
+#endif
+#ifdef __SSE2__
+  for (; i + 16 <= len; i += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+    int mask = _mm_movemask_epi8(v);
+    if (mask != 0) {
+      return i + (size_t)__builtin_ctz((unsigned)mask);
+    }
+  }
+#endif
+  while (i < len && (uint8_t)s[i] < 0x80) {
+    i++;
+  }
+  return i;
+}
+
+/// Like utf_valid_string(), but returns the length of the longest valid start
+/// of "s[len]" instead of failing.  An incomplete byte sequence at the end is
+/// not included.  Runs of ASCII are skipped with SIMD where available, which
+/// makes this fast for checking the text of a file that is being read.
+///
+/// @return  "len" when all of "s" is valid.
+size_t utf_valid_prefix(const char *s, size_t len)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_PURE FUNC_ATTR_WARN_UNUSED_RESULT
+{
+  const uint8_t *p = (uint8_t *)s;
+  size_t i = 0;
+
+  while (i < len) {
+    if (p[i] < 0x80) {
+      i += utf_ascii_len(s + i, len - i);
+      continue;
+    }
+    size_t l = utf8len_tab_zero[p[i]];
+    if (l == 0 || l > len - i) {
+      break;  // invalid lead byte or incomplete byte sequence
+    }
+    size_t k = 1;
+    while (k < l && (p[i + k] & 0xc0) == 0x80) {
+      k++;
+    }
+    if (k < l) {
+      break;  // invalid trail byte
+    }
+    i += l;
+  }
+  return i;
+}
+
 // If the cursor moves on an trail byte, set the cursor on the lead byte.
 // Thus it moves left if necessary.
 void mb_adjust_cursor(void)
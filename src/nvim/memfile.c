@@ -31,9 +31,25 @@
 /// mf_put()          unlock a block, may be marked for writing
 /// mf_free()         remove a block
 /// mf_sync()         sync changed parts of memfile to disk
+/// mf_wait()         wait until the writer thread wrote all blocks
+/// mf_compress_cold() compress blocks that were not used for some time
 /// mf_release_all()  release as much memory as possible
 /// mf_trans_del()    may translate negative to positive block number
 /// mf_fullname()     make file name full path (use before first :cd)
+///
+/// A memfile can also have "lazy" blocks, created with mf_new_lazy().  Their
+/// data is built from a read-only mapping of the edited file when the block is
+/// used, see mf_set_source().  As long as a lazy block is not changed, its
+/// data can be released again and rebuilt later.
+///
+/// Blocks are written to the swap file by a writer thread: mf_write() queues a
+/// copy of the block and returns.  The writes (and fsync) of all memfiles are
+/// done in the order they were queued.  Before the swap file is read, closed or
+/// renamed the queued writes are waited for, see mf_wait().
+///
+/// Without a swap file blocks can't be written out.  Instead blocks that were
+/// not used for a while can be compressed in memory, see mf_compress_cold().
+/// mf_get() decompresses them again.
 
 #include <assert.h>
 #include <fcntl.h>
@@ -43,12 +59,16 @@
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <uv.h>
 
 #include "nvim/assert_defs.h"
 #include "nvim/buffer_defs.h"
 #include "nvim/fileio.h"
 #include "nvim/gettext_defs.h"
 #include "nvim/globals.h"
+#include "nvim/log.h"
+#include "nvim/lz.h"
+#include "nvim/macros_defs.h"
 #include "nvim/map_defs.h"
 #include "nvim/memfile.h"
 #include "nvim/memfile_defs.h"
@@ -59,12 +79,40 @@
 #include "nvim/os/fs_defs.h"
 #include "nvim/os/input.h"
 #include "nvim/os/os_defs.h"
+#include "nvim/os/time.h"
 #include "nvim/path.h"
 #include "nvim/pos_defs.h"
 #include "nvim/types_defs.h"
 #include "nvim/vim_defs.h"
 
 #define MEMFILE_PAGE_SIZE 4096       /// default page size
+#define MF_SRC_LOADED_MAX 1024       /// max number of loaded lazy blocks
+#define MF_QUEUED_MAX (64 * 1024 * 1024)  /// max bytes queued for the writer
+
+/// A write or fsync queued for the writer thread.
+typedef struct mf_job mf_job_T;
+struct mf_job {
+  mf_job_T *next;
+  memfile_T *mfp;
+  int fd;
+  off_T offset;
+  char *data;                        ///< NULL for fsync
+  size_t size;
+};
+
+/// The thread that writes swap files.  Started when the first block is written.
+static struct {
+  uv_thread_t thread;
+  uv_mutex_t mutex;
+  uv_cond_t queued;                  ///< signaled when a job is added
+  uv_cond_t done;                    ///< signaled when a job is finished
+  mf_job_T *first;                   ///< next job to do
+  mf_job_T *last;                    ///< last queued job
+  size_t queued_bytes;               ///< bytes of data in the queued jobs
+  int64_t fsync_done;                ///< fsyncs done, not in g_stats yet
+  bool started;
+  bool failed;                       ///< could not start, write directly
+} mf_writer;
 
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "memfile.c.generated.h"
@@ -102,9 +150,19 @@ memfile_T *mf_open(char *fname, int flags)
 
   mfp->mf_free_first = NULL;         // free list is empty
   mfp->mf_dirty = MF_DIRTY_NO;
+  mfp->mf_tick = 0;
   mfp->mf_hash = (PMap(int64_t)) MAP_INIT;
   mfp->mf_trans = (Map(int64_t, int64_t)) MAP_INIT;
   mfp->mf_page_size = MEMFILE_PAGE_SIZE;
+  mfp->mf_src = NULL;
+  mfp->mf_src_size = 0;
+  mfp->mf_src_fd = -1;
+  mfp->mf_src_fill = NULL;
+  mfp->mf_src_lost = false;
+  mfp->mf_src_loaded = NULL;
+  mfp->mf_src_next = 0;
+  mfp->mf_pending = 0;
+  mfp->mf_write_failed = false;
 
   // Try to set the page size equal to device's block size. Speeds up I/O a lot.
   FileInfo file_info;
@@ -172,6 +230,7 @@ void mf_close(memfile_T *mfp, bool del_file)
   if (mfp == NULL) {                    // safety check
     return;
   }
+  mf_wait(mfp);
   if (mfp->mf_fd >= 0 && close(mfp->mf_fd) < 0) {
     emsg(_(e_swapclose));
   }
@@ -190,6 +249,7 @@ void mf_close(memfile_T *mfp, bool del_file)
   map_destroy(int64_t, &mfp->mf_hash);
   map_destroy(int64_t, &mfp->mf_trans);  // free hashtable and its items
   mf_free_fnames(mfp);
+  mf_close_source(mfp);
   xfree(mfp);
 }
 
@@ -210,6 +270,7 @@ void mf_close_file(buf_T *buf, bool getlines)
     }
   }
 
+  mf_wait(mfp);
   if (close(mfp->mf_fd) < 0) {           // close the file
     emsg(_(e_swapclose));
   }
@@ -267,6 +328,7 @@ bhdr_T *mf_new(memfile_T *mfp, bool negative, unsigned page_count)
     }
   }
   hp->bh_flags = BH_LOCKED | BH_DIRTY;    // new block is always dirty
+  hp->bh_tick = mfp->mf_tick;
   mfp->mf_dirty = MF_DIRTY_YES;
   hp->bh_page_count = page_count;
   pmap_put(int64_t)(&mfp->mf_hash, hp->bh_bnum, hp);
@@ -318,8 +380,15 @@ bhdr_T *mf_get(memfile_T *mfp, blocknr_T nr, unsigned page_count)
   }
 
   hp->bh_flags |= BH_LOCKED;
+  hp->bh_tick = mfp->mf_tick;
   pmap_put(int64_t)(&mfp->mf_hash, hp->bh_bnum, hp);  // put in front of hash table
 
+  if (hp->bh_data == NULL) {                    // lazy block without data
+    mf_load_lazy(mfp, hp);
+  } else if (hp->bh_flags & BH_COMPRESSED) {
+    mf_decompress(mfp, hp);
+  }
+
   return hp;
 }
 
@@ -336,7 +405,8 @@ void mf_put(memfile_T *mfp, bhdr_T *hp, bool dirty, bool infile)
   }
   flags &= ~BH_LOCKED;
   if (dirty) {
-    flags |= BH_DIRTY;
+    // A changed block can no longer be rebuilt from the source.
+    flags = (flags & ~BH_LAZY) | BH_DIRTY;
     if (mfp->mf_dirty != MF_DIRTY_YES_NOSYNC) {
       mfp->mf_dirty = MF_DIRTY_YES;
     }
@@ -360,6 +430,143 @@ void mf_free(memfile_T *mfp, bhdr_T *hp)
   }
 }
 
+/// Get a new lazy block with a negative number.  Its data is built from "len"
+/// bytes of text at offset "off" in the source, holding "count" lines, only
+/// when the block is used with mf_get().  The block is not locked.
+///
+/// @param page_count  Number of pages needed for the data.
+bhdr_T *mf_new_lazy(memfile_T *mfp, unsigned page_count, size_t off, size_t len, unsigned count)
+{
+  bhdr_T *hp = xmalloc(sizeof(bhdr_T));
+  hp->bh_bnum = mfp->mf_blocknr_min--;
+  mfp->mf_neg_count++;
+  hp->bh_data = NULL;
+  hp->bh_page_count = page_count;
+  hp->bh_flags = BH_LAZY;
+  hp->bh_tick = mfp->mf_tick;
+  hp->bh_src_off = off;
+  hp->bh_src_len = len;
+  hp->bh_src_count = count;
+  pmap_put(int64_t)(&mfp->mf_hash, hp->bh_bnum, hp);
+  return hp;
+}
+
+/// Use "size" bytes at "src" as the text of lazy blocks.
+///
+/// @param src   Mapping from os_mmap_readonly(), owned by the memfile.
+/// @param fd    File descriptor "src" was mapped from, owned by the memfile.
+///              Used to detect that the file was truncated.
+/// @param fill  Builds the data of a block from its text.
+void mf_set_source(memfile_T *mfp, const char *src, size_t size, int fd, mf_fill_T fill)
+{
+  assert(mfp->mf_src == NULL);
+  mfp->mf_src = src;
+  mfp->mf_src_size = size;
+  mfp->mf_src_fd = fd;
+  mfp->mf_src_fill = fill;
+  mfp->mf_src_lost = false;
+  mfp->mf_src_loaded = xcalloc(MF_SRC_LOADED_MAX, sizeof(blocknr_T));
+  mfp->mf_src_next = 0;
+}
+
+/// Load the data of all lazy blocks and release the source.  Used before the
+/// mapped file is overwritten.
+void mf_drop_source(memfile_T *mfp)
+{
+  if (mfp->mf_src == NULL) {
+    return;
+  }
+
+  bhdr_T *hp;
+  map_foreach_value(&mfp->mf_hash, hp, {
+    if (hp->bh_flags & BH_LAZY) {
+      if (hp->bh_data == NULL) {
+        mf_load_lazy(mfp, hp);
+      }
+      // Like a block that was just created: only in memory.
+      hp->bh_flags = (hp->bh_flags & ~BH_LAZY) | BH_DIRTY;
+      mfp->mf_dirty = MF_DIRTY_YES;
+    }
+  })
+  mf_close_source(mfp);
+}
+
+/// Unmap and close the source of lazy blocks.
+static void mf_close_source(memfile_T *mfp)
+{
+  if (mfp->mf_src == NULL) {
+    return;
+  }
+  os_munmap(mfp->mf_src, mfp->mf_src_size);
+  if (mfp->mf_src_fd >= 0) {
+    close(mfp->mf_src_fd);
+  }
+  mfp->mf_src = NULL;
+  mfp->mf_src_size = 0;
+  mfp->mf_src_fd = -1;
+  XFREE_CLEAR(mfp->mf_src_loaded);
+}
+
+/// Build the data of lazy block "hp" from the source.
+static void mf_load_lazy(memfile_T *mfp, bhdr_T *hp)
+{
+  assert(hp->bh_flags & BH_LAZY);
+  size_t size = (size_t)mfp->mf_page_size * hp->bh_page_count;
+  hp->bh_data = xcalloc(1, size);
+
+  const char *src = mfp->mf_src + hp->bh_src_off;
+  // Reading beyond the end of a truncated file would crash: check the size
+  // of the file every time.
+  FileInfo file_info;
+  if (!mfp->mf_src_lost
+      && (!os_fileinfo_fd(mfp->mf_src_fd, &file_info)
+          || os_fileinfo_size(&file_info) < hp->bh_src_off + hp->bh_src_len)) {
+    mfp->mf_src_lost = true;
+    emsg(_("E1514: File was truncated while it was being edited, lines are missing"));
+  }
+  if (mfp->mf_src_lost) {
+    src = NULL;
+  }
+  mfp->mf_src_fill(hp, src, src == NULL ? 0 : hp->bh_src_len, hp->bh_src_count,
+                   mfp->mf_page_size);
+  if (src != NULL) {
+    // The text was copied, the mapped pages are not needed anymore.
+    os_mmap_release(mfp->mf_src, hp->bh_src_off, hp->bh_src_len);
+  }
+
+  // Release the data of the lazy block that was loaded longest ago.
+  blocknr_T old = mfp->mf_src_loaded[mfp->mf_src_next];
+  mfp->mf_src_loaded[mfp->mf_src_next] = hp->bh_bnum;
+  mfp->mf_src_next = (mfp->mf_src_next + 1) % MF_SRC_LOADED_MAX;
+  if (old != 0 && old != hp->bh_bnum) {
+    bhdr_T *old_hp = pmap_get(int64_t)(&mfp->mf_hash, old);
+    if (old_hp != NULL && (old_hp->bh_flags & (BH_LAZY | BH_DIRTY | BH_LOCKED)) == BH_LAZY) {
+      XFREE_CLEAR(old_hp->bh_data);
+    }
+  }
+}
+
+/// Release the data of all lazy blocks that are not locked and not changed.
+///
+/// @return  Whether any memory was released.
+static bool mf_release_lazy(memfile_T *mfp)
+{
+  if (mfp->mf_src == NULL) {
+    return false;
+  }
+
+  bool retval = false;
+  bhdr_T *hp;
+  map_foreach_value(&mfp->mf_hash, hp, {
+    if ((hp->bh_flags & (BH_LAZY | BH_DIRTY | BH_LOCKED)) == BH_LAZY
+        && hp->bh_data != NULL) {
+      XFREE_CLEAR(hp->bh_data);
+      retval = true;
+    }
+  })
+  return retval;
+}
+
 /// Sync memory file to disk.
 ///
 /// @param flags  MFS_ALL    If not given, blocks with negative numbers are not
@@ -369,6 +576,8 @@ void mf_free(memfile_T *mfp, bhdr_T *hp)
 ///               MFS_FLUSH  Make sure buffers are flushed to disk, so they will
 ///                          survive a system crash.
 ///               MFS_ZERO   Only write block 0.
+///               MFS_ASYNC  Return when the blocks are queued for the writer
+///                          thread, a write error is reported by a later call.
 ///
 /// @return FAIL  If failure. Possible causes:
 ///               - No file (nothing to do).
@@ -384,6 +593,8 @@ int mf_sync(memfile_T *mfp, int flags)
     return FAIL;
   }
 
+  uint64_t start = os_hrtime();
+
   // Only a CTRL-C while writing will break us here, not one typed previously.
   got_int = false;
 
@@ -391,7 +602,7 @@ int mf_sync(memfile_T *mfp, int flags)
   // file). If a write fails, it is very likely caused by a full filesystem.
   // Then we only try to write blocks within the existing file. If that also
   // fails then we give up.
-  int status = OK;
+  int status = mf_writer_check(mfp, false);
   bhdr_T *hp = NULL;
   // note, "last" block is typically earlier in the hash list
   map_foreach_value(&mfp->mf_hash, hp, {
@@ -428,16 +639,93 @@ int mf_sync(memfile_T *mfp, int flags)
   }
 
   if (flags & MFS_FLUSH) {
-    if (os_fsync(mfp->mf_fd)) {
+    if (mf_writer_start()) {
+      mf_writer_put(mfp, 0, NULL, 0);  // counted when done
+    } else if (os_fsync(mfp->mf_fd)) {
       status = FAIL;
     }
   }
 
+  if (!(flags & MFS_ASYNC) && mf_writer_check(mfp, true) == FAIL) {
+    status = FAIL;
+  }
+
   got_int |= got_int_save;
 
+  int64_t stall_us = (int64_t)(os_hrtime() - start) / 1000;
+  g_stats.swap_sync++;
+  g_stats.swap_sync_us += stall_us;
+  g_stats.swap_sync_max_us = MAX(g_stats.swap_sync_max_us, stall_us);
+  DLOG("%s: main thread stalled %" PRId64 " us%s", mfp->mf_fname, stall_us,
+       (flags & MFS_ASYNC) ? " (async)" : "");
+
   return status;
 }
 
+/// Compress the data of blocks that were not used during the last "age" calls.
+/// Only for a memfile without a swap file, otherwise unused blocks can be
+/// written to the file.  Called every time the memfile would be synced.
+void mf_compress_cold(memfile_T *mfp, int age)
+{
+  mfp->mf_tick++;
+  if (mfp->mf_fd >= 0 || age <= 0) {
+    return;
+  }
+
+  char *buf = NULL;
+  size_t buf_size = 0;
+  bhdr_T *hp;
+  map_foreach_value(&mfp->mf_hash, hp, {
+    // Block 0 is also used directly from the hash table.
+    if ((hp->bh_flags & (BH_LOCKED | BH_LAZY | BH_COMPRESSED)) || hp->bh_data == NULL
+        || hp->bh_bnum == 0 || mfp->mf_tick - hp->bh_tick < (uint32_t)age) {
+      continue;
+    }
+    size_t size = (size_t)mfp->mf_page_size * hp->bh_page_count;
+    if (size > buf_size) {
+      buf_size = size;
+      buf = xrealloc(buf, buf_size);
+    }
+    // Only worth it when at least a quarter is saved.
+    size_t csize = lz_compress(hp->bh_data, size, buf, size - size / 4);
+    if (csize == 0) {
+      hp->bh_tick = mfp->mf_tick;  // don't try again soon
+      continue;
+    }
+    xfree(hp->bh_data);
+    hp->bh_data = xmemdup(buf, csize);
+    hp->bh_csize = csize;
+    hp->bh_flags |= BH_COMPRESSED;
+    g_stats.mf_compress_bytes += (int64_t)size;
+    g_stats.mf_compress_size += (int64_t)csize;
+  })
+  xfree(buf);
+}
+
+/// Decompress the data of block "hp", compressed by mf_compress_cold().
+static void mf_decompress(memfile_T *mfp, bhdr_T *hp)
+{
+  uint64_t start = os_hrtime();
+  size_t size = (size_t)mfp->mf_page_size * hp->bh_page_count;
+  char *data = xmalloc(size);
+  size_t len = lz_decompress(hp->bh_data, hp->bh_csize, data, size);
+  assert(len == size);
+  (void)len;
+  xfree(hp->bh_data);
+  hp->bh_data = data;
+  hp->bh_flags &= ~BH_COMPRESSED;
+  g_stats.mf_decompress++;
+  g_stats.mf_decompress_ns += (int64_t)(os_hrtime() - start);
+}
+
+/// Wait until the writer thread wrote the queued blocks of "mfp".
+///
+/// @return  FAIL when a write failed, OK otherwise.
+int mf_wait(memfile_T *mfp)
+{
+  return mf_writer_check(mfp, true);
+}
+
 /// Set dirty flag for all blocks in memory file with a positive block number.
 /// These are blocks that need to be written to a newly created swapfile.
 void mf_set_dirty(memfile_T *mfp)
@@ -462,6 +750,11 @@ bool mf_release_all(void)
   FOR_ALL_BUFFERS(buf) {
     memfile_T *mfp = buf->b_ml.ml_mfp;
     if (mfp != NULL) {
+      // Unchanged lazy blocks can always be rebuilt from the source.
+      if (mf_release_lazy(mfp)) {
+        retval = true;
+      }
+
       // If no swap file yet, try to open one.
       if (mfp->mf_fd < 0 && buf->b_may_swap) {
         ml_open_file(buf);
@@ -471,9 +764,9 @@ bool mf_release_all(void)
       if (mfp->mf_fd >= 0) {
         for (int i = 0; i < (int)map_size(&mfp->mf_hash);) {
           bhdr_T *hp = mfp->mf_hash.values[i];
-          if (!(hp->bh_flags & BH_LOCKED)
+          if (!(hp->bh_flags & (BH_LOCKED | BH_LAZY))
               && (!(hp->bh_flags & BH_DIRTY)
-                  || mf_write(mfp, hp) != FAIL)) {
+                  || (mf_write(mfp, hp) != FAIL && mf_wait(mfp) != FAIL))) {
             pmap_del(int64_t)(&mfp->mf_hash, hp->bh_bnum, NULL);
             mf_free_bhdr(hp);
             retval = true;
@@ -533,6 +826,7 @@ static int mf_read(memfile_T *mfp, bhdr_T *hp)
   if (mfp->mf_fd < 0) {     // there is no file, can't read
     return FAIL;
   }
+  mf_wait(mfp);             // the block may still be queued for writing
 
   unsigned page_size = mfp->mf_page_size;
   // TODO(elmart): Check (page_size * hp->bh_bnum) within off_T bounds.
@@ -574,6 +868,11 @@ static int mf_write(memfile_T *mfp, bhdr_T *hp)
       return FAIL;
     }
   }
+  if (hp->bh_data == NULL) {  // lazy block without data
+    mf_load_lazy(mfp, hp);
+  } else if (hp->bh_flags & BH_COMPRESSED) {
+    mf_decompress(mfp, hp);
+  }
 
   unsigned page_size = mfp->mf_page_size;  // number of bytes in a page
 
@@ -592,18 +891,25 @@ static int mf_write(memfile_T *mfp, bhdr_T *hp)
 
     // TODO(elmart): Check (page_size * nr) within off_T bounds.
     off_T offset = (off_T)(page_size * nr);  // offset in the file
-    if (vim_lseek(mfp->mf_fd, offset, SEEK_SET) != offset) {
-      PERROR(_("E296: Seek error in swap file write"));
-      return FAIL;
-    }
     if (hp2 == NULL) {              // freed block, fill with dummy data
       page_count = 1;
     } else {
       page_count = hp2->bh_page_count;
     }
     unsigned size = page_size * page_count;  // number of bytes written
+    if (hp2 != NULL && hp2->bh_data == NULL) {  // lazy block without data
+      mf_load_lazy(mfp, hp2);
+    } else if (hp2 != NULL && (hp2->bh_flags & BH_COMPRESSED)) {
+      mf_decompress(mfp, hp2);
+    }
     void *data = (hp2 == NULL) ? hp->bh_data : hp2->bh_data;
-    if ((unsigned)write_eintr(mfp->mf_fd, data, size) != size) {
+    if (mf_writer_start()) {
+      // The writer thread writes a copy, the block may change or be freed.
+      mf_writer_put(mfp, offset, xmemdup(data, size), size);
+    } else if (vim_lseek(mfp->mf_fd, offset, SEEK_SET) != offset) {
+      PERROR(_("E296: Seek error in swap file write"));
+      return FAIL;
+    } else if ((unsigned)write_eintr(mfp->mf_fd, data, size) != size) {
       /// Avoid repeating the error message, this mostly happens when the
       /// disk is full. We give the message again only after a successful
       /// write or when hitting a key. We keep on trying, in case some
@@ -613,8 +919,9 @@ static int mf_write(memfile_T *mfp, bhdr_T *hp)
       }
       did_swapwrite_msg = true;
       return FAIL;
+    } else {
+      did_swapwrite_msg = false;
     }
-    did_swapwrite_msg = false;
     if (hp2 != NULL) {                             // written a non-dummy block
       hp2->bh_flags &= ~BH_DIRTY;
     }
@@ -628,6 +935,150 @@ static int mf_write(memfile_T *mfp, bhdr_T *hp)
   return OK;
 }
 
+/// Start the writer thread if it was not started yet.
+///
+/// @return  false if there is no writer thread, blocks must be written directly.
+static bool mf_writer_start(void)
+{
+  if (mf_writer.started || mf_writer.failed) {
+    return mf_writer.started;
+  }
+  uv_mutex_init(&mf_writer.mutex);
+  uv_cond_init(&mf_writer.queued);
+  uv_cond_init(&mf_writer.done);
+  if (uv_thread_create(&mf_writer.thread, mf_writer_main, NULL) != 0) {
+    ELOG("could not start the swap writer thread, writing directly");
+    uv_cond_destroy(&mf_writer.done);
+    uv_cond_destroy(&mf_writer.queued);
+    uv_mutex_destroy(&mf_writer.mutex);
+    mf_writer.failed = true;
+    return false;
+  }
+  mf_writer.started = true;
+  return true;
+}
+
+/// Queue writing "size" bytes of "data" at "offset" in the swap file of "mfp",
+/// or an fsync when "data" is NULL.  Takes ownership of "data".
+static void mf_writer_put(memfile_T *mfp, off_T offset, char *data, size_t size)
+{
+  mf_job_T *job = xmalloc(sizeof(mf_job_T));
+  *job = (mf_job_T){ .mfp = mfp, .fd = mfp->mf_fd, .offset = offset, .data = data,
+                     .size = size };
+
+  uv_mutex_lock(&mf_writer.mutex);
+  // Don't let the copies use too much memory when the disk is slow.
+  while (mf_writer.queued_bytes > MF_QUEUED_MAX) {
+    uv_cond_wait(&mf_writer.done, &mf_writer.mutex);
+  }
+  if (mf_writer.last == NULL) {
+    mf_writer.first = job;
+  } else {
+    mf_writer.last->next = job;
+  }
+  mf_writer.last = job;
+  mf_writer.queued_bytes += size;
+  mfp->mf_pending++;
+  uv_cond_signal(&mf_writer.queued);
+  uv_mutex_unlock(&mf_writer.mutex);
+}
+
+/// Main function of the writer thread.  Must not use any global state of the
+/// editor, only the jobs and the counters in the memfiles.
+static void mf_writer_main(void *arg)
+{
+  uv_mutex_lock(&mf_writer.mutex);
+  while (true) {
+    while (mf_writer.first == NULL) {
+      uv_cond_wait(&mf_writer.queued, &mf_writer.mutex);
+    }
+    mf_job_T *job = mf_writer.first;
+    mf_writer.first = job->next;
+    if (mf_writer.first == NULL) {
+      mf_writer.last = NULL;
+    }
+    uv_mutex_unlock(&mf_writer.mutex);
+
+    bool ok;
+    if (job->data == NULL) {
+      uv_fs_t req;
+      ok = uv_fs_fsync(NULL, &req, job->fd, NULL) == 0;
+      uv_fs_req_cleanup(&req);
+    } else {
+      ok = os_pwrite(job->fd, job->data, job->size, job->offset) == (ptrdiff_t)job->size;
+    }
+    xfree(job->data);
+
+    uv_mutex_lock(&mf_writer.mutex);
+    if (!ok) {
+      job->mfp->mf_write_failed = true;
+    } else if (job->data == NULL) {
+      mf_writer.fsync_done++;
+    }
+    // After this the memfile may be closed.
+    job->mfp->mf_pending--;
+    mf_writer.queued_bytes -= job->size;
+    uv_cond_broadcast(&mf_writer.done);
+    xfree(job);
+  }
+}
+
+/// Check for failed writes of "mfp" by the writer thread.  When a write failed
+/// give an error message and mark the blocks dirty, so that they are written
+/// again by the next sync.
+///
+/// @param wait  first wait until the queued writes of "mfp" are done
+///
+/// @return  FAIL when a write failed, OK otherwise.
+static int mf_writer_check(memfile_T *mfp, bool wait)
+{
+  if (!mf_writer.started) {
+    return OK;
+  }
+  uv_mutex_lock(&mf_writer.mutex);
+  while (wait && mfp->mf_pending > 0) {
+    uv_cond_wait(&mf_writer.done, &mf_writer.mutex);
+  }
+  bool failed = mfp->mf_write_failed;
+  mfp->mf_write_failed = false;
+  g_stats.fsync += mf_writer.fsync_done;
+  mf_writer.fsync_done = 0;
+  uv_mutex_unlock(&mf_writer.mutex);
+
+  if (!failed) {
+    if (wait) {
+      did_swapwrite_msg = false;
+    }
+    return OK;
+  }
+  // See mf_write() about repeating the message.
+  if (!did_swapwrite_msg) {
+    emsg(_("E297: Write error in swap file"));
+  }
+  did_swapwrite_msg = true;
+  bhdr_T *hp;
+  map_foreach_value(&mfp->mf_hash, hp, {
+    if (hp->bh_bnum >= 0) {
+      hp->bh_flags |= BH_DIRTY;
+    }
+  })
+  // Otherwise the memfile is not synced again.
+  mfp->mf_dirty = MF_DIRTY_YES;
+  return FAIL;
+}
+
+/// Add the fsync() calls that the writer thread finished to g_stats.
+void mf_writer_stats(void)
+{
+  if (!mf_writer.started) {
+    return;
+  }
+  uv_mutex_lock(&mf_writer.mutex);
+  g_stats.fsync += mf_writer.fsync_done;
+  mf_writer.fsync_done = 0;
+  uv_mutex_unlock(&mf_writer.mutex);
+}
+
 /// Make block number positive and add it to the translation list.
 ///
 /// @return  OK    On success.
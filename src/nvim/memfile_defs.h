@@ -32,9 +32,22 @@ typedef struct {
 
 #define BH_DIRTY    1U
 #define BH_LOCKED   2U
-  unsigned bh_flags;                 ///< BH_DIRTY or BH_LOCKED
+#define BH_LAZY     4U               ///< data can be rebuilt from mf_src
+#define BH_COMPRESSED 8U             ///< bh_data is compressed
+  unsigned bh_flags;                 ///< BH_DIRTY, BH_LOCKED, BH_LAZY or BH_COMPRESSED
+  uint32_t bh_tick;                  ///< mf_tick when the block was last used
+  size_t bh_csize;                   ///< BH_COMPRESSED: number of bytes in bh_data
+
+  size_t bh_src_off;                 ///< BH_LAZY: offset of the text in mf_src
+  size_t bh_src_len;                 ///< BH_LAZY: number of bytes of text
+  unsigned bh_src_count;             ///< BH_LAZY: number of lines in the text
 } bhdr_T;
 
+/// Builds the data of lazy block "hp" from "len" bytes of text at "src",
+/// holding "count" lines.  "src" is NULL when the text is no longer available.
+typedef void (*mf_fill_T)(bhdr_T *hp, const char *src, size_t len, unsigned count,
+                          unsigned page_size);
+
 typedef enum {
   MF_DIRTY_NO = 0,      ///< no dirty blocks
   MF_DIRTY_YES,         ///< there are dirty blocks
@@ -63,4 +76,24 @@ typedef struct {
   blocknr_T mf_infile_count;         ///< number of pages in the file
   unsigned mf_page_size;             ///< number of bytes in a page
   mfdirty_T mf_dirty;
+  uint32_t mf_tick;                  ///< number of mf_compress_cold() calls
+
+  /// Text of lazy blocks (BH_LAZY): a read-only mapping of the edited file.
+  /// A lazy block only gets data when it is used, and the data of an unchanged
+  /// lazy block can be released again.  See mf_set_source().
+  const char *mf_src;
+  size_t mf_src_size;                ///< number of bytes in mf_src
+  int mf_src_fd;                     ///< file descriptor mf_src was mapped from
+  mf_fill_T mf_src_fill;             ///< builds the data of a lazy block
+  bool mf_src_lost;                  ///< the file was truncated, text is lost
+
+  /// Recently loaded lazy blocks, used as a ring.  The oldest entry is
+  /// released when a new one is added.
+  blocknr_T *mf_src_loaded;
+  size_t mf_src_next;                ///< index of the oldest entry
+
+  /// Writes of this memfile queued for the swap writer thread, see
+  /// mf_write().  Only used with the lock of the writer held.
+  int mf_pending;                    ///< number of writes not done yet
+  bool mf_write_failed;              ///< a write failed since the last check
 } memfile_T;
@@ -116,6 +116,14 @@ typedef struct {
   int pe_page_count;            // number of pages in block pe_bnum
 } PointerEntry;
 
+// Lazy blocks created for the text of a mapped file, see ml_add_lazy().
+typedef struct {
+  kvec_t(PointerEntry) entries;  // entry for each block
+  kvec_t(chunksize_T) chunks;    // chunks with the size of the lines
+  chunksize_T chunk;             // chunk that is not full yet
+  linenr_T illegal_byte;         // line nr with the first illegal byte
+} LazyBlocks;
+
 // A pointer block contains a list of branches in the tree.
 typedef struct {
   uint16_t pb_id;               // ID for pointer block: PTR_ID
@@ -225,6 +233,10 @@ typedef struct {
 
 #define STACK_INCR      5       // nr of entries added to ml_stack at a time
 
+#define ML_LAZY_PAGES   8       // nr of pages of a data block of a mapped file
+
+#define ML_APPEND_BULK_MIN 16   // ml_append_lines() appends fewer lines one by one
+
 // The line number where the first mark may be is remembered.
 // If it is 0 there are no marks at all.
 // (always used for the current buffer only, no buffer change possible while
@@ -293,10 +305,13 @@ int ml_open(buf_T *buf)
   buf->b_ml.ml_stack = NULL;    // no stack yet
   buf->b_ml.ml_stack_top = 0;   // nothing in the stack
   buf->b_ml.ml_locked = NULL;   // no cached block
+  ml_cache_clear(buf);
   buf->b_ml.ml_line_lnum = 0;   // no cached line
   buf->b_ml.ml_line_offset = 0;
   buf->b_ml.ml_chunksize = NULL;
   buf->b_ml.ml_usedchunks = 0;
+  buf->b_ml.ml_chunktree = NULL;
+  buf->b_ml.ml_chunktree_len = -1;
 
   if (cmdmod.cmod_flags & CMOD_NOSWAPFILE) {
     buf->b_p_swf = false;
@@ -438,6 +453,7 @@ void ml_setname(buf_T *buf)
     }
     // need to close the swapfile before renaming
     if (mfp->mf_fd >= 0) {
+      mf_wait(mfp);
       close(mfp->mf_fd);
       mfp->mf_fd = -1;
     }
@@ -491,6 +507,12 @@ void ml_open_file(buf_T *buf)
     return;  // nothing to do
   }
 
+  // The text of a mapped file is not in the memfile, a swap file could not
+  // be used to recover it.  See 'largefilesize'.
+  if (mfp->mf_src != NULL) {
+    return;
+  }
+
   // For a spell buffer use a temp file name.
   if (buf->b_spell) {
     char *fname = vim_tempname();
@@ -579,6 +601,8 @@ void ml_close(buf_T *buf, int del_file)
   }
   xfree(buf->b_ml.ml_stack);
   XFREE_CLEAR(buf->b_ml.ml_chunksize);
+  XFREE_CLEAR(buf->b_ml.ml_chunktree);
+  buf->b_ml.ml_chunktree_len = -1;
   buf->b_ml.ml_mfp = NULL;
 
   // Reset the "recovered" flag, give the ATTENTION prompt the next time
@@ -834,6 +858,7 @@ void ml_recover(bool checkext)
   buf->b_ml.ml_line_lnum = 0;           // no cached line
   buf->b_ml.ml_line_offset = 0;
   buf->b_ml.ml_locked = NULL;           // no locked block
+  ml_cache_clear(buf);
   buf->b_ml.ml_flags = 0;
 
   // open the memfile from the old swapfile
@@ -1695,8 +1720,12 @@ static int recov_file_names(char **names, char *path, bool prepend_dot)
 void ml_sync_all(int check_file, int check_char, bool do_fsync)
 {
   FOR_ALL_BUFFERS(buf) {
-    if (buf->b_ml.ml_mfp == NULL || buf->b_ml.ml_mfp->mf_fname == NULL) {
-      continue;                             // no file
+    if (buf->b_ml.ml_mfp == NULL) {
+      continue;
+    }
+    if (buf->b_ml.ml_mfp->mf_fname == NULL) {  // no file
+      mf_compress_cold(buf->b_ml.ml_mfp, (int)p_mcp);
+      continue;
     }
     ml_flush_line(buf, false);              // flush buffered line
                                             // flush locked block
@@ -1716,7 +1745,9 @@ void ml_sync_all(int check_file, int check_char, bool do_fsync)
       }
     }
     if (buf->b_ml.ml_mfp->mf_dirty == MF_DIRTY_YES) {
-      mf_sync(buf->b_ml.ml_mfp, (check_char ? MFS_STOP : 0)
+      // When syncing while waiting for a character, leave the writing to the
+      // writer thread.
+      mf_sync(buf->b_ml.ml_mfp, (check_char ? MFS_STOP | MFS_ASYNC : 0)
               | (do_fsync && bufIsChanged(buf) ? MFS_FLUSH : 0));
       if (check_char && os_char_avail()) {      // character available now
         break;
@@ -1755,6 +1786,7 @@ void ml_preserve(buf_T *buf, bool message, bool do_fsync)
 
   // stack is invalid after mf_sync(.., MFS_ALL)
   buf->b_ml.ml_stack_top = 0;
+  ml_cache_clear(buf);
 
   // Some of the data blocks may have been changed from negative to
   // positive block number. In that case the pointer blocks need to be
@@ -1783,6 +1815,7 @@ void ml_preserve(buf_T *buf, bool message, bool do_fsync)
       status = FAIL;
     }
     buf->b_ml.ml_stack_top = 0;  // stack is invalid now
+    ml_cache_clear(buf);
   }
 theend:
   got_int |= got_int_save;
@@ -2024,6 +2057,282 @@ int ml_append_buf(buf_T *buf, linenr_T lnum, char *line, colnr_T len, bool newfi
   return ml_append_int(buf, lnum, line, len, newfile, false);
 }
 
+/// Append "count" lines after line "lnum" of "buf".  Like calling
+/// ml_append_buf() for every line, but for many lines this is much faster:
+/// the lines fill new data blocks one after another, which are added to the
+/// pointer blocks at once, splitting them bottom-up where needed.
+///
+/// @param lnum     append after this line (can be 0)
+/// @param lines    text of the new lines
+/// @param lens     length of each line, including NUL, or NULL
+/// @param count    number of lines
+/// @param newfile  flag, see ml_append()
+///
+/// @return  FAIL for failure, OK otherwise
+int ml_append_lines(buf_T *buf, linenr_T lnum, char *const *lines, const colnr_T *lens,
+                    linenr_T count, bool newfile)
+  FUNC_ATTR_NONNULL_ARG(1, 3)
+{
+  if (buf->b_ml.ml_mfp == NULL || lnum > buf->b_ml.ml_line_count) {
+    return FAIL;
+  }
+
+  if (buf->b_ml.ml_line_lnum != 0) {
+    ml_flush_line(buf, false);
+  }
+
+  if (count < ML_APPEND_BULK_MIN) {
+    for (linenr_T i = 0; i < count; i++) {
+      if (ml_append_int(buf, lnum + i, lines[i], lens == NULL ? 0 : lens[i], newfile,
+                        false) == FAIL) {
+        return FAIL;
+      }
+    }
+    return OK;
+  }
+
+  if (lowest_marked && lowest_marked > lnum) {
+    lowest_marked = lnum + 1;
+  }
+
+  memfile_T *mfp = buf->b_ml.ml_mfp;
+
+  // Find the data block with line "lnum", this also fills the stack.  Flush
+  // first: a locked block may have line counts to update in pointer blocks.
+  ml_find_line(buf, 0, ML_FLUSH);
+  bhdr_T *hp = ml_find_line(buf, lnum == 0 ? 1 : lnum, ML_FIND);
+  if (hp == NULL || buf->b_ml.ml_stack_top == 0) {
+    return FAIL;
+  }
+  linenr_T db_count = buf->b_ml.ml_locked_high - buf->b_ml.ml_locked_low + 1;
+  // number of lines that stay in the block before the new lines
+  linenr_T split = lnum == 0 ? 0 : lnum - buf->b_ml.ml_locked_low + 1;
+
+  kvec_t(PointerEntry) added = KV_INITIAL_VALUE;
+  PointerEntry moved = { .pe_bnum = 0 };
+
+  // Move the lines after "lnum" to a new block.
+  if (split > 0 && split < db_count) {
+    DataBlock *dp = hp->bh_data;
+    unsigned data_moved = (dp->db_index[split - 1] & DB_INDEX_MASK) - dp->db_txt_start;
+    unsigned total_moved = data_moved + (unsigned)(db_count - split) * (unsigned)INDEX_SIZE;
+    int page_count = (int)((total_moved + HEADER_SIZE + mfp->mf_page_size - 1)
+                           / mfp->mf_page_size);
+    bhdr_T *hp_new = ml_new_data(mfp, newfile, page_count);
+    DataBlock *dp_new = hp_new->bh_data;
+    dp_new->db_txt_start -= data_moved;
+    dp_new->db_free -= total_moved;
+    memmove((char *)dp_new + dp_new->db_txt_start, (char *)dp + dp->db_txt_start,
+            (size_t)data_moved);
+    unsigned offset = dp_new->db_txt_start - dp->db_txt_start;
+    for (linenr_T i = 0; i < db_count - split; i++) {
+      dp_new->db_index[i] = dp->db_index[split + i] + offset;
+    }
+    dp_new->db_line_count = db_count - split;
+    dp->db_txt_start += data_moved;
+    dp->db_free += total_moved;
+    dp->db_line_count = split;
+
+    // Like ml_append_int(): when not reading a new file the block must be
+    // in the swap file, for recovery.  This may change its number.
+    mf_put(mfp, hp_new, true, !newfile);
+    moved = (PointerEntry){
+      .pe_bnum = hp_new->bh_bnum,
+      .pe_line_count = db_count - split,
+      .pe_old_lnum = lnum + count + 1,
+      .pe_page_count = page_count,
+    };
+
+    buf->b_ml.ml_flags |= ML_LOCKED_DIRTY;
+    if (!newfile) {
+      buf->b_ml.ml_flags |= ML_LOCKED_POS;
+    }
+  }
+  ml_find_line(buf, 0, ML_FLUSH);
+
+  // Fill new data blocks with the lines.
+  int total_size = 0;
+  linenr_T i = 0;
+  unsigned len = (unsigned)(lens == NULL ? (colnr_T)strlen(lines[0]) + 1 : lens[0]);
+  while (i < count) {
+    linenr_T first = i;
+    int page_count = (int)((HEADER_SIZE + INDEX_SIZE + len + mfp->mf_page_size - 1)
+                           / mfp->mf_page_size);
+    bhdr_T *hp_new = ml_new_data(mfp, newfile, page_count);
+    DataBlock *dp_new = hp_new->bh_data;
+    do {
+      dp_new->db_txt_start -= len;
+      dp_new->db_free -= len + (unsigned)INDEX_SIZE;
+      dp_new->db_index[dp_new->db_line_count++] = dp_new->db_txt_start;
+      memmove((char *)dp_new + dp_new->db_txt_start, lines[i], (size_t)len);
+      total_size += (int)len;
+      if (++i < count) {
+        len = (unsigned)(lens == NULL ? (colnr_T)strlen(lines[i]) + 1 : lens[i]);
+      }
+    } while (i < count && len + INDEX_SIZE <= dp_new->db_free);
+
+    mf_put(mfp, hp_new, true, !newfile);
+    kv_push(added, ((PointerEntry){
+      .pe_bnum = hp_new->bh_bnum,
+      .pe_line_count = i - first,
+      .pe_old_lnum = lnum + first + 1,
+      .pe_page_count = page_count,
+    }));
+  }
+
+  int retval = ml_insert_blocks(buf, split, added.items, kv_size(added), moved, count);
+  if (retval == OK) {
+    ml_updatechunk_lines(buf, lnum, count, total_size);
+  }
+  kv_destroy(added);
+  return retval;
+}
+
+/// Replace the entry of the data block found with ml_find_line() in its
+/// pointer block with the entries of the blocks "added", then go up the stack
+/// while pointer blocks need to be split.  Used after "count" lines were
+/// added in new blocks.
+///
+/// @param split  number of lines that stay in the old data block, before the
+///               new blocks
+/// @param moved  block with the lines after the new blocks, or pe_bnum is zero
+///
+/// @return  FAIL for failure, OK otherwise
+static int ml_insert_blocks(buf_T *buf, linenr_T split, const PointerEntry *added,
+                            size_t added_count, PointerEntry moved, linenr_T count)
+{
+  memfile_T *mfp = buf->b_ml.ml_mfp;
+  kvec_t(PointerEntry) repl = KV_INITIAL_VALUE, all = KV_INITIAL_VALUE;
+  int retval = FAIL;
+  for (int top = buf->b_ml.ml_stack_top - 1; top >= 0; top--) {
+    infoptr_T *ip = &buf->b_ml.ml_stack[top];
+    int idx = ip->ip_index;
+    bhdr_T *hp = mf_get(mfp, ip->ip_bnum, 1);
+    if (hp == NULL) {
+      goto theend;
+    }
+    PointerBlock *pp = hp->bh_data;
+    if (pp->pb_id != PTR_ID) {
+      iemsg(_(e_pointer_block_id_wrong_three));
+      mf_put(mfp, hp, false, false);
+      goto theend;
+    }
+
+    if (top == buf->b_ml.ml_stack_top - 1) {
+      PointerEntry old = pp->pb_pointer[idx];
+      if (split > 0) {
+        old.pe_line_count = split;
+        kv_push(repl, old);
+      }
+      for (size_t j = 0; j < added_count; j++) {
+        kv_push(repl, added[j]);
+      }
+      if (moved.pe_bnum != 0) {
+        kv_push(repl, moved);
+      } else if (split == 0) {
+        kv_push(repl, old);
+      }
+    }
+
+    size_t total = pp->pb_count - 1 + kv_size(repl);
+    if (total <= pp->pb_count_max) {
+      memmove(&pp->pb_pointer[(size_t)idx + kv_size(repl)], &pp->pb_pointer[idx + 1],
+              (size_t)(pp->pb_count - idx - 1) * sizeof(PointerEntry));
+      memmove(&pp->pb_pointer[idx], repl.items, kv_size(repl) * sizeof(PointerEntry));
+      pp->pb_count = (uint16_t)total;
+      mf_put(mfp, hp, true, false);
+
+      // The blocks above only get more lines.
+      while (--top >= 0) {
+        ip = &buf->b_ml.ml_stack[top];
+        if ((hp = mf_get(mfp, ip->ip_bnum, 1)) == NULL) {
+          goto theend;
+        }
+        pp = hp->bh_data;
+        pp->pb_pointer[ip->ip_index].pe_line_count += count;
+        mf_put(mfp, hp, true, false);
+      }
+      break;
+    }
+
+    // Too many entries for this block.
+    kv_size(all) = 0;
+    for (int j = 0; j < idx; j++) {
+      kv_push(all, pp->pb_pointer[j]);
+    }
+    for (size_t j = 0; j < kv_size(repl); j++) {
+      kv_push(all, kv_A(repl, j));
+    }
+    for (int j = idx + 1; j < (int)pp->pb_count; j++) {
+      kv_push(all, pp->pb_pointer[j]);
+    }
+
+    if (top == 0) {
+      // Block 1 must stay the root: add levels below it.
+      while (kv_size(all) > pp->pb_count_max) {
+        kv_size(all) = ml_add_ptr_level(mfp, all.items, kv_size(all));
+      }
+      memmove(pp->pb_pointer, all.items, kv_size(all) * sizeof(PointerEntry));
+      pp->pb_count = (uint16_t)kv_size(all);
+      mf_put(mfp, hp, true, false);
+      break;
+    }
+
+    // Replace this block with new ones in the block above.
+    mf_free(mfp, hp);
+    kv_size(all) = ml_add_ptr_level(mfp, all.items, kv_size(all));
+    kv_size(repl) = 0;
+    for (size_t j = 0; j < kv_size(all); j++) {
+      kv_push(repl, kv_A(all, j));
+    }
+  }
+  retval = OK;
+
+  buf->b_ml.ml_line_count += count;
+  buf->b_ml.ml_flags &= ~ML_EMPTY;
+
+theend:
+  // The stack no longer matches the tree.
+  buf->b_ml.ml_stack_top = 0;
+  ml_cache_clear(buf);
+  kv_destroy(repl);
+  kv_destroy(all);
+  return retval;
+}
+
+/// Put "count" pointer entries in new pointer blocks, divided evenly, and
+/// replace them with the entries of the new blocks.  Used to build a level of
+/// the tree bottom-up.
+///
+/// @return  number of entries for the new blocks
+static size_t ml_add_ptr_level(memfile_T *mfp, PointerEntry *entries, size_t count)
+{
+  size_t pb_count_max = PB_COUNT_MAX(mfp);
+  size_t nblocks = (count + pb_count_max - 1) / pb_count_max;
+  for (size_t b = 0; b < nblocks; b++) {
+    size_t from = count * b / nblocks;
+    size_t to = count * (b + 1) / nblocks;
+    bhdr_T *hp = ml_new_ptr(mfp);
+    PointerBlock *pp = hp->bh_data;
+    memmove(pp->pb_pointer, &entries[from], (to - from) * sizeof(PointerEntry));
+    pp->pb_count = (uint16_t)(to - from);
+    linenr_T line_count = 0;
+    for (size_t j = from; j < to; j++) {
+      line_count += entries[j].pe_line_count;
+    }
+    // "b" is never more than "from", entries that are still needed are not
+    // overwritten.
+    entries[b] = (PointerEntry){
+      .pe_bnum = hp->bh_bnum,
+      .pe_line_count = line_count,
+      .pe_old_lnum = pp->pb_pointer[0].pe_old_lnum,
+      .pe_page_count = 1,
+    };
+    mf_put(mfp, hp, true, false);
+  }
+  return nblocks;
+}
+
 /// @param lnum  append after this line (can be 0)
 /// @param line  text of the new line
 /// @param len  length of line, including NUL, or 0
@@ -2903,6 +3212,11 @@ static bhdr_T *ml_find_line(buf_T *buf, linenr_T lnum, int action)
 
   memfile_T *mfp = buf->b_ml.ml_mfp;
 
+  // Inserting or deleting a line changes the line numbers of cached blocks.
+  if (action == ML_INSERT || action == ML_DELETE) {
+    ml_cache_clear(buf);
+  }
+
   // If there is a locked block check if the wanted line is in it.
   // If not, flush and release the locked block.
   // Don't do this for ML_INSERT_SAME, because the stack need to be updated.
@@ -2938,6 +3252,14 @@ static bhdr_T *ml_find_line(buf_T *buf, linenr_T lnum, int action)
     return NULL;
   }
 
+  if (action == ML_FIND) {
+    if ((hp = ml_cache_find(buf, lnum)) != NULL) {
+      g_stats.ml_cache_hit++;
+      return hp;
+    }
+    g_stats.ml_cache_miss++;
+  }
+
   blocknr_T bnum = 1;                         // start at the root of the tree
   blocknr_T bnum2;
   int page_count = 1;
@@ -2981,6 +3303,9 @@ static bhdr_T *ml_find_line(buf_T *buf, linenr_T lnum, int action)
       buf->b_ml.ml_locked_high = high;
       buf->b_ml.ml_locked_lineadd = 0;
       buf->b_ml.ml_flags &= ~(ML_LOCKED_DIRTY | ML_LOCKED_POS);
+      if (action == ML_FIND) {
+        ml_cache_add(buf, bnum, page_count);
+      }
       return hp;
     }
 
@@ -3056,6 +3381,79 @@ error_noblock:
   return NULL;
 }
 
+/// Forget the data blocks remembered by ml_find_line().  Must be called when
+/// line numbers or the tree of blocks change.
+static void ml_cache_clear(buf_T *buf)
+{
+  for (int i = 0; i < ML_CACHE_SIZE; i++) {
+    buf->b_ml.ml_cache[i].mc_bnum = 0;
+  }
+}
+
+/// Remember data block "bnum", just locked by ml_find_line(), and the stack of
+/// pointer blocks leading to it.
+static void ml_cache_add(buf_T *buf, blocknr_T bnum, int page_count)
+{
+  if (buf->b_ml.ml_stack_top > ML_CACHE_DEPTH) {
+    return;
+  }
+
+  // Drop the least recently used entry.
+  memmove(buf->b_ml.ml_cache + 1, buf->b_ml.ml_cache,
+          (ML_CACHE_SIZE - 1) * sizeof(mlcache_T));
+  mlcache_T *mc = &buf->b_ml.ml_cache[0];
+  mc->mc_bnum = bnum;
+  mc->mc_page_count = page_count;
+  mc->mc_low = buf->b_ml.ml_locked_low;
+  mc->mc_high = buf->b_ml.ml_locked_high;
+  mc->mc_stack_top = buf->b_ml.ml_stack_top;
+  memcpy(mc->mc_stack, buf->b_ml.ml_stack, (size_t)mc->mc_stack_top * sizeof(infoptr_T));
+}
+
+/// Lock a remembered data block with line "lnum" and restore the stack of
+/// pointer blocks leading to it, like ml_find_line() does.
+///
+/// @return  the block or NULL when "lnum" is not in a remembered block.
+static bhdr_T *ml_cache_find(buf_T *buf, linenr_T lnum)
+{
+  for (int i = 0; i < ML_CACHE_SIZE; i++) {
+    mlcache_T *mc = &buf->b_ml.ml_cache[i];
+    if (mc->mc_bnum == 0 || lnum < mc->mc_low || lnum > mc->mc_high) {
+      continue;
+    }
+
+    // A negative block number may have been translated, then it is not
+    // found and the tree must be walked to update the pointer block.
+    bhdr_T *hp = mf_get(buf->b_ml.ml_mfp, mc->mc_bnum, (unsigned)mc->mc_page_count);
+    if (hp == NULL || ((DataBlock *)hp->bh_data)->db_id != DATA_ID) {
+      if (hp != NULL) {
+        mf_put(buf->b_ml.ml_mfp, hp, false, false);
+      }
+      ml_cache_clear(buf);
+      return NULL;
+    }
+
+    mlcache_T found = *mc;
+    if (i > 0) {
+      memmove(buf->b_ml.ml_cache + 1, buf->b_ml.ml_cache, (size_t)i * sizeof(mlcache_T));
+      buf->b_ml.ml_cache[0] = found;
+    }
+
+    buf->b_ml.ml_stack_top = 0;
+    for (int j = 0; j < found.mc_stack_top; j++) {
+      int top = ml_add_stack(buf);
+      buf->b_ml.ml_stack[top] = found.mc_stack[j];
+    }
+    buf->b_ml.ml_locked = hp;
+    buf->b_ml.ml_locked_low = found.mc_low;
+    buf->b_ml.ml_locked_high = found.mc_high;
+    buf->b_ml.ml_locked_lineadd = 0;
+    buf->b_ml.ml_flags &= ~(ML_LOCKED_DIRTY | ML_LOCKED_POS);
+    return hp;
+  }
+  return NULL;
+}
+
 /// add an entry to the info pointer stack
 ///
 /// @return  number of the new entry
@@ -3737,6 +4135,90 @@ enum {
   MLCS_MINL = 400,  // should be half of MLCS_MAXL
 };
 
+// Buffer of the last line added by ml_updatechunk(), NULL to force searching
+// the chunk of the next added line.
+static buf_T *ml_upd_lastbuf = NULL;
+
+/// Make the Fenwick tree over the chunks of "buf" valid.  This takes O(n) time
+/// and is only needed after chunks were split, joined or reset.
+static void ml_chunktree_build(buf_T *buf)
+{
+  int n = buf->b_ml.ml_usedchunks;
+  if (buf->b_ml.ml_chunktree_len == n) {
+    return;
+  }
+
+  chunksize_T *tree = xrealloc(buf->b_ml.ml_chunktree, sizeof(chunksize_T) * (size_t)(n + 1));
+  tree[0] = (chunksize_T){ 0, 0 };  // not used
+  memmove(tree + 1, buf->b_ml.ml_chunksize, sizeof(chunksize_T) * (size_t)n);
+  for (int i = 1; i <= n; i++) {
+    int parent = i + (i & -i);
+    if (parent <= n) {
+      tree[parent].mlcs_numlines += tree[i].mlcs_numlines;
+      tree[parent].mlcs_totalsize += tree[i].mlcs_totalsize;
+    }
+  }
+  buf->b_ml.ml_chunktree = tree;
+  buf->b_ml.ml_chunktree_len = n;
+}
+
+/// Add "lines" and "bytes" to chunk "curix" in the Fenwick tree.  Does nothing
+/// when the tree is not valid, it is rebuilt when it's used.
+static void ml_chunktree_add(buf_T *buf, int curix, int lines, int bytes)
+{
+  int n = buf->b_ml.ml_chunktree_len;
+  if (n != buf->b_ml.ml_usedchunks) {
+    return;
+  }
+  for (int i = curix + 1; i <= n; i += i & -i) {
+    buf->b_ml.ml_chunktree[i].mlcs_numlines += lines;
+    buf->b_ml.ml_chunktree[i].mlcs_totalsize += bytes;
+  }
+}
+
+/// Find the chunk that contains line "lnum" or byte "offset" (when not zero).
+/// The last chunk is returned for anything beyond it.
+///
+/// @param ffdos   add one byte per line to "offset" for the CR
+/// @param linep   set to the first line of the chunk
+/// @param sizep   set to the number of bytes before the chunk, without CRs
+///
+/// @return  index of the chunk
+static int ml_chunktree_find(buf_T *buf, linenr_T lnum, int offset, int ffdos, linenr_T *linep,
+                             int *sizep)
+{
+  ml_chunktree_build(buf);
+  const chunksize_T *tree = buf->b_ml.ml_chunktree;
+  int limit = buf->b_ml.ml_usedchunks - 1;
+  int curix = 0;
+  int lines = 0;
+  int size = 0;
+
+  int step = 1;
+  while (step * 2 <= limit) {
+    step *= 2;
+  }
+  for (; step > 0; step /= 2) {
+    int next = curix + step;
+    if (next > limit) {
+      continue;
+    }
+    int next_lines = lines + tree[next].mlcs_numlines;
+    int next_size = size + tree[next].mlcs_totalsize;
+    // Skip the chunks when the line or offset is beyond them.
+    if ((lnum != 0 && lnum > next_lines)
+        || (offset != 0 && offset > next_size + ffdos * next_lines)) {
+      curix = next;
+      lines = next_lines;
+      size = next_size;
+    }
+  }
+
+  *linep = lines + 1;
+  *sizep = size;
+  return curix;
+}
+
 /// Keep information for finding byte offset of a line
 ///
 /// @param updtype  may be one of:
@@ -3746,7 +4228,6 @@ enum {
 ///                 ML_CHNK_UPDLINE: Add len to parent chunk, as a signed entity.
 static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
 {
-  static buf_T *ml_upd_lastbuf = NULL;
   static linenr_T ml_upd_lastline;
   static linenr_T ml_upd_lastcurline;
   static int ml_upd_lastcurix;
@@ -3764,6 +4245,7 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
     buf->b_ml.ml_usedchunks = 1;
     buf->b_ml.ml_chunksize[0].mlcs_numlines = 1;
     buf->b_ml.ml_chunksize[0].mlcs_totalsize = 1;
+    buf->b_ml.ml_chunktree_len = -1;
   }
 
   if (updtype == ML_CHNK_UPDLINE && buf->b_ml.ml_line_count == 1) {
@@ -3771,6 +4253,7 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
     buf->b_ml.ml_usedchunks = 1;
     buf->b_ml.ml_chunksize[0].mlcs_numlines = 1;
     buf->b_ml.ml_chunksize[0].mlcs_totalsize = buf->b_ml.ml_line_len;
+    buf->b_ml.ml_chunktree_len = -1;
     return;
   }
 
@@ -3778,13 +4261,8 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
   // chunk.
   if (buf != ml_upd_lastbuf || line != ml_upd_lastline + 1
       || updtype != ML_CHNK_ADDLINE) {
-    for (curline = 1, curix = 0;
-         curix < buf->b_ml.ml_usedchunks - 1
-         && line >= curline +
-         buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-         curix++) {
-      curline += buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-    }
+    int size;
+    curix = ml_chunktree_find(buf, line, 0, 0, &curline, &size);
   } else if (curix < buf->b_ml.ml_usedchunks - 1
              && line >= curline + buf->b_ml.ml_chunksize[curix].mlcs_numlines) {
     // Adjust cached curix & curline
@@ -3797,10 +4275,12 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
     len = -len;
   }
   curchnk->mlcs_totalsize += len;
+  ml_chunktree_add(buf, curix, 0, len);
   if (updtype == ML_CHNK_ADDLINE) {
     int rest;
     DataBlock *dp;
     curchnk->mlcs_numlines++;
+    ml_chunktree_add(buf, curix, 1, 0);
 
     // May resize here so we don't have to do it in both cases below
     if (buf->b_ml.ml_usedchunks + 1 >= buf->b_ml.ml_numchunks) {
@@ -3850,6 +4330,7 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
       buf->b_ml.ml_chunksize[curix].mlcs_totalsize = size;
       buf->b_ml.ml_chunksize[curix + 1].mlcs_totalsize -= size;
       buf->b_ml.ml_usedchunks++;
+      buf->b_ml.ml_chunktree_len = -1;
       ml_upd_lastbuf = NULL;         // Force recalc of curix & curline
       return;
     } else if (buf->b_ml.ml_chunksize[curix].mlcs_numlines >= MLCS_MINL
@@ -3859,6 +4340,7 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
       // after this. Do it now to avoid the loop above later on
       curchnk = buf->b_ml.ml_chunksize + curix + 1;
       buf->b_ml.ml_usedchunks++;
+      buf->b_ml.ml_chunktree_len = -1;
       if (line == buf->b_ml.ml_line_count) {
         curchnk->mlcs_numlines = 0;
         curchnk->mlcs_totalsize = 0;
@@ -3885,6 +4367,7 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
     }
   } else if (updtype == ML_CHNK_DELLINE) {
     curchnk->mlcs_numlines--;
+    ml_chunktree_add(buf, curix, -1, 0);
     ml_upd_lastbuf = NULL;       // Force recalc of curix & curline
     if (curix < (buf->b_ml.ml_usedchunks - 1)
         && (curchnk->mlcs_numlines + curchnk[1].mlcs_numlines)
@@ -3893,6 +4376,7 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
       curchnk = buf->b_ml.ml_chunksize + curix;
     } else if (curix == 0 && curchnk->mlcs_numlines <= 0) {
       buf->b_ml.ml_usedchunks--;
+      buf->b_ml.ml_chunktree_len = -1;
       memmove(buf->b_ml.ml_chunksize, buf->b_ml.ml_chunksize + 1,
               (size_t)buf->b_ml.ml_usedchunks * sizeof(chunksize_T));
       return;
@@ -3907,6 +4391,7 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
     curchnk[-1].mlcs_numlines += curchnk->mlcs_numlines;
     curchnk[-1].mlcs_totalsize += curchnk->mlcs_totalsize;
     buf->b_ml.ml_usedchunks--;
+    buf->b_ml.ml_chunktree_len = -1;
     if (curix < buf->b_ml.ml_usedchunks) {
       memmove(buf->b_ml.ml_chunksize + curix,
               buf->b_ml.ml_chunksize + curix + 1,
@@ -3920,6 +4405,62 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
   ml_upd_lastcurix = curix;
 }
 
+/// Like ml_updatechunk() with ML_CHNK_ADDLINE, for "count" lines with "size"
+/// bytes that ml_append_lines() added after line "lnum".  The memline must
+/// already contain the lines.
+static void ml_updatechunk_lines(buf_T *buf, linenr_T lnum, linenr_T count, int size)
+{
+  if (buf->b_ml.ml_usedchunks == -1) {
+    return;
+  }
+  if (buf->b_ml.ml_chunksize == NULL) {
+    buf->b_ml.ml_chunksize = xmalloc(sizeof(chunksize_T) * 100);
+    buf->b_ml.ml_numchunks = 100;
+    buf->b_ml.ml_usedchunks = 1;
+    buf->b_ml.ml_chunksize[0].mlcs_numlines = 1;
+    buf->b_ml.ml_chunksize[0].mlcs_totalsize = 1;
+  }
+  ml_upd_lastbuf = NULL;         // Force recalc of curix & curline
+
+  linenr_T curline;
+  int before;
+  int curix = ml_chunktree_find(buf, lnum + 1, 0, 0, &curline, &before);
+  chunksize_T *curchnk = buf->b_ml.ml_chunksize + curix;
+  curchnk->mlcs_numlines += count;
+  curchnk->mlcs_totalsize += size;
+  buf->b_ml.ml_chunktree_len = -1;
+  if (curchnk->mlcs_numlines < MLCS_MAXL) {
+    return;
+  }
+
+  // Split the chunk into chunks of MLCS_MINL lines, the last one gets the
+  // rest and has less than MLCS_MAXL lines.
+  int numlines = curchnk->mlcs_numlines;
+  int totalsize = curchnk->mlcs_totalsize;
+  int pieces = numlines / MLCS_MINL;
+  while (buf->b_ml.ml_usedchunks + pieces >= buf->b_ml.ml_numchunks) {
+    buf->b_ml.ml_numchunks = buf->b_ml.ml_numchunks * 3 / 2;
+  }
+  buf->b_ml.ml_chunksize = xrealloc(buf->b_ml.ml_chunksize,
+                                    sizeof(chunksize_T) * (size_t)buf->b_ml.ml_numchunks);
+  memmove(buf->b_ml.ml_chunksize + curix + pieces, buf->b_ml.ml_chunksize + curix + 1,
+          (size_t)(buf->b_ml.ml_usedchunks - curix - 1) * sizeof(chunksize_T));
+  buf->b_ml.ml_usedchunks += pieces - 1;
+
+  for (int i = 0; i < pieces - 1; i++) {
+    int piece_size = 0;
+    for (int j = 0; j < MLCS_MINL; j++) {
+      piece_size += ml_get_buf_len(buf, curline++) + 1;
+    }
+    buf->b_ml.ml_chunksize[curix + i].mlcs_numlines = MLCS_MINL;
+    buf->b_ml.ml_chunksize[curix + i].mlcs_totalsize = piece_size;
+    numlines -= MLCS_MINL;
+    totalsize -= piece_size;
+  }
+  buf->b_ml.ml_chunksize[curix + pieces - 1].mlcs_numlines = numlines;
+  buf->b_ml.ml_chunksize[curix + pieces - 1].mlcs_totalsize = totalsize;
+}
+
 /// Find offset for line or line with offset.
 ///
 /// @param buf buffer to use
@@ -3974,24 +4515,13 @@ int ml_find_line_or_offset(buf_T *buf, linenr_T lnum, int *offp, bool no_ff)
   if (lnum == 0 && offset <= 0) {
     return 1;       // Not a "find offset" and offset 0 _must_ be in line 1
   }
-  // Find the last chunk before the one containing our line. Last chunk is
-  // special because it will never qualify
-  linenr_T curline = 1;
-  int curix = 0;
-  int size = 0;
-  while (curix < buf->b_ml.ml_usedchunks - 1
-         && ((lnum != 0
-              && lnum >= curline + buf->b_ml.ml_chunksize[curix].mlcs_numlines)
-             || (offset != 0
-                 && offset > size +
-                 buf->b_ml.ml_chunksize[curix].mlcs_totalsize
-                 + ffdos * buf->b_ml.ml_chunksize[curix].mlcs_numlines))) {
-    curline += buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-    size += buf->b_ml.ml_chunksize[curix].mlcs_totalsize;
-    if (offset && ffdos) {
-      size += buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-    }
-    curix++;
+  // Find the chunk containing our line. Last chunk is special because it
+  // will never be skipped.
+  linenr_T curline;
+  int size;
+  ml_chunktree_find(buf, lnum, offset, ffdos, &curline, &size);
+  if (offset && ffdos) {
+    size += curline - 1;
   }
 
   while ((lnum != 0 && curline < lnum) || (offset != 0 && size < offset)) {
@@ -4072,6 +4602,319 @@ int ml_find_line_or_offset(buf_T *buf, linenr_T lnum, int *offp, bool no_ff)
   return size;
 }
 
+/// Create lazy blocks for the lines of the mapped text "map[size]" from
+/// offset "*offp", until the blocks hold at least "len" bytes or the end of
+/// the text is reached.  "*offp" is advanced to the end of the last block.
+/// Every block is checked for an illegal byte when it is created.  The pages
+/// of the mapping that were used are released again.
+///
+/// @param lnum  number of the first line
+///
+/// @return  number of lines, -1 when a line is too long to handle.
+static linenr_T ml_add_lazy(memfile_T *mfp, const char *map, size_t size, size_t *offp,
+                            size_t len, linenr_T lnum, bool check_utf8, LazyBlocks *lb)
+{
+  const unsigned page_size = mfp->mf_page_size;
+  const size_t block_size = (size_t)page_size * ML_LAZY_PAGES;
+  const size_t first_entry = kv_size(lb->entries);
+  const char *const first = map + *offp;
+  const char *p = first;
+  const char *const end = map + size;
+  linenr_T next = lnum;             // first line of the next block
+
+  // Find the lines that go in each data block, and the size of each chunk.
+  while (p < end && (size_t)(p - first) < len) {
+    const char *start = p;
+    size_t needed = HEADER_SIZE;    // bytes needed in the data block
+    unsigned count = 0;
+    while (p < end) {
+      const char *eol = memchr(p, NL, (size_t)(end - p));
+      size_t line_len = (size_t)((eol == NULL ? end : eol) - p);
+      if (line_len >= MAXCOL || next + (linenr_T)count >= MAXLNUM - 1) {
+        goto fail;
+      }
+      if (count > 0 && needed + line_len + 1 + INDEX_SIZE > block_size) {
+        break;
+      }
+      needed += line_len + 1 + INDEX_SIZE;
+      count++;
+      p = eol == NULL ? end : eol + 1;
+
+      lb->chunk.mlcs_numlines++;
+      lb->chunk.mlcs_totalsize += (int)line_len + 1;
+      if (lb->chunk.mlcs_numlines == MLCS_MINL) {
+        kv_push(lb->chunks, lb->chunk);
+        lb->chunk = (chunksize_T){ 0, 0 };
+      }
+    }
+
+    if (check_utf8 && lb->illegal_byte == 0) {
+      size_t valid = utf_valid_prefix(start, (size_t)(p - start));
+      if (valid < (size_t)(p - start)) {
+        lb->illegal_byte = next;
+        for (const char *q = start; (q = memchr(q, NL, valid - (size_t)(q - start))) != NULL;
+             q++) {
+          lb->illegal_byte++;
+        }
+      }
+    }
+
+    unsigned page_count = (unsigned)((needed + page_size - 1) / page_size);
+    bhdr_T *hp = mf_new_lazy(mfp, page_count, (size_t)(start - map), (size_t)(p - start), count);
+    kv_push(lb->entries, ((PointerEntry){
+      .pe_bnum = hp->bh_bnum,
+      .pe_line_count = (linenr_T)count,
+      .pe_old_lnum = next,
+      .pe_page_count = (int)page_count,
+    }));
+    next += (linenr_T)count;
+  }
+
+  os_mmap_release(map, *offp, (size_t)(p - first));
+  *offp = (size_t)(p - map);
+  return next - lnum;
+
+fail:
+  os_mmap_release(map, *offp, (size_t)(p - first));
+  ml_free_lazy(mfp, lb, first_entry);
+  return -1;
+}
+
+/// Free the lazy blocks of the entries in "lb" from index "from".
+static void ml_free_lazy(memfile_T *mfp, LazyBlocks *lb, size_t from)
+{
+  for (size_t i = from; i < kv_size(lb->entries); i++) {
+    bhdr_T *hp = pmap_get(int64_t)(&mfp->mf_hash, kv_A(lb->entries, i).pe_bnum);
+    if (hp != NULL && (hp->bh_flags & BH_LAZY)) {
+      mf_free(mfp, hp);
+    }
+  }
+  kv_size(lb->entries) = from;
+}
+
+/// Append the first lines of a file that was mapped into memory to the empty
+/// buffer "buf", see 'largefilesize'.  The text is not copied: every data
+/// block is a lazy block that gets its lines from the mapping when it is
+/// used, see mf_new_lazy().  The pointer blocks are built bottom-up.
+///
+/// Only the blocks for the first "len" bytes are created, the memline needs
+/// to know the number of lines in every block, thus finding them requires
+/// reading the text.  The rest is appended with ml_append_mapped_more().
+///
+/// The caller must have checked that the text does not need to be converted.
+/// On success the memline owns "map" and "fd", and the buffer has no swap
+/// file.
+///
+/// @param map          text of the file, from os_mmap_readonly()
+/// @param size         number of bytes in "map"
+/// @param fd           file descriptor "map" was mapped from
+/// @param check_utf8   the first "len" bytes must be valid UTF-8
+/// @param[out] donep   number of bytes used
+///
+/// @return  number of lines appended, 0 for failure.
+linenr_T ml_append_mapped(buf_T *buf, const char *map, size_t size, int fd, size_t len,
+                          bool check_utf8, size_t *donep)
+  FUNC_ATTR_NONNULL_ALL
+{
+  memfile_T *mfp = buf->b_ml.ml_mfp;
+  if (mfp == NULL || mfp->mf_src != NULL || !(buf->b_ml.ml_flags & ML_EMPTY)
+      || buf->b_ml.ml_line_count != 1 || size == 0) {
+    return 0;
+  }
+
+  ml_flush_line(buf, false);
+
+  // The data block with the empty line goes after the appended lines.  It
+  // must be the only block below the root.
+  bhdr_T *hp = ml_find_line(buf, 1, ML_FIND);
+  if (hp == NULL) {
+    return 0;
+  }
+  PointerEntry last = {
+    .pe_bnum = hp->bh_bnum,
+    .pe_line_count = 1,
+    .pe_page_count = (int)hp->bh_page_count,
+  };
+  ml_find_line(buf, 0, ML_FLUSH);
+  if ((hp = mf_get(mfp, 1, 1)) == NULL) {
+    return 0;
+  }
+  PointerBlock *pp = hp->bh_data;
+  bool only_block = pp->pb_id == PTR_ID && pp->pb_count == 1
+                    && pp->pb_pointer[0].pe_bnum == last.pe_bnum;
+  mf_put(mfp, hp, false, false);
+  if (!only_block) {
+    return 0;
+  }
+
+  LazyBlocks lb = { 0 };
+  size_t off = 0;
+  linenr_T count = ml_add_lazy(mfp, map, size, &off, len, 1, check_utf8, &lb);
+  if (count <= 0 || lb.illegal_byte != 0) {
+    goto fail;                      // cannot handle this, read normally
+  }
+
+  // Unchanged lines only exist in the mapping, they would be missing from
+  // the swap file.  Don't use one, ml_open_file() won't create it again.
+  mf_close_file(buf, true);
+
+  linenr_T lnum = count + 1;        // the empty line
+  last.pe_old_lnum = lnum;
+  kv_push(lb.entries, last);
+  lb.chunk.mlcs_numlines++;
+  lb.chunk.mlcs_totalsize++;
+  kv_push(lb.chunks, lb.chunk);
+
+  // Build the levels of pointer blocks until the entries fit in the root.
+  while (kv_size(lb.entries) > PB_COUNT_MAX(mfp)) {
+    kv_size(lb.entries) = ml_add_ptr_level(mfp, lb.entries.items, kv_size(lb.entries));
+  }
+
+  if ((hp = mf_get(mfp, 1, 1)) == NULL) {
+    goto fail;
+  }
+  pp = hp->bh_data;
+  memmove(pp->pb_pointer, lb.entries.items, kv_size(lb.entries) * sizeof(PointerEntry));
+  pp->pb_count = (uint16_t)kv_size(lb.entries);
+  mf_put(mfp, hp, true, false);
+  buf->b_ml.ml_stack_top = 0;
+  ml_cache_clear(buf);
+
+  buf->b_ml.ml_line_count = lnum;
+  buf->b_ml.ml_flags &= ~ML_EMPTY;
+  mf_set_source(mfp, map, size, fd, ml_fill_lazy);
+
+  xfree(buf->b_ml.ml_chunksize);
+  buf->b_ml.ml_chunksize = lb.chunks.items;
+  buf->b_ml.ml_numchunks = (int)lb.chunks.capacity;
+  buf->b_ml.ml_usedchunks = (int)kv_size(lb.chunks);
+  buf->b_ml.ml_chunktree_len = -1;
+  ml_upd_lastbuf = NULL;
+
+  kv_destroy(lb.entries);
+  *donep = off;
+  return count;
+
+fail:
+  ml_free_lazy(mfp, &lb, 0);
+  kv_destroy(lb.entries);
+  kv_destroy(lb.chunks);
+  return 0;
+}
+
+/// Append more lines of the file mapped with ml_append_mapped() at the end of
+/// "buf": the lines from offset "*offp", until at least "len" bytes were
+/// used.  "*offp" is advanced past the text used.  Invalid UTF-8 is kept as
+/// it is, the line number of the first illegal byte is stored in
+/// "*illegal_byte" when it is zero.
+///
+/// @return  number of lines appended, -1 for failure.
+linenr_T ml_append_mapped_more(buf_T *buf, size_t *offp, size_t len, bool check_utf8,
+                               linenr_T *illegal_byte)
+  FUNC_ATTR_NONNULL_ALL
+{
+  memfile_T *mfp = buf->b_ml.ml_mfp;
+  if (mfp == NULL || mfp->mf_src == NULL || *offp >= mfp->mf_src_size
+      || (buf->b_ml.ml_flags & ML_EMPTY)) {
+    return -1;
+  }
+
+  ml_flush_line(buf, false);
+
+  // Find the last data block, this also fills the stack.  Flush first: a
+  // locked block may have line counts to update in pointer blocks.
+  linenr_T lnum = buf->b_ml.ml_line_count;
+  ml_find_line(buf, 0, ML_FLUSH);
+  if (ml_find_line(buf, lnum, ML_FIND) == NULL || buf->b_ml.ml_stack_top == 0) {
+    return -1;
+  }
+  linenr_T split = buf->b_ml.ml_locked_high - buf->b_ml.ml_locked_low + 1;
+  ml_find_line(buf, 0, ML_FLUSH);
+
+  LazyBlocks lb = { .illegal_byte = *illegal_byte };
+  linenr_T count = ml_add_lazy(mfp, mfp->mf_src, mfp->mf_src_size, offp, len, lnum + 1,
+                               check_utf8, &lb);
+  if (count > 0
+      && ml_insert_blocks(buf, split, lb.entries.items, kv_size(lb.entries),
+                          (PointerEntry){ .pe_bnum = 0 }, count) == FAIL) {
+    ml_free_lazy(mfp, &lb, 0);
+    count = -1;
+  }
+
+  if (count > 0 && buf->b_ml.ml_usedchunks != -1 && buf->b_ml.ml_chunksize != NULL) {
+    // The new chunks go after the last one.
+    if (lb.chunk.mlcs_numlines > 0) {
+      kv_push(lb.chunks, lb.chunk);
+    }
+    int n = (int)kv_size(lb.chunks);
+    if (buf->b_ml.ml_usedchunks + n > buf->b_ml.ml_numchunks) {
+      buf->b_ml.ml_numchunks = (buf->b_ml.ml_usedchunks + n) * 3 / 2;
+      buf->b_ml.ml_chunksize = xrealloc(buf->b_ml.ml_chunksize,
+                                        sizeof(chunksize_T) * (size_t)buf->b_ml.ml_numchunks);
+    }
+    memmove(buf->b_ml.ml_chunksize + buf->b_ml.ml_usedchunks, lb.chunks.items,
+            (size_t)n * sizeof(chunksize_T));
+    buf->b_ml.ml_usedchunks += n;
+    buf->b_ml.ml_chunktree_len = -1;
+    ml_upd_lastbuf = NULL;
+  }
+
+  *illegal_byte = lb.illegal_byte;
+  kv_destroy(lb.entries);
+  kv_destroy(lb.chunks);
+  return count;
+}
+
+/// Build data block "hp" with "count" lines from "len" bytes of text at "src".
+/// Used for the lazy blocks created by ml_append_mapped().
+///
+/// When the file changed since it was mapped the text may not match "count":
+/// missing lines are empty and a line is truncated when the block is full.
+static void ml_fill_lazy(bhdr_T *hp, const char *src, size_t len, unsigned count,
+                         unsigned page_size)
+{
+  DataBlock *dp = hp->bh_data;
+  dp->db_id = DATA_ID;
+  dp->db_txt_start = dp->db_txt_end = hp->bh_page_count * page_size;
+  dp->db_line_count = count;
+
+  // room for the text, every line needs at least its NUL
+  size_t room = dp->db_txt_end - HEADER_SIZE - count * INDEX_SIZE;
+  const char *p = src;
+  const char *const end = src == NULL ? NULL : src + len;
+  for (unsigned i = 0; i < count; i++) {
+    const char *eol = p < end ? memchr(p, NL, (size_t)(end - p)) : NULL;
+    if (eol == NULL) {
+      eol = end;
+    }
+    size_t n = MIN((size_t)(eol - p), room - (count - i));
+    dp->db_txt_start -= (unsigned)n + 1;
+    char *dst = (char *)dp + dp->db_txt_start;
+    if (n > 0) {
+      memcpy(dst, p, n);
+    }
+    dst[n] = NUL;
+    // NULs in the file are stored as NL
+    for (char *q = memchr(dst, NUL, n); q != NULL;
+         q = memchr(q + 1, NUL, (size_t)(dst + n - (q + 1)))) {
+      *q = NL;
+    }
+    dp->db_index[i] = dp->db_txt_start;
+    room -= n + 1;
+    p = eol < end ? eol + 1 : end;
+  }
+  dp->db_free = dp->db_txt_start - (unsigned)HEADER_SIZE - count * (unsigned)INDEX_SIZE;
+}
+
+/// Make the text of "buf" independent of the file it was mapped from by
+/// ml_append_mapped().  Used before the file is overwritten.
+void ml_unmap(buf_T *buf)
+{
+  if (buf->b_ml.ml_mfp != NULL) {
+    mf_drop_source(buf->b_ml.ml_mfp);
+  }
+}
+
 /// Goto byte in buffer with offset 'cnt'.
 void goto_byte(int cnt)
 {
@@ -15,6 +15,21 @@ typedef struct {
   int ip_index;                 // index for block with current lnum
 } infoptr_T;    // block/index pair
 
+#define ML_CACHE_SIZE   4       // nr of data blocks in ml_cache
+#define ML_CACHE_DEPTH  6       // max nr of pointer blocks above a cached block
+
+/// A data block that was recently found by ml_find_line(), with the stack of
+/// pointer blocks leading to it.  Used to avoid walking the tree when readers
+/// alternate between a few places in the buffer.
+typedef struct {
+  blocknr_T mc_bnum;            // block number, 0 if not used
+  int mc_page_count;            // number of pages in the block
+  linenr_T mc_low;              // first line in the block
+  linenr_T mc_high;             // last line in the block
+  int mc_stack_top;             // number of entries in mc_stack
+  infoptr_T mc_stack[ML_CACHE_DEPTH];
+} mlcache_T;
+
 typedef struct {
   int mlcs_numlines;
   int mlcs_totalsize;
@@ -34,6 +49,8 @@ typedef struct {
 ///
 /// Memline also has "chunks" of 800 lines that are separate from the 128-tree
 /// structure, primarily used to speed up line2byte() and byte2line().
+/// A Fenwick tree over the chunks (ml_chunktree) finds the chunk of a line or
+/// byte offset in O(log n) time.
 ///
 /// Motivation: If you have a file that is 10000 lines long, and you insert
 ///             a line at linenr 1000, you don't want to move 9000 lines in
@@ -66,7 +83,12 @@ typedef struct {
   linenr_T ml_locked_low;       // first line in ml_locked
   linenr_T ml_locked_high;      // last line in ml_locked
   int ml_locked_lineadd;        // number of lines inserted in ml_locked
+  mlcache_T ml_cache[ML_CACHE_SIZE];  // recently used data blocks, most
+                                      // recently used first
   chunksize_T *ml_chunksize;
   int ml_numchunks;
   int ml_usedchunks;
+  chunksize_T *ml_chunktree;    // Fenwick tree with sums of ml_chunksize
+  int ml_chunktree_len;         // number of chunks in ml_chunktree, -1 when
+                                // it must be rebuilt
 } memline_T;
@@ -29,6 +29,7 @@
 #include "nvim/main.h"
 #include "nvim/map_defs.h"
 #include "nvim/mapping.h"
+#include "nvim/marktree.h"
 #include "nvim/memfile.h"
 #include "nvim/memory.h"
 #include "nvim/message.h"
@@ -881,6 +882,7 @@ void free_all_mem(void)
   check_quickfix_busy();
 
   decor_free_all_mem();
+  marktree_free_all_mem();
   drawline_free_all_mem();
   input_free_all_mem();
 
@@ -542,6 +542,7 @@ void check_cursor_moved(win_T *wp)
 void changed_window_setting(win_T *wp)
 {
   wp->w_lines_valid = 0;
+  plines_cache_invalidate(wp);
   changed_line_abv_curs_win(wp);
   wp->w_valid &= ~(VALID_BOTLINE|VALID_BOTLINE_AP|VALID_TOPLINE);
   redraw_later(wp, UPD_NOT_VALID);
@@ -6,6 +6,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "klib/kvec.h"
 #include "nvim/api/private/defs.h"
@@ -19,6 +20,7 @@
 #include "nvim/event/multiqueue.h"
 #include "nvim/event/process.h"
 #include "nvim/event/rstream.h"
+#include "nvim/event/shmring.h"
 #include "nvim/event/wstream.h"
 #include "nvim/globals.h"
 #include "nvim/log.h"
@@ -67,6 +69,14 @@ static void log_notify(char *dir, uint64_t channel_id, const char *name)
 # define log_notify(...)
 #endif
 
+/// Size of a shared memory ring, room for several full screen redraws.
+#define RPC_RING_SIZE (1024 * 1024)
+
+/// Sent through the stream of a channel with a shared memory ring, to notify
+/// the other side that the ring has data (or room) now. Never used by msgpack,
+/// thus it cannot be mistaken for the start of a message.
+static char ring_doorbell[1] = { (char)0xc1 };
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "msgpack_rpc/channel.c.generated.h"
 #endif
@@ -87,6 +97,7 @@ void rpc_start(Channel *channel)
   rpc->next_request_id = 1;
   rpc->info = (Dictionary)ARRAY_DICT_INIT;
   kv_init(rpc->call_stack);
+  rpc->ring = NULL;
 
   if (channel->streamtype != kChannelStreamInternal) {
     Stream *out = channel_outstream(channel);
@@ -219,6 +230,15 @@ static void receive_msgpack(Stream *stream, RBuffer *rbuf, size_t c, void *data,
   DLOG("ch %" PRIu64 ": parsing %zu bytes from msgpack Stream: %p",
        channel->id, rbuffer_size(rbuf), (void *)stream);
 
+  RpcRing *ring = channel->rpc.ring;
+  if (ring && ring->active) {
+    // The other side writes everything into the ring now, the stream only
+    // carries doorbells.
+    rbuffer_consumed_compact(rbuf, rbuffer_size(rbuf));
+    ring_read(channel);
+    goto end;
+  }
+
   Unpacker *p = channel->rpc.unpacker;
   size_t size = 0;
   p->read_ptr = rbuffer_read_ptr(rbuf, &size);
@@ -230,6 +250,10 @@ static void receive_msgpack(Stream *stream, RBuffer *rbuf, size_t c, void *data,
     rbuffer_consumed_compact(rbuf, consumed);
   }
 
+  if (ring && ring->active && !channel->rpc.closed) {
+    ring_read(channel);
+  }
+
 end:
   channel_decref(channel);
 }
@@ -248,7 +272,7 @@ static ChannelCallFrame *find_call_frame(RpcState *rpc, uint32_t request_id)
 static void parse_msgpack(Channel *channel)
 {
   Unpacker *p = channel->rpc.unpacker;
-  while (unpacker_advance(p)) {
+  while (ring_doorbells(channel) && unpacker_advance(p)) {
     if (p->type == kMessageTypeRedrawEvent) {
       // When exiting, ui_client_stop() has already been called, so don't handle UI events.
       if (ui_client_channel_id && !exiting) {
@@ -408,6 +432,9 @@ static bool channel_write(Channel *channel, WBuffer *buffer)
     channel_incref(channel);
     CREATE_EVENT(channel->events, internal_read_event, channel, buffer);
     success = true;
+  } else if (channel->rpc.ring && channel->rpc.ring->writer) {
+    kv_push(channel->rpc.ring->pending, buffer);
+    success = ring_flush(channel);
   } else {
     Stream *in = channel_instream(channel);
     success = wstream_write(in, buffer);
@@ -506,6 +533,174 @@ void rpc_free(Channel *channel)
 
   kv_destroy(channel->rpc.call_stack);
   api_free_dictionary(channel->rpc.info);
+
+  RpcRing *ring = channel->rpc.ring;
+  if (ring) {
+    for (size_t i = 0; i < kv_size(ring->pending); i++) {
+      wstream_release_wbuffer(kv_A(ring->pending, i));
+    }
+    kv_destroy(ring->pending);
+    shmring_free(ring->shm);
+    XFREE_CLEAR(channel->rpc.ring);
+  }
+}
+
+/// Creates a shared memory ring for the other side of channel "id" to write
+/// into, instead of the stream. The other side is told about it with the
+/// "shm_ring" |ui-option|, then it uses the ring if it can.
+///
+/// @return path of the ring to pass to the other side, or NULL if the ring
+///         could not be created.
+const char *rpc_ring_create(uint64_t id)
+{
+  Channel *channel = find_rpc_channel(id);
+  if (!channel || channel->rpc.ring || channel->streamtype == kChannelStreamInternal) {
+    return NULL;
+  }
+  ShmRing *shm = shmring_new(RPC_RING_SIZE);
+  if (!shm) {
+    return NULL;
+  }
+  channel->rpc.ring = ring_alloc(shm, false);
+  return shmring_path(shm);
+}
+
+/// Opens the shared memory ring at "path", created by the other side of
+/// channel "id" with rpc_ring_create(), and writes everything sent on the
+/// channel into the ring from now on.
+///
+/// @return false if the ring cannot be used, the stream is used then.
+bool rpc_ring_attach(uint64_t id, const char *path)
+{
+  Channel *channel = find_rpc_channel(id);
+  if (!channel || channel->rpc.ring || channel->streamtype == kChannelStreamInternal) {
+    return false;
+  }
+  ShmRing *shm = shmring_open(path);
+  if (!shm) {
+    return false;
+  }
+  channel->rpc.ring = ring_alloc(shm, true);
+  DLOG("ch %" PRIu64 ": writing to shared memory ring %s", id, path);
+  return true;
+}
+
+static RpcRing *ring_alloc(ShmRing *shm, bool writer)
+{
+  RpcRing *ring = xcalloc(1, sizeof(RpcRing));
+  ring->shm = shm;
+  ring->writer = writer;
+  kv_init(ring->pending);
+  return ring;
+}
+
+/// Writes a doorbell to the stream of "channel".
+///
+/// @return false if the write failed. The other side keeps waiting then, the
+///         caller must close the channel.
+static bool ring_notify(Channel *channel)
+{
+  return wstream_write(channel_instream(channel),
+                       wstream_new_buffer(ring_doorbell, sizeof(ring_doorbell), 1, NULL));
+}
+
+/// Writes pending output into the ring, as much as fits. The rest is written
+/// when the reader rings the doorbell after making room.
+///
+/// @return false if the ring is broken or the doorbell cannot be written.
+static bool ring_flush(Channel *channel)
+{
+  RpcRing *ring = channel->rpc.ring;
+  bool wrote = false;
+  size_t done = 0;
+  while (done < kv_size(ring->pending)) {
+    WBuffer *buf = kv_A(ring->pending, done);
+    ptrdiff_t n = shmring_write(ring->shm, buf->data + ring->pending_off,
+                                buf->size - ring->pending_off);
+    if (n < 0) {
+      return false;
+    }
+    wrote |= n > 0;
+    ring->pending_off += (size_t)n;
+    if (ring->pending_off == buf->size) {
+      wstream_release_wbuffer(buf);
+      ring->pending_off = 0;
+      done++;
+    } else if (!shmring_wait_space(ring->shm)) {
+      break;
+    }
+  }
+
+  if (done > 0) {
+    size_t rest = kv_size(ring->pending) - done;
+    memmove(ring->pending.items, ring->pending.items + done, rest * sizeof(WBuffer *));
+    kv_size(ring->pending) = rest;
+  }
+  if (wrote && shmring_wake_reader(ring->shm)) {
+    return ring_notify(channel);
+  }
+  return true;
+}
+
+/// Parses what the other side wrote into the ring, until it runs out of data.
+static void ring_read(Channel *channel)
+{
+  RpcRing *ring = channel->rpc.ring;
+  Unpacker *p = channel->rpc.unpacker;
+  do {
+    size_t size = 0;
+    char *ptr = shmring_read_ptr(ring->shm, &size);
+    if (ptr == NULL) {
+      chan_close_with_error(channel, "shared memory ring is broken", LOGLVL_ERR);
+      return;
+    }
+    p->read_ptr = ptr;
+    p->read_size = size;
+    parse_msgpack(channel);
+    if (unpacker_closed(p) || channel->rpc.closed) {
+      return;
+    }
+    size_t consumed = size - p->read_size;
+    if (consumed > 0 && shmring_consumed(ring->shm, consumed) && !ring_notify(channel)) {
+      chan_close_with_error(channel, "cannot write doorbell of shared memory ring", LOGLVL_ERR);
+      return;
+    }
+  } while (shmring_wait_data(ring->shm));
+}
+
+/// Handles doorbells at the start of the next message.
+///
+/// @return false if the rest of the input must not be parsed as messages.
+static bool ring_doorbells(Channel *channel)
+{
+  RpcRing *ring = channel->rpc.ring;
+  Unpacker *p = channel->rpc.unpacker;
+  if (!ring || p->state != 0 || p->read_size == 0 || *p->read_ptr != ring_doorbell[0]) {
+    return true;
+  }
+
+  if (!ring->writer) {
+    if (ring->active) {
+      return true;  // not expected in the ring itself, fail parsing it
+    }
+    // The other side switched to the ring, and only sends doorbells through
+    // the stream from now on. receive_msgpack() reads the ring.
+    ring->active = true;
+    p->read_ptr += p->read_size;
+    p->read_size = 0;
+    return false;
+  }
+
+  // The reader made room in the ring.
+  while (p->read_size > 0 && *p->read_ptr == ring_doorbell[0]) {
+    p->read_ptr++;
+    p->read_size--;
+  }
+  if (!ring_flush(channel)) {
+    chan_close_with_error(channel, "cannot write to shared memory ring", LOGLVL_ERR);
+    return false;
+  }
+  return true;
 }
 
 static void chan_close_with_error(Channel *channel, char *msg, int loglevel)
@@ -5,6 +5,7 @@
 #include <uv.h>
 
 #include "nvim/api/private/dispatch.h"
+#include "nvim/event/defs.h"
 #include "nvim/map_defs.h"
 
 typedef struct Channel Channel;
@@ -36,6 +37,16 @@ typedef struct {
   Arena used_mem;
 } RequestEvent;
 
+/// Shared memory ring carrying the output of the server side of a channel to
+/// the client side, see the "shm_ring" |ui-option|.
+typedef struct {
+  ShmRing *shm;
+  bool writer;  ///< this side writes into the ring, otherwise it reads from it
+  bool active;  ///< reader: the other side writes into the ring now
+  kvec_t(WBuffer *) pending;  ///< writer: output waiting for room in the ring
+  size_t pending_off;  ///< writer: bytes of the first pending buffer already written
+} RpcRing;
+
 typedef struct {
   bool closed;
   Unpacker *unpacker;
@@ -43,4 +54,5 @@ typedef struct {
   kvec_t(ChannelCallFrame *) call_stack;
   Dictionary info;
   ClientType client_type;
+  RpcRing *ring;
 } RpcState;
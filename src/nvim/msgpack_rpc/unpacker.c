@@ -23,6 +23,8 @@ Object unpack(const char *data, size_t size, Arena *arena, Error *err)
   mpack_parser_init(&unpacker.parser, 0);
   unpacker.parser.data.p = &unpacker;
   unpacker.arena = *arena;
+  unpacker.inplace = false;
+  unpacker.pending_nul = NULL;
 
   int result = mpack_parse(&unpacker.parser, &data, &size,
                            api_parse_enter, api_parse_exit);
@@ -48,6 +50,12 @@ static void api_parse_enter(mpack_parser_t *parser, mpack_node_t *node)
   Object *result = NULL;
   String *key_location = NULL;
 
+  if (p->pending_nul) {
+    // the byte after the previous string has been parsed, it can be replaced
+    *p->pending_nul = NUL;
+    p->pending_nul = NULL;
+  }
+
   mpack_node_t *parent = MPACK_PARENT_NODE(node);
   if (parent) {
     switch (parent->tok.type) {
@@ -101,15 +109,17 @@ static void api_parse_enter(mpack_parser_t *parser, mpack_node_t *node)
 
   case MPACK_TOKEN_BIN:
   case MPACK_TOKEN_STR: {
-    char *mem = arena_alloc(&p->arena, node->tok.length + 1, false);
-    mem[node->tok.length] = NUL;
-    String str = { .data = mem, .size = node->tok.length };
+    String str = { .data = NULL, .size = node->tok.length };
+    if (!p->inplace || str.size == 0) {
+      str.data = arena_allocz(&p->arena, str.size);
+    }
     if (key_location) {
       *key_location = str;
+      node->data[0].p = key_location;
     } else {
       *result = STRING_OBJ(str);
+      node->data[0].p = &result->data.string;
     }
-    node->data[0].p = str.data;
     break;
   }
   case MPACK_TOKEN_EXT:
@@ -119,9 +129,16 @@ static void api_parse_enter(mpack_parser_t *parser, mpack_node_t *node)
   case MPACK_TOKEN_CHUNK:
     assert(parent);
     if (parent->tok.type == MPACK_TOKEN_STR || parent->tok.type == MPACK_TOKEN_BIN) {
-      char *data = parent->data[0].p;
-      memcpy(data + parent->pos,
-             node->tok.data.chunk_ptr, node->tok.length);
+      String *str = parent->data[0].p;
+      if (p->inplace) {
+        // the whole object is available, so the string is a single chunk
+        assert(parent->pos == 0 && node->tok.length == str->size);
+        str->data = (char *)node->tok.data.chunk_ptr;
+        p->pending_nul = str->data + str->size;
+      } else {
+        memcpy(str->data + parent->pos,
+               node->tok.data.chunk_ptr, node->tok.length);
+      }
     } else {
       Object *res = parent->data[0].p;
 
@@ -187,6 +204,8 @@ void unpacker_init(Unpacker *p)
   p->unpack_error = ERROR_INIT;
 
   p->arena = (Arena)ARENA_EMPTY;
+  p->inplace = false;
+  p->pending_nul = NULL;
 
   p->has_grid_line_event = false;
 }
@@ -339,8 +358,7 @@ bool unpacker_advance(Unpacker *p)
   int result;
 
 rerun:
-  result = mpack_parse(&p->parser, &p->read_ptr, &p->read_size,
-                       api_parse_enter, api_parse_exit);
+  result = unpacker_parse_object(p);
 
   if (result == MPACK_EOF) {
     return false;
@@ -375,6 +393,79 @@ done:
   }
 }
 
+/// Returns the length of the msgpack object at the start of "data", or zero
+/// if it is not complete yet (or invalid, which is left to the parser).
+static size_t object_size(const char *data, size_t size)
+{
+  const char *start = data;
+  size_t pending = 1;  // objects left to skip
+  while (pending > 0) {
+    if (pending > size) {
+      return 0;  // every object takes at least one byte
+    }
+    mpack_token_t tok;
+    if (mpack_rtoken(&data, &size, &tok) != MPACK_OK) {
+      return 0;
+    }
+    pending--;
+    switch (tok.type) {
+    case MPACK_TOKEN_ARRAY:
+      pending += tok.length;
+      break;
+    case MPACK_TOKEN_MAP:
+      pending += 2 * (size_t)tok.length;
+      break;
+    case MPACK_TOKEN_STR:
+    case MPACK_TOKEN_BIN:
+    case MPACK_TOKEN_EXT:
+      if (tok.length > size) {
+        return 0;
+      }
+      data += tok.length;
+      size -= tok.length;
+      break;
+    default:
+      break;
+    }
+  }
+  return (size_t)(data - start);
+}
+
+/// Parses the next object from the read buffer into p->result.
+///
+/// The read buffer is reused as soon as the data has been consumed, so strings
+/// can't point into it. When a complete object is available, it is copied as
+/// a whole into the arena and parsed in place, instead of allocating and
+/// copying every string separately. Otherwise strings are copied chunk by
+/// chunk, as the object might continue in the next read.
+static int unpacker_parse_object(Unpacker *p)
+{
+  if (p->parser.size == 0 && p->parser.tokbuf.plen == 0) {
+    size_t len = object_size(p->read_ptr, p->read_size);
+    if (len > 0) {
+      char *buf = arena_memdupz(&p->arena, p->read_ptr, len);
+      const char *data = buf;
+      size_t size = len;
+      p->inplace = true;
+      int result = mpack_parse(&p->parser, &data, &size, api_parse_enter, api_parse_exit);
+      p->inplace = false;
+      if (p->pending_nul) {
+        *p->pending_nul = NUL;
+        p->pending_nul = NULL;
+      }
+      if (result == MPACK_OK) {
+        p->read_ptr += len - size;
+        p->read_size -= len - size;
+        return MPACK_OK;
+      }
+      // the object was complete, so running out of data means it is broken
+      return result == MPACK_EOF ? MPACK_ERROR : result;
+    }
+  }
+
+  return mpack_parse(&p->parser, &p->read_ptr, &p->read_size, api_parse_enter, api_parse_exit);
+}
+
 bool unpacker_parse_redraw(Unpacker *p)
 {
   mpack_token_t tok;
@@ -34,6 +34,12 @@ struct Unpacker {
 
   Arena arena;
 
+  // Set while parsing an object which has been copied as a whole into "arena".
+  // Strings then point into the copy instead of getting their own allocation,
+  // and are NUL-terminated once the byte after them has been parsed.
+  bool inplace;
+  char *pending_nul;
+
   int nevents;
   int ncalls;
   UIClientHandler ui_handler;
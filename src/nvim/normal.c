@@ -1349,6 +1349,11 @@ static void normal_redraw(NormalState *s)
 
   show_cursor_info_later(false);
 
+  // Wait for the next frame, everything below is done then.
+  if (must_redraw && redraw_frame_wait()) {
+    return;
+  }
+
   if (must_redraw) {
     update_screen();
   } else {
@@ -6039,6 +6044,10 @@ static void nv_goto(cmdarg_T *cap)
 {
   linenr_T lnum;
 
+  // The last line is only known when the whole file has been read.
+  if (cap->arg || cap->count0 > curbuf->b_ml.ml_line_count) {
+    buf_load_wait(curbuf);
+  }
   if (cap->arg) {
     lnum = curbuf->b_ml.ml_line_count;
   } else {
@@ -3446,6 +3446,18 @@ void do_put(int regname, yankreg_T *reg, int dir, int count, int flags)
           i = 1;
         }
 
+        if (y_type != kMTCharWise && !(flags & PUT_FIXINDENT)) {
+          // Nothing to do for each line: append them all at once.
+          linenr_T n = (linenr_T)(y_size - i);
+          if (ml_append_lines(curbuf, lnum, y_array + i, NULL, n, false) == FAIL) {
+            goto error;
+          }
+          new_lnum += n;
+          lnum += n;
+          nr_lines += n;
+          i = y_size;
+        }
+
         for (; i < y_size; i++) {
           if ((y_type != kMTCharWise || i < y_size - 1)) {
             if (ml_append(lnum, y_array[i], 0, false) == FAIL) {
@@ -87,6 +87,7 @@
 #include "nvim/os/os.h"
 #include "nvim/os/os_defs.h"
 #include "nvim/path.h"
+#include "nvim/plines.h"
 #include "nvim/popupmenu.h"
 #include "nvim/pos_defs.h"
 #include "nvim/regexp.h"
@@ -2906,6 +2907,18 @@ static const char *validate_num_option(OptIndex opt_idx, void *varp, OptInt *new
     if (value < 0) {
       return e_positive;
     }
+  } else if (varp == &p_mcp) {
+    if (value < 0) {
+      return e_positive;
+    }
+  } else if (varp == &p_rdr) {
+    if (value < 0) {
+      return e_positive;
+    }
+  } else if (varp == &p_sfs) {
+    if (value < 0) {
+      return e_positive;
+    }
   } else if (varp == &p_ch) {
     if (value < 0) {
       return e_positive;
@@ -3033,6 +3046,10 @@ void check_redraw_for(buf_T *buf, win_T *win, uint32_t flags)
   if (flags & P_RBUF) {
     redraw_buf_later(buf, UPD_NOT_VALID);
   }
+  if (((flags & P_RBUF) || all) && !(flags & P_HLONLY)) {
+    // Other windows may show the buffer or use the global value.
+    plines_cache_invalidate_all();
+  }
   if (all) {
     redraw_all_later(UPD_NOT_VALID);
   }
@@ -3589,6 +3606,7 @@ static const char *did_set_option(OptIndex opt_idx, void *varp, OptVal old_value
   } else if ((varp == &p_flp || varp == &(curbuf->b_p_flp)) && curwin->w_briopt_list) {
     // Changing Formatlistpattern when briopt includes the list setting:
     // redraw
+    plines_cache_invalidate_all();
     redraw_all_later(UPD_NOT_VALID);
   } else if (varp == &p_wbr || varp == &(curwin->w_p_wbr)) {
     // add / remove window bars for 'winbar'
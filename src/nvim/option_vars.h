@@ -534,6 +534,7 @@ EXTERN char *p_langmap;         ///< 'langmap'
 EXTERN int p_lnr;               ///< 'langnoremap'
 EXTERN int p_lrm;               ///< 'langremap'
 EXTERN char *p_lm;              ///< 'langmenu'
+EXTERN OptInt p_lfs;            ///< 'largefilesize'
 EXTERN OptInt p_lines;          ///< 'lines'
 EXTERN OptInt p_linespace;      ///< 'linespace'
 EXTERN int p_lisp;              ///< 'lisp'
@@ -554,6 +555,7 @@ EXTERN OptInt p_mat;            ///< 'matchtime'
 EXTERN OptInt p_mfd;            ///< 'maxfuncdepth'
 EXTERN OptInt p_mmd;            ///< 'maxmapdepth'
 EXTERN OptInt p_mmp;            ///< 'maxmempattern'
+EXTERN OptInt p_mcp;            ///< 'memcompress'
 EXTERN OptInt p_mis;            ///< 'menuitems'
 EXTERN char *p_msm;             ///< 'mkspellmem'
 EXTERN int p_ml;                ///< 'modeline'
@@ -593,6 +595,7 @@ EXTERN unsigned rdb_flags;
 #define RDB_FLUSH               0x020
 #define RDB_INTERSECT           0x040
 
+EXTERN OptInt p_rdr;            ///< 'redrawrate'
 EXTERN OptInt p_rdt;            ///< 'redrawtime'
 EXTERN OptInt p_re;             ///< 'regexpengine'
 EXTERN OptInt p_report;         ///< 'report'
@@ -687,6 +690,7 @@ EXTERN unsigned spo_flags;
 EXTERN char *p_sps;             ///< 'spellsuggest'
 EXTERN int p_spr;               ///< 'splitright'
 EXTERN int p_sol;               ///< 'startofline'
+EXTERN OptInt p_sfs;            ///< 'streamfilesize'
 EXTERN char *p_su;              ///< 'suffixes'
 EXTERN char *p_swb;             ///< 'switchbuf'
 EXTERN unsigned swb_flags;
@@ -4694,6 +4694,39 @@ return {
       type = 'boolean',
       varname = 'p_lrm',
     },
+    {
+      abbreviation = 'lfs',
+      defaults = { if_true = 0 },
+      desc = [=[
+        When editing a file of at least this size (in Kbyte), the text of the
+        file is not read into memory.  Instead the file is mapped into memory
+        and lines are only taken from it when they are used, which makes
+        opening a very large file fast.  Lines that are changed are copied
+        into the buffer as usual.  Zero disables this.
+        Only used when the file does not need to be converted: 'fileencoding'
+        is "utf-8" (or 'binary' is set), 'fileformat' is "unix" and the file
+        does not start with a BOM.  Also not used when 'undofile' is set.
+        The lines in the first Mbyte are found before the file is displayed,
+        the rest is scanned in the background like with 'streamfilesize'; the
+        status line shows "[loading N%]" until all lines were found.
+        An illegal byte after the first Mbyte is kept as with "++bad=keep",
+        the file is not read again with another encoding from
+        'fileencodings'.
+        Before the file is overwritten all text is read into memory.
+        The text that is only in the file cannot be kept in a swap file, so
+        the buffer has no swap file until the file was written: changes
+        cannot be recovered after a crash and other Nvim instances editing
+        the same file are not warned, see |swap-file|.
+        The file must not be truncated by another program while it is being
+        edited, lines that can no longer be found are left empty (E1514).
+        Not used on MS-Windows.
+      ]=],
+      full_name = 'largefilesize',
+      scope = { 'global' },
+      short_desc = N_('minimum size (in Kbyte) of a file to map into memory'),
+      type = 'number',
+      varname = 'p_lfs',
+    },
     {
       abbreviation = 'ls',
       cb = 'did_set_laststatus',
@@ -5217,6 +5250,23 @@ return {
       type = 'number',
       varname = 'p_mmp',
     },
+    {
+      abbreviation = 'mcp',
+      defaults = { if_true = 0 },
+      desc = [=[
+        When non-zero, the text of a buffer without a swap file that was not
+        used for this many syncs is kept compressed in memory.  A sync happens
+        after 'updatetime' or after typing 'updatecount' characters, see
+        |swap-file|.  Compressed text is decompressed when it is used again.
+        Useful for many large buffers with 'noswapfile' that are mostly read.
+        Zero disables this.
+      ]=],
+      full_name = 'memcompress',
+      scope = { 'global' },
+      short_desc = N_('number of syncs before unused text is compressed'),
+      type = 'number',
+      varname = 'p_mcp',
+    },
     {
       abbreviation = 'mis',
       defaults = { if_true = 25 },
@@ -6236,6 +6286,23 @@ return {
       type = 'string',
       varname = 'p_rdb',
     },
+    {
+      abbreviation = 'rdr',
+      defaults = { if_true = 0 },
+      desc = [=[
+        When non-zero, redraws which are not caused by typing, e.g. when a job
+        writes into a buffer or |terminal|, are done at most this many times per
+        second.  Changes made between two redraws are shown together.  Typed
+        keys are always shown without delay.  Useful to limit the amount of
+        output sent to the UI while a command produces a lot of output.
+        Zero means no limit.
+      ]=],
+      full_name = 'redrawrate',
+      scope = { 'global' },
+      short_desc = N_('maximum number of redraws per second for events'),
+      type = 'number',
+      varname = 'p_rdr',
+    },
     {
       abbreviation = 'rdt',
       defaults = { if_true = 2000 },
@@ -8308,6 +8375,34 @@ return {
       type = 'string',
       varname = 'p_stl',
     },
+    {
+      abbreviation = 'sfs',
+      defaults = { if_true = 0 },
+      desc = [=[
+        When editing a file of at least this size (in Kbyte), only the first
+        part of the file is read before the file is displayed.  The rest of
+        the file is read in the background and appended to the buffer while
+        you can look around in the text that is already there.  The status
+        line shows "[loading N%]" until the whole file has been read.
+        Commands that change the buffer, write it or read another file into
+        it wait for the file to be loaded completely, and so does searching
+        with |/|, |?|, |n| and |N|.  The 'incsearch' preview only finds
+        matches in the lines that were read.  Zero disables this.
+        Only used when the file does not need to be converted: 'fileencoding'
+        is "utf-8" (or 'binary' is set), 'fileformat' is "unix" and the file
+        does not start with a BOM.  Also not used when 'undofile' is set.
+        An illegal byte found in the part of the file that is read in the
+        background is handled as with |++bad|, the file is not read again
+        with another encoding from 'fileencodings'.
+        'largefilesize' is used first, when the file can be mapped into
+        memory this option does not matter.
+      ]=],
+      full_name = 'streamfilesize',
+      scope = { 'global' },
+      short_desc = N_('minimum size (in Kbyte) of a file to load in the background'),
+      type = 'number',
+      varname = 'p_sfs',
+    },
     {
       abbreviation = 'su',
       defaults = { if_true = '.bak,~,.o,.h,.info,.swp,.obj' },
@@ -37,6 +37,7 @@
 #include "nvim/option_vars.h"
 #include "nvim/optionstr.h"
 #include "nvim/os/os.h"
+#include "nvim/plines.h"
 #include "nvim/pos_defs.h"
 #include "nvim/regexp.h"
 #include "nvim/regexp_defs.h"
@@ -823,6 +824,9 @@ static const char *did_set_global_chars_option(win_T *win, char *val, CharsOptio
     }
   }
 
+  // "eol" and "tab" of 'listchars' change the height of lines in all windows
+  // using the global value, not only in the current one.
+  plines_cache_invalidate_all();
   redraw_all_later(UPD_NOT_VALID);
 
   return NULL;
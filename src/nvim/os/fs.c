@@ -2,6 +2,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -14,6 +15,8 @@
 
 #ifdef MSWIN
 # include <shlobj.h>
+#else
+# include <sys/mman.h>
 #endif
 
 #include "auto/config.h"
@@ -606,6 +609,65 @@ ptrdiff_t os_read(const int fd, bool *const ret_eof, char *const ret_buf, const
   return (ptrdiff_t)read_bytes;
 }
 
+/// Map the first "size" bytes of a file into memory, read-only.
+///
+/// Pages are only read from the file when they are accessed. Changes made to
+/// the file by other processes may or may not become visible in the mapping.
+///
+/// @param[in]  fd  File descriptor of a regular file, opened for reading.
+/// @param[in]  size  Number of bytes to map, must not be zero.
+///
+/// @return Start of the mapping or NULL when the file cannot be mapped (always
+///         NULL on Windows).
+const char *os_mmap_readonly(int fd, size_t size)
+  FUNC_ATTR_WARN_UNUSED_RESULT
+{
+#ifdef MSWIN
+  return NULL;
+#else
+  if (size == 0) {
+    return NULL;
+  }
+  void *p = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (p == MAP_FAILED) {
+    return NULL;
+  }
+# ifdef POSIX_MADV_SEQUENTIAL
+  // Most of the mapping is scanned once from start to end.
+  posix_madvise(p, size, POSIX_MADV_SEQUENTIAL);
+# endif
+  return p;
+#endif
+}
+
+/// Unmap memory mapped with os_mmap_readonly().
+void os_munmap(const char *addr, size_t size)
+{
+#ifndef MSWIN
+  if (addr != NULL) {
+    munmap((void *)addr, size);
+  }
+#endif
+}
+
+/// Tell the system that the pages with "len" bytes at offset "off" of the
+/// mapping "addr" from os_mmap_readonly() are not needed for now.  They no
+/// longer count as memory used by Nvim, when accessed again they are read
+/// from the file.
+void os_mmap_release(const char *addr, size_t off, size_t len)
+{
+#if !defined(MSWIN) && defined(MADV_DONTNEED)
+  size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  // The mapping is read-only: releasing part of a page that is still used
+  // only means it is read again.
+  size_t start = off / page * page;
+  size_t end = (off + len + page - 1) / page * page;
+  if (len > 0) {
+    madvise((void *)(addr + start), end - start, MADV_DONTNEED);
+  }
+#endif
+}
+
 #ifdef HAVE_READV
 /// Read from a file to multiple buffers at once
 ///
@@ -708,6 +770,36 @@ ptrdiff_t os_write(const int fd, const char *const buf, const size_t size, const
   return (ptrdiff_t)written_bytes;
 }
 
+/// Write to a file at a given offset, without using or changing the file
+/// position.  Does not use global state, can be called from another thread.
+///
+/// @param[in]  fd  File descriptor to write to.
+/// @param[in]  buf  Data to write.
+/// @param[in]  size  Amount of bytes to write.
+/// @param[in]  offset  Offset in the file to write at.
+///
+/// @return Number of bytes written or libuv error code (< 0).
+ptrdiff_t os_pwrite(const int fd, const char *const buf, const size_t size, const int64_t offset)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_WARN_UNUSED_RESULT
+{
+  size_t written_bytes = 0;
+  while (written_bytes != size) {
+    uv_buf_t uvbuf = uv_buf_init((char *)buf + written_bytes,
+                                 (unsigned)MIN(size - written_bytes, INT_MAX));
+    int r;
+    RUN_UV_FS_FUNC(r, uv_fs_write, fd, &uvbuf, 1, offset + (int64_t)written_bytes, NULL);
+    if (r == UV_EINTR || r == UV_EAGAIN) {
+      continue;
+    } else if (r < 0) {
+      return r;
+    } else if (r == 0) {
+      return UV_UNKNOWN;
+    }
+    written_bytes += (size_t)r;
+  }
+  return (ptrdiff_t)written_bytes;
+}
+
 /// Copies a file from `path` to `new_path`.
 ///
 /// @see http://docs.libuv.org/en/v1.x/fs.html#c.uv_fs_copyfile
@@ -1196,6 +1288,37 @@ bool os_fileinfo_link(const char *path, FileInfo *file_info)
   return ok;
 }
 
+/// Check if "path" is on a network filesystem or a FUSE filesystem (such as
+/// sshfs).  Changes made by another machine or by the FUSE process do not
+/// cause inotify events there.
+///
+/// @return  true when it is, false when it is not or it can't be found out.
+bool os_path_is_remote(const char *path)
+  FUNC_ATTR_NONNULL_ALL
+{
+#ifdef __linux__
+  uv_fs_t request;
+  bool remote = false;
+  if (uv_fs_statfs(NULL, &request, path, NULL) == kLibuvSuccess) {
+    switch (((uv_statfs_t *)request.ptr)->f_type) {
+    case 0x6969:      // NFS_SUPER_MAGIC
+    case 0x517B:      // SMB_SUPER_MAGIC
+    case 0xFF534D42:  // CIFS_MAGIC_NUMBER
+    case 0xFE534D42:  // SMB2_MAGIC_NUMBER
+    case 0x65735546:  // FUSE_SUPER_MAGIC, also sshfs
+      remote = true;
+      break;
+    default:
+      break;
+    }
+  }
+  uv_fs_req_cleanup(&request);
+  return remote;
+#else
+  return false;
+#endif
+}
+
 /// Get the file information for a given file descriptor
 ///
 /// @param file_descriptor File descriptor of the file.
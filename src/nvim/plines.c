@@ -21,6 +21,7 @@
 #include "nvim/mbyte.h"
 #include "nvim/mbyte_defs.h"
 #include "nvim/memline.h"
+#include "nvim/memory.h"
 #include "nvim/move.h"
 #include "nvim/option.h"
 #include "nvim/option_vars.h"
@@ -34,6 +35,9 @@
 # include "plines.c.generated.h"
 #endif
 
+/// Number of entries in w_plines_cache[], a power of two.
+#define PLINES_CACHE_SIZE 256
+
 /// Functions calculating horizontal size of text, when displayed in a window.
 
 /// Return the number of cells the first char in "p" will take on the screen,
@@ -772,6 +776,26 @@ int plines_win_nofold(win_T *wp, linenr_T lnum)
     return 1;  // be quick for an empty line
   }
 
+  // Add column offset for 'number', 'relativenumber' and 'foldcolumn'.
+  int width = wp->w_width_inner - win_col_off(wp);
+  if (width <= 0) {
+    return 32000;  // bigger than the number of screen lines
+  }
+
+  // The size of inline virtual text can change without the line changing,
+  // only remember the height of lines without it.
+  plines_cache_T *entry = NULL;
+  colnr_T len = 0;
+  if (csarg.virt_row < 0) {
+    len = ml_get_buf_len(wp->w_buffer, lnum);
+    entry = plines_cache_entry(wp, lnum, width, width + win_col_off2(wp));
+    if (entry->pc_lnum == lnum && entry->pc_len == len) {
+      g_stats.plines_cache_hit++;
+      return entry->pc_lines;
+    }
+    g_stats.plines_cache_miss++;
+  }
+
   int64_t col;
   if (cstype == kCharsizeFast) {
     col = linesize_fast(&csarg, 0, MAXCOL);
@@ -785,18 +809,82 @@ int plines_win_nofold(win_T *wp, linenr_T lnum)
     col += 1;
   }
 
-  // Add column offset for 'number', 'relativenumber' and 'foldcolumn'.
-  int width = wp->w_width_inner - win_col_off(wp);
-  if (width <= 0) {
-    return 32000;  // bigger than the number of screen lines
+  int lines = 1;
+  if (col > width) {
+    col -= width;
+    width += win_col_off2(wp);
+    const int64_t n = (col + (width - 1)) / width + 1;
+    lines = (n > 0 && n <= INT_MAX) ? (int)n : INT_MAX;
   }
-  if (col <= width) {
-    return 1;
+
+  if (entry != NULL) {
+    *entry = (plines_cache_T){ .pc_lnum = lnum, .pc_len = len, .pc_lines = lines };
+  }
+  return lines;
+}
+
+/// Get the w_plines_cache[] entry for "lnum".  Clears the cache first when
+/// it is for another buffer, the buffer was changed in a way that
+/// plines_cache_changed() didn't see, or the text width is different.
+///
+/// @param width1  text width of the first screen line
+/// @param width2  text width of the other screen lines
+static plines_cache_T *plines_cache_entry(win_T *wp, linenr_T lnum, int width1, int width2)
+{
+  buf_T *buf = wp->w_buffer;
+  varnumber_T tick = buf_get_changedtick(buf);
+  if (wp->w_plines_cache == NULL) {
+    wp->w_plines_cache = xcalloc(PLINES_CACHE_SIZE, sizeof(plines_cache_T));
+  } else if (wp->w_plines_cache_buf != buf->handle || wp->w_plines_cache_tick != tick
+             || wp->w_plines_cache_width1 != width1 || wp->w_plines_cache_width2 != width2) {
+    memset(wp->w_plines_cache, 0, PLINES_CACHE_SIZE * sizeof(plines_cache_T));
+  }
+  wp->w_plines_cache_buf = buf->handle;
+  wp->w_plines_cache_tick = tick;
+  wp->w_plines_cache_width1 = width1;
+  wp->w_plines_cache_width2 = width2;
+  return &wp->w_plines_cache[lnum & (PLINES_CACHE_SIZE - 1)];
+}
+
+/// Forget all line heights remembered for window "wp", for when an option
+/// changed which affects them.
+void plines_cache_invalidate(win_T *wp)
+{
+  wp->w_plines_cache_buf = 0;
+}
+
+/// Like plines_cache_invalidate(), but for all windows.
+void plines_cache_invalidate_all(void)
+{
+  FOR_ALL_TAB_WINDOWS(tp, wp) {
+    plines_cache_invalidate(wp);
+  }
+}
+
+/// Forget the heights of lines "lnum" to "lnume" - 1 of window "wp", which
+/// changed.  "xtra" lines were added (negative if deleted) below them.
+void plines_cache_changed(win_T *wp, linenr_T lnum, linenr_T lnume, linenr_T xtra)
+{
+  plines_cache_T *cache = wp->w_plines_cache;
+  if (cache == NULL || wp->w_plines_cache_buf != wp->w_buffer->handle) {
+    return;
+  }
+  // The change incremented b:changedtick at most once since the last lookup,
+  // otherwise a change was missed and all heights are dropped on the next one.
+  varnumber_T tick = buf_get_changedtick(wp->w_buffer);
+  if (wp->w_plines_cache_tick != tick && wp->w_plines_cache_tick != tick - 1) {
+    return;
+  }
+  wp->w_plines_cache_tick = tick;
+
+  // Entries are found by line number, the ones for lines moved by inserting or
+  // deleting lines are dropped instead of moved.
+  linenr_T end = xtra != 0 ? MAXLNUM : lnume;
+  for (int i = 0; i < PLINES_CACHE_SIZE; i++) {
+    if (cache[i].pc_lnum >= lnum && cache[i].pc_lnum < end) {
+      cache[i].pc_lnum = 0;
+    }
   }
-  col -= width;
-  width += win_col_off2(wp);
-  const int64_t lines = (col + (width - 1)) / width + 1;
-  return (lines > 0 && lines <= INT_MAX) ? (int)lines : INT_MAX;
 }
 
 /// Like plines_win(), but only reports the number of physical screen lines
@@ -1056,6 +1056,12 @@ int do_search(oparg_T *oap, int dirc, int search_delim, char *pat, int count, in
   // (there is no "if ()" around this because gcc wants them initialized)
   SearchOffset old_off = spats[0].off;
 
+  // A match may be in the part of the file that is still being read, see
+  // 'streamfilesize'.  Not for the 'incsearch' preview, it would block typing.
+  if (!(options & SEARCH_PEEK)) {
+    buf_load_wait(curbuf);
+  }
+
   pos = curwin->w_cursor;       // start searching at the cursor position
 
   // Find out the direction of the search.
@@ -68,7 +68,7 @@ getkey:
     } else {
       // Duplicate display updating logic in vgetorpeek()
       if (((State & MODE_INSERT) != 0 || p_lz) && (State & MODE_CMDLINE) == 0
-          && must_redraw != 0 && !need_wait_return) {
+          && must_redraw != 0 && !need_wait_return && !redraw_frame_wait()) {
         update_screen();
         setcursor();  // put cursor back where it belongs
       }
@@ -86,6 +86,10 @@ getkey:
       }
     }
 
+    if (key != K_EVENT) {
+      redraw_frame_input();
+    }
+
     if (key == K_EVENT) {
       // An event handler may use the value of reg_executing.
       // Clear it if it should be cleared when getting the next character.
@@ -18,6 +18,7 @@
 #include "nvim/eval.h"
 #include "nvim/eval/typval_defs.h"
 #include "nvim/eval/vars.h"
+#include "nvim/fileio.h"
 #include "nvim/gettext_defs.h"
 #include "nvim/globals.h"
 #include "nvim/grid.h"
@@ -99,10 +100,13 @@ void win_redr_status(win_T *wp)
     char *p = NameBuff;
     int len = (int)strlen(p);
 
+    const int load_percent = buf_load_percent(wp->w_buffer);
+
     if ((bt_help(wp->w_buffer)
          || wp->w_p_pvw
          || bufIsChanged(wp->w_buffer)
-         || wp->w_buffer->b_p_ro)
+         || wp->w_buffer->b_p_ro
+         || load_percent >= 0)
         && len < MAXPATHL - 1) {
       *(p + len++) = ' ';
     }
@@ -120,6 +124,10 @@ void win_redr_status(win_T *wp)
     }
     if (wp->w_buffer->b_p_ro) {
       snprintf(p + len, MAXPATHL - (size_t)len, "%s", _("[RO]"));
+      len += (int)strlen(p + len);
+    }
+    if (load_percent >= 0) {
+      snprintf(p + len, MAXPATHL - (size_t)len, _("[loading %d%%]"), load_percent);
       // len += (int)strlen(p + len);  // dead assignment
     }
 
@@ -8,6 +8,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+
 #include "auto/config.h"
 #include "nvim/ascii_defs.h"
 #include "nvim/assert_defs.h"
@@ -32,6 +36,10 @@
 #include "nvim/types_defs.h"
 #include "nvim/vim_defs.h"
 
+#ifdef HAVE_AVX2_DISPATCH
+# include <immintrin.h>
+#endif
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "strings.c.generated.h"
 #endif
@@ -495,6 +503,66 @@ char *vim_strchr(const char *const string, const int c)
   }
 }
 
+#ifdef HAVE_AVX2_DISPATCH
+/// Part of xmemchr3() for CPUs with AVX2: check blocks of 32 bytes.
+///
+/// @return  index of the found byte, or of the first byte not checked.
+AVX2_TARGET static size_t xmemchr3_avx2(const char *p, size_t len, char c1, char c2, char c3)
+{
+  const __m256i v1 = _mm256_set1_epi8(c1);
+  const __m256i v2 = _mm256_set1_epi8(c2);
+  const __m256i v3 = _mm256_set1_epi8(c3);
+  size_t i = 0;
+  for (; i + 32 <= len; i += 32) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+    __m256i eq = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, v1),
+                                                 _mm256_cmpeq_epi8(v, v2)),
+                                 _mm256_cmpeq_epi8(v, v3));
+    unsigned mask = (unsigned)_mm256_movemask_epi8(eq);
+    if (mask != 0) {
+      return i + (size_t)__builtin_ctz(mask);
+    }
+  }
+  return i;
+}
+#endif
+
+/// Find the first byte in "p[len]" that is "c1", "c2" or "c3".  Give the same
+/// byte more than once to search for fewer bytes.  Faster than a loop for long
+/// runs without these bytes, e.g. to find the next NL or NUL in file contents.
+///
+/// @return  pointer to the byte, NULL when there is none.
+char *xmemchr3(const char *p, size_t len, char c1, char c2, char c3)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_PURE FUNC_ATTR_WARN_UNUSED_RESULT
+{
+  size_t i = 0;
+#ifdef HAVE_AVX2_DISPATCH
+  if (len >= 32 && __builtin_cpu_supports("avx2")) {
+    i = xmemchr3_avx2(p, len, c1, c2, c3);
+  }
+#endif
+#ifdef __SSE2__
+  const __m128i v1 = _mm_set1_epi8(c1);
+  const __m128i v2 = _mm_set1_epi8(c2);
+  const __m128i v3 = _mm_set1_epi8(c3);
+  for (; i + 16 <= len; i += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+    __m128i eq = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, v1), _mm_cmpeq_epi8(v, v2)),
+                              _mm_cmpeq_epi8(v, v3));
+    int mask = _mm_movemask_epi8(eq);
+    if (mask != 0) {
+      return (char *)p + i + __builtin_ctz((unsigned)mask);
+    }
+  }
+#endif
+  for (; i < len; i++) {
+    if (p[i] == c1 || p[i] == c2 || p[i] == c3) {
+      return (char *)p + i;
+    }
+  }
+  return NULL;
+}
+
 // Sort an array of strings.
 
 static int sort_compare(const void *s1, const void *s2)
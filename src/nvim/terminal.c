@@ -632,7 +632,7 @@ static int terminal_check(VimState *state)
   terminal_check_cursor();
   validate_cursor(curwin);
 
-  if (must_redraw) {
+  if (must_redraw && !redraw_frame_wait()) {
     update_screen();
 
     // Make sure an invoked autocmd doesn't delete the buffer (and the
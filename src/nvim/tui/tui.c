@@ -72,6 +72,21 @@ typedef struct {
   int top, bot, left, right;
 } Rect;
 
+/// Cost in bytes of cursor motion in one direction.
+typedef struct {
+  int step;  ///< one cell
+  int parm;  ///< "n" cells, for a one-digit "n"
+} MoveCost;
+
+/// Cost in bytes of control sequences, computed by init_costs().
+typedef struct {
+  int cr, home, cup, ech, rep;
+  MoveCost left, right, down, up;
+} TUICosts;
+
+/// Cost of a control sequence the terminal doesn't have.
+#define COST_NONE 0xffff
+
 struct TUIData {
   Loop *loop;
   unibi_var_t params[9];
@@ -98,12 +113,14 @@ struct TUIData {
   bool can_set_left_right_margin;
   bool can_scroll;
   bool can_erase_chars;
+  TUICosts cost;
   bool immediate_wrap_after_last_column;
   bool bce;
   bool mouse_enabled;
   bool mouse_move_enabled;
   bool title_enabled;
   bool sync_output;
+  bool in_frame;  ///< part of a frame was written, see flush_buf_partial()
   bool busy, is_invisible, want_invisible;
   bool cork, overflow;
   bool set_cursor_color_as_str;
@@ -401,6 +418,7 @@ static void terminfo_start(TUIData *tui)
     && !!unibi_get_str(tui->ut, unibi_insert_line)
     && !!unibi_get_str(tui->ut, unibi_parm_insert_line);
   tui->can_erase_chars = !!unibi_get_str(tui->ut, unibi_erase_chars);
+  init_costs(tui);
   tui->immediate_wrap_after_last_column =
     terminfo_is_term_family(term, "conemu")
     || terminfo_is_term_family(term, "cygwin")
@@ -835,29 +853,148 @@ static void print_cell(TUIData *tui, char *buf, sattr_T attr)
   }
 }
 
-static bool cheap_to_print(TUIData *tui, int row, int col, int next)
+/// Number of decimal digits of "n" >= 0.
+static int num_digits(int n)
 {
-  UGrid *grid = &tui->grid;
-  UCell *cell = grid->cells[row] + col;
-  while (next) {
-    next--;
-    if (attrs_differ(tui, cell->attr,
-                     tui->print_attr_id, tui->rgb)) {
-      if (tui->default_attr) {
-        return false;
-      }
+  int digits = 1;
+  while (n >= 10) {
+    n /= 10;
+    digits++;
+  }
+  return digits;
+}
+
+/// Number of bytes the terminfo string "cap" takes with parameters "p1" and
+/// "p2", or COST_NONE if the terminal doesn't have it.
+static int cap_cost(TUIData *tui, enum unibi_string cap, int p1, int p2)
+{
+  const char *str = unibi_get_str(tui->ut, cap);
+  if (str == NULL) {
+    return COST_NONE;
+  }
+  unibi_var_t params[9];
+  memset(params, 0, sizeof(params));
+  UNIBI_SET_NUM_VAR(params[0], p1);
+  UNIBI_SET_NUM_VAR(params[1], p2);
+  char buf[64];
+  size_t len = unibi_run(str, params, buf, sizeof(buf));
+  return len > 0 && len < sizeof(buf) ? (int)len : COST_NONE;
+}
+
+/// Computes the cost of the control sequences cursor_goto(), print_cells()
+/// and clear_region() choose from. Parameterized sequences are measured with
+/// one-digit parameters, see param_cost().
+static void init_costs(TUIData *tui)
+{
+  TUICosts *cost = &tui->cost;
+  cost->cr = cap_cost(tui, unibi_carriage_return, 0, 0);
+  cost->home = cap_cost(tui, unibi_cursor_home, 0, 0);
+  cost->cup = cap_cost(tui, unibi_cursor_address, 1, 1);
+  cost->ech = cap_cost(tui, unibi_erase_chars, 2, 0);
+  cost->rep = cap_cost(tui, unibi_repeat_char, 'x', 2);
+  cost->left = (MoveCost){ cap_cost(tui, unibi_cursor_left, 0, 0),
+                           cap_cost(tui, unibi_parm_left_cursor, 2, 0) };
+  cost->right = (MoveCost){ cap_cost(tui, unibi_cursor_right, 0, 0),
+                            cap_cost(tui, unibi_parm_right_cursor, 2, 0) };
+  cost->down = (MoveCost){ cap_cost(tui, unibi_cursor_down, 0, 0),
+                           cap_cost(tui, unibi_parm_down_cursor, 2, 0) };
+  cost->up = (MoveCost){ cap_cost(tui, unibi_cursor_up, 0, 0),
+                         cap_cost(tui, unibi_parm_up_cursor, 2, 0) };
+}
+
+/// Cost of a sequence measured by init_costs() when its parameter is "n".
+static int param_cost(int cost, int n)
+{
+  return cost == COST_NONE ? COST_NONE : cost + num_digits(n) - 1;
+}
+
+/// Cost of moving the cursor "n" cells in one direction, by repeating the
+/// single step or with the parameterized sequence, whichever is shorter.
+static int move_cost(MoveCost cost, int n)
+{
+  if (n == 0) {
+    return 0;
+  }
+  int steps = cost.step == COST_NONE || n > COST_NONE / cost.step ? COST_NONE : n * cost.step;
+  return MIN(steps, param_cost(cost.parm, n));
+}
+
+static void move_out(TUIData *tui, MoveCost cost, enum unibi_string step,
+                     enum unibi_string parm, int n)
+{
+  if (n == 0) {
+    return;
+  }
+  if (cost.step != COST_NONE && n * cost.step <= param_cost(cost.parm, n)) {
+    while (n--) {
+      unibi_out(tui, step);
     }
-    if (schar_get_ascii(cell->data) == 0) {
-      return false;  // not ascii
+  } else {
+    UNIBI_SET_NUM_VAR(tui->params[0], n);
+    unibi_out(tui, parm);
+  }
+}
+
+/// Cost of moving right from "from" to "to" by printing the cells in between
+/// again, or COST_NONE if that would change what they look like.
+static int reprint_cost(TUIData *tui, int row, int from, int to)
+{
+  if (tui->print_attr_id < 0 || kv_A(tui->attrs, (size_t)tui->print_attr_id).url >= 0) {
+    return COST_NONE;  // the hyperlink was ended before moving
+  }
+  UCell *cells = tui->grid.cells[row];
+  for (int col = from; col < to; col++) {
+    if (schar_get_ascii(cells[col].data) == 0
+        || attrs_differ(tui, cells[col].attr, tui->print_attr_id, tui->rgb)) {
+      return COST_NONE;
+    }
+  }
+  return to - from;
+}
+
+/// Cost of moving from column "from" to column "to" in "row".
+static int horiz_cost(TUIData *tui, int row, int from, int to)
+{
+  if (to <= from) {
+    return move_cost(tui->cost.left, from - to);
+  }
+  return MIN(move_cost(tui->cost.right, to - from), reprint_cost(tui, row, from, to));
+}
+
+static void horiz_out(TUIData *tui, int row, int from, int to)
+{
+  if (to <= from) {
+    move_out(tui, tui->cost.left, unibi_cursor_left, unibi_parm_left_cursor, from - to);
+  } else if (reprint_cost(tui, row, from, to) <= move_cost(tui->cost.right, to - from)) {
+    UCell *cells = tui->grid.cells[row];
+    for (int col = from; col < to; col++) {
+      char c = schar_get_ascii(cells[col].data);
+      out(tui, &c, 1);
     }
-    cell++;
+  } else {
+    move_out(tui, tui->cost.right, unibi_cursor_right, unibi_parm_right_cursor, to - from);
   }
-  return true;
 }
 
-/// This optimizes several cases where it is cheaper to do something other
-/// than send a full cursor positioning control sequence.  However, there are
-/// some further optimizations that may seem obvious but that will not work.
+static int vert_cost(TUIData *tui, int from, int to)
+{
+  return to >= from ? move_cost(tui->cost.down, to - from) : move_cost(tui->cost.up, from - to);
+}
+
+static void vert_out(TUIData *tui, int from, int to)
+{
+  if (to >= from) {
+    move_out(tui, tui->cost.down, unibi_cursor_down, unibi_parm_down_cursor, to - from);
+  } else {
+    move_out(tui, tui->cost.up, unibi_cursor_up, unibi_parm_up_cursor, from - to);
+  }
+}
+
+/// Moves the cursor with the shortest control sequences, comparing absolute
+/// positioning, home, relative motion from the current position and relative
+/// motion after a CR. Moving right may print cells again instead.
+///
+/// Some further optimizations may seem obvious but will not work.
 ///
 /// We cannot use VT (ASCII 0/11) for moving the cursor up, because VT means
 /// move the cursor down on a DEC terminal.  Similarly, on a DEC terminal FF
@@ -877,91 +1014,59 @@ static void cursor_goto(TUIData *tui, int row, int col)
     tui->url = -1;
   }
 
-  if (0 == row && 0 == col) {
-    unibi_out(tui, unibi_cursor_home);
-    ugrid_goto(grid, row, col);
-    return;
-  }
-  if (grid->row == -1) {
-    goto safe_move;
-  }
-  if (0 == col
-      ? col != grid->col
-      : (row != grid->row
-         ? false
-         : (1 == col
-            ? (2 < grid->col && cheap_to_print(tui, grid->row, 0, col))
-            : (2 == col
-               ? (5 < grid->col && cheap_to_print(tui, grid->row, 0, col))
-               : false)))) {
-    // Motion to left margin from anywhere else, or CR + printing chars is
-    // even less expensive than using BSes or CUB.
-    unibi_out(tui, unibi_carriage_return);
-    ugrid_goto(grid, grid->row, 0);
-  }
-  if (row == grid->row) {
-    if (col < grid->col
-        // Deferred right margin wrap terminals have inconsistent ideas about
-        // where the cursor actually is during a deferred wrap.  Relative
-        // motion calculations have OBOEs that cannot be compensated for,
-        // because two terminals that claim to be the same will implement
-        // different cursor positioning rules.
-        && (tui->immediate_wrap_after_last_column || grid->col < tui->width)) {
-      int n = grid->col - col;
-      if (n <= 4) {  // This might be just BS, so it is considered really cheap.
-        while (n--) {
-          unibi_out(tui, unibi_cursor_left);
-        }
-      } else {
-        UNIBI_SET_NUM_VAR(tui->params[0], n);
-        unibi_out(tui, unibi_parm_left_cursor);
-      }
-      ugrid_goto(grid, row, col);
-      return;
-    } else if (col > grid->col) {
-      int n = col - grid->col;
-      if (n <= 2) {
-        while (n--) {
-          unibi_out(tui, unibi_cursor_right);
+  TUICosts *cost = &tui->cost;
+  enum { kGotoAbs, kGotoHome, kGotoRel, kGotoCR } how = kGotoAbs;
+  int best = param_cost(param_cost(cost->cup, row + 1), col + 1);
+  if (row == 0 && col == 0 && cost->home < best) {
+    how = kGotoHome;
+    best = cost->home;
+  }
+  if (grid->row != -1) {
+    // Deferred right margin wrap terminals have inconsistent ideas about
+    // where the cursor actually is during a deferred wrap.  Relative
+    // motion calculations have OBOEs that cannot be compensated for,
+    // because two terminals that claim to be the same will implement
+    // different cursor positioning rules. CR is fine, it always ends up in
+    // the left margin.
+    if (tui->immediate_wrap_after_last_column || grid->col < tui->width) {
+      int rel = vert_cost(tui, grid->row, row);
+      if (rel < best) {
+        rel += horiz_cost(tui, row, grid->col, col);
+        if (rel < best) {
+          how = kGotoRel;
+          best = rel;
         }
-      } else {
-        UNIBI_SET_NUM_VAR(tui->params[0], n);
-        unibi_out(tui, unibi_parm_right_cursor);
       }
-      ugrid_goto(grid, row, col);
-      return;
     }
-  }
-  if (col == grid->col) {
-    if (row > grid->row) {
-      int n = row - grid->row;
-      if (n <= 4) {  // This might be just LF, so it is considered really cheap.
-        while (n--) {
-          unibi_out(tui, unibi_cursor_down);
-        }
-      } else {
-        UNIBI_SET_NUM_VAR(tui->params[0], n);
-        unibi_out(tui, unibi_parm_down_cursor);
-      }
-      ugrid_goto(grid, row, col);
-      return;
-    } else if (row < grid->row) {
-      int n = grid->row - row;
-      if (n <= 2) {
-        while (n--) {
-          unibi_out(tui, unibi_cursor_up);
+    if (cost->cr < best) {
+      int rel = cost->cr + vert_cost(tui, grid->row, row);
+      if (rel < best) {
+        rel += horiz_cost(tui, row, 0, col);
+        if (rel < best) {
+          how = kGotoCR;
+          best = rel;
         }
-      } else {
-        UNIBI_SET_NUM_VAR(tui->params[0], n);
-        unibi_out(tui, unibi_parm_up_cursor);
       }
-      ugrid_goto(grid, row, col);
-      return;
     }
   }
 
-safe_move:
-  unibi_goto(tui, row, col);
+  switch (how) {
+  case kGotoAbs:
+    unibi_goto(tui, row, col);
+    break;
+  case kGotoHome:
+    unibi_out(tui, unibi_cursor_home);
+    break;
+  case kGotoRel:
+    vert_out(tui, grid->row, row);
+    horiz_out(tui, row, grid->col, col);
+    break;
+  case kGotoCR:
+    unibi_out(tui, unibi_carriage_return);
+    vert_out(tui, grid->row, row);
+    horiz_out(tui, row, 0, col);
+    break;
+  }
   ugrid_goto(grid, row, col);
 }
 
@@ -1016,6 +1121,46 @@ static void print_cell_at_pos(TUIData *tui, int row, int col, UCell *cell, bool
   }
 }
 
+/// Prints the cells from "startcol" to "endcol" of "row". Runs of the same
+/// ASCII character are sent as REP when that is shorter.
+static void print_cells(TUIData *tui, int row, int startcol, int endcol)
+{
+  UGrid *grid = &tui->grid;
+  UCell *cells = grid->cells[row];
+  for (int col = startcol; col < endcol; col++) {
+    int n = repeat_run(tui, cells, col, endcol);
+    if (n > 0) {
+      cursor_goto(tui, row, col);
+      update_attrs(tui, cells[col].attr);
+      UNIBI_SET_NUM_VAR(tui->params[0], schar_get_ascii(cells[col].data));
+      UNIBI_SET_NUM_VAR(tui->params[1], n);
+      unibi_out(tui, unibi_repeat_char);
+      grid->col += n;
+      col += n - 1;
+    } else {
+      print_cell_at_pos(tui, row, col, &cells[col],
+                        col < endcol - 1 && cells[col + 1].data == NUL);
+    }
+  }
+}
+
+/// Length of the run of cells equal to "cells[col]" which is cheaper to send
+/// as REP than to print, or 0. The run stays clear of the right margin, so
+/// that wrapping works as with printed cells.
+static int repeat_run(TUIData *tui, UCell *cells, int col, int endcol)
+{
+  if (tui->cost.rep == COST_NONE || schar_get_ascii(cells[col].data) == 0) {
+    return 0;
+  }
+  int end = MIN(endcol, tui->width - 1);
+  int n = 1;
+  while (col + n < end && cells[col + n].data == cells[col].data
+         && cells[col + n].attr == cells[col].attr) {
+    n++;
+  }
+  return param_cost(tui->cost.rep, n) < n ? n : 0;
+}
+
 static void clear_region(TUIData *tui, int top, int bot, int left, int right, int attr_id)
 {
   UGrid *grid = &tui->grid;
@@ -1041,7 +1186,8 @@ static void clear_region(TUIData *tui, int top, int bot, int left, int right, in
       cursor_goto(tui, row, left);
       if (tui->can_clear_attr && right == tui->width) {
         unibi_out(tui, unibi_clr_eol);
-      } else if (tui->can_erase_chars && tui->can_clear_attr && width >= 5) {
+      } else if (tui->can_erase_chars && tui->can_clear_attr
+                 && param_cost(tui->cost.ech, width) < width) {
         UNIBI_SET_NUM_VAR(tui->params[0], width);
         unibi_out(tui, unibi_erase_chars);
       } else {
@@ -1460,10 +1606,7 @@ void tui_flush(TUIData *tui)
         }
       }
 
-      UGRID_FOREACH_CELL(grid, row, r.left, clear_col, {
-        print_cell_at_pos(tui, row, curcol, cell,
-                          curcol < clear_col - 1 && (cell + 1)->data == NUL);
-      });
+      print_cells(tui, row, r.left, clear_col);
       if (clear_col < r.right) {
         clear_region(tui, row, row + 1, clear_col, r.right, clear_attr);
       }
@@ -1632,10 +1775,7 @@ void tui_raw_line(TUIData *tui, Integer g, Integer linerow, Integer startcol, In
     assert((size_t)attrs[c - startcol] < kv_size(tui->attrs));
     grid->cells[linerow][c].attr = attrs[c - startcol];
   }
-  UGRID_FOREACH_CELL(grid, (int)linerow, (int)startcol, (int)endcol, {
-    print_cell_at_pos(tui, (int)linerow, curcol, cell,
-                      curcol < endcol - 1 && (cell + 1)->data == NUL);
-  });
+  print_cells(tui, (int)linerow, (int)startcol, (int)endcol);
 
   if (clearcol > endcol) {
     ugrid_clear_chunk(grid, (int)linerow, (int)endcol, (int)clearcol,
@@ -1764,7 +1904,7 @@ retry: \
       unibi_format(vars, vars + 26, str, params, out, tui, pad, tui); \
       if (tui->overflow) { \
         tui->bufpos = orig_pos; \
-        flush_buf(tui); \
+        flush_buf_partial(tui); \
         goto retry; \
       } \
       tui->cork = false; \
@@ -1795,7 +1935,7 @@ static void out(void *ctx, const char *str, size_t len)
       tui->overflow = true;
       return;
     }
-    flush_buf(tui);
+    flush_buf_partial(tui);
   }
 
   memcpy(tui->buf + tui->bufpos, str, len);
@@ -1821,7 +1961,7 @@ static void pad(void *ctx, size_t delay, int scale FUNC_ATTR_UNUSED, int force)
     return;
   }
 
-  flush_buf(tui);
+  flush_buf_partial(tui);
   uv_sleep((unsigned)(delay/10));
 }
 
@@ -2010,6 +2150,11 @@ static void patch_terminfo_bugs(TUIData *tui, const char *term, const char *colo
         ILOG("Disabling smgrp with TERM=xterm for non-xterm.");
         unibi_set_str(ut, unibi_set_right_margin_parm, NULL);
       }
+      // Many xterm-likes print the escape sequence of REP as text.
+      if (unibi_get_str(ut, unibi_repeat_char)) {
+        ILOG("Disabling rep with TERM=xterm for non-xterm.");
+        unibi_set_str(ut, unibi_repeat_char, NULL);
+      }
     }
 
 #ifdef MSWIN
@@ -2042,6 +2187,10 @@ static void patch_terminfo_bugs(TUIData *tui, const char *term, const char *colo
       ILOG("Disabling smgrp with TERM=screen.xterm for screen.");
       unibi_set_str(ut, unibi_set_right_margin_parm, NULL);
     }
+    if (unibi_get_str(ut, unibi_repeat_char)) {
+      ILOG("Disabling rep with TERM=screen.xterm for screen.");
+      unibi_set_str(ut, unibi_repeat_char, NULL);
+    }
   } else if (tmux) {
     unibi_set_if_empty(ut, unibi_to_status_line, "\x1b_");
     unibi_set_if_empty(ut, unibi_from_status_line, "\x1b\\");
@@ -2409,6 +2558,9 @@ static size_t flush_buf_start(TUIData *tui, char *buf, size_t len)
 
   const char *str = NULL;
   if (tui->sync_output && tui->unibi_ext.sync != -1) {
+    if (tui->in_frame) {
+      return 0;  // the synchronized update is still going on
+    }
     UNIBI_SET_NUM_VAR(params[0], 1);
     str = unibi_get_ext_str(tui->ut, (size_t)tui->unibi_ext.sync);
   } else if (!tui->is_invisible) {
@@ -2429,11 +2581,19 @@ static size_t flush_buf_start(TUIData *tui, char *buf, size_t len)
 ///
 /// @param buf  the buffer to write the sequence to
 /// @param len  the length of `buf`
-static size_t flush_buf_end(TUIData *tui, char *buf, size_t len)
+/// @param end_frame  false if more output of the same frame follows
+static size_t flush_buf_end(TUIData *tui, char *buf, size_t len, bool end_frame)
   FUNC_ATTR_NONNULL_ALL
 {
   unibi_var_t params[9];  // Don't use tui->params[] as they may already be in use.
 
+  tui->in_frame = !end_frame;
+  if (!end_frame) {
+    // Keep the update synchronized, or the cursor hidden, until the rest of
+    // the frame is written.
+    return 0;
+  }
+
   size_t offset = 0;
   if (tui->sync_output && tui->unibi_ext.sync != -1) {
     UNIBI_SET_NUM_VAR(params[0], 0);
@@ -2462,13 +2622,27 @@ static size_t flush_buf_end(TUIData *tui, char *buf, size_t len)
 ///
 /// @see tui_flush
 static void flush_buf(TUIData *tui)
+{
+  flush_buf_ex(tui, true);
+}
+
+/// Flushes the buffer when it is full, in the middle of a frame. The terminal
+/// is told to hold off updating the screen until the frame is complete, so
+/// that it never shows half of it.
+static void flush_buf_partial(TUIData *tui)
+{
+  flush_buf_ex(tui, false);
+}
+
+static void flush_buf_ex(TUIData *tui, bool end_frame)
 {
   uv_write_t req;
   uv_buf_t bufs[3];
   char pre[32];
   char post[32];
 
-  if (tui->bufpos <= 0 && tui->is_invisible == should_invisible(tui)) {
+  if (tui->bufpos <= 0 && tui->is_invisible == should_invisible(tui)
+      && (!end_frame || !tui->in_frame)) {
     return;
   }
 
@@ -2479,7 +2653,7 @@ static void flush_buf(TUIData *tui)
   bufs[1].len = UV_BUF_LEN(tui->bufpos);
 
   bufs[2].base = post;
-  bufs[2].len = UV_BUF_LEN(flush_buf_end(tui, post, sizeof(post)));
+  bufs[2].len = UV_BUF_LEN(flush_buf_end(tui, post, sizeof(post), end_frame));
 
   if (tui->screenshot) {
     for (size_t i = 0; i < ARRAY_SIZE(bufs); i++) {
@@ -86,7 +86,7 @@ void ui_client_attach(int width, int height, char *term, bool rgb)
   ADD_C(args, INTEGER_OBJ(width));
   ADD_C(args, INTEGER_OBJ(height));
 
-  MAXSIZE_TEMP_DICT(opts, 9);
+  MAXSIZE_TEMP_DICT(opts, 10);
   PUT_C(opts, "rgb", BOOLEAN_OBJ(rgb));
   PUT_C(opts, "ext_linegrid", BOOLEAN_OBJ(true));
   PUT_C(opts, "ext_termcolors", BOOLEAN_OBJ(true));
@@ -102,6 +102,12 @@ void ui_client_attach(int width, int height, char *term, bool rgb)
       PUT_C(opts, "stdin_fd", INTEGER_OBJ(UI_CLIENT_STDIN_FD));
       ui_client_forward_stdin = false;  // stdin shouldn't be forwarded again #22292
     }
+    // The embedded server runs on the same machine, let it send redraws
+    // through shared memory.
+    const char *ring = rpc_ring_create(ui_client_channel_id);
+    if (ring) {
+      PUT_C(opts, "shm_ring", CSTR_AS_OBJ(ring));
+    }
   }
   ADD_C(args, DICTIONARY_OBJ(opts));
 
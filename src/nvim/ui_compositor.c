@@ -56,6 +56,15 @@ static schar_T msg_sep_char = schar_from_ascii(' ');
 
 static int dbghl_normal, dbghl_clear, dbghl_composed, dbghl_recompose;
 
+/// Occupancy index: the layers above the default grid which cover each screen
+/// row, in layer order. Row "r" uses occ_grids[occ_rows[r]] up to
+/// occ_grids[occ_rows[r + 1]]. Rebuilt by occ_update() when a layer was
+/// added, removed, moved or resized.
+static kvec_t(ScreenGrid *) occ_grids = KV_INITIAL_VALUE;
+static size_t *occ_rows = NULL;
+static int occ_nrows = -1;
+static bool occ_valid = false;
+
 void ui_comp_init(void)
 {
   kv_push(layers, &default_grid);
@@ -66,6 +75,8 @@ void ui_comp_init(void)
 void ui_comp_free_all_mem(void)
 {
   kv_destroy(layers);
+  kv_destroy(occ_grids);
+  xfree(occ_rows);
   xfree(linebuf);
   xfree(attrbuf);
 }
@@ -171,6 +182,7 @@ bool ui_comp_put_grid(ScreenGrid *grid, int row, int col, int height, int width,
     grid->comp_col = col;
     grid->comp_index = insert_at;
   }
+  occ_valid = false;
   if (moved && valid && ui_comp_should_draw()) {
     compose_area(grid->comp_row, grid->comp_row + grid->rows,
                  grid->comp_col, grid->comp_col + grid->cols);
@@ -196,6 +208,7 @@ void ui_comp_remove_grid(ScreenGrid *grid)
   }
   (void)kv_pop(layers);
   grid->comp_index = 0;
+  occ_valid = false;
 
   // recompose the area under the grid
   // inefficient when being overlapped: only draw up to grid->comp_index
@@ -230,6 +243,7 @@ void ui_comp_raise_grid(ScreenGrid *grid, size_t new_index)
   }
   kv_A(layers, new_index) = grid;
   grid->comp_index = new_index;
+  occ_valid = false;
   for (size_t i = old_index; i < new_index; i++) {
     ScreenGrid *grid2 = kv_A(layers, i);
     int startcol = MAX(grid->comp_col, grid2->comp_col);
@@ -325,10 +339,13 @@ static void compose_line(Integer row, Integer startcol, Integer endcol, LineFlag
   sattr_T *bg_attrs = &default_grid.attrs[default_grid.line_offset[row]
                                           + (size_t)startcol];
 
+  ScreenGrid **row_grids;
+  size_t n_row_grids = occ_row(row, &row_grids);
+
   while (col < endcol) {
     int until = 0;
-    for (size_t i = 0; i < kv_size(layers); i++) {
-      ScreenGrid *g = kv_A(layers, i);
+    for (size_t i = 0; i <= n_row_grids; i++) {
+      ScreenGrid *g = i == 0 ? kv_A(layers, 0) : row_grids[i - 1];
       // compose_line may have been called after a shrinking operation but
       // before the resize has actually been applied. Therefore, we need to
       // first check to see if any grids have pending updates to width/height,
@@ -532,23 +549,154 @@ void ui_comp_raw_line(Integer grid, Integer row, Integer startcol, Integer endco
     endcol = MIN(endcol, clearcol);
   }
 
-  bool covered = curgrid_covered_above((int)row);
+  int cover_start;
+  int cover_end;
   // TODO(bfredl): eventually should just fix compose_line to respect clearing
-  // and optimize it for uncovered lines.
-  if (flags & kLineFlagInvalid || covered || curgrid->blending) {
+  if (flags & kLineFlagInvalid || curgrid->blending) {
     compose_debug(row, row + 1, startcol, clearcol, dbghl_composed, true);
     compose_line(row, startcol, clearcol, flags);
+  } else if (!covered_cols((int)row, (int)startcol, (int)clearcol, &cover_start, &cover_end)) {
+    forward_line(row, startcol, endcol, clearcol, clearattr, flags, chunk, attrs);
   } else {
-    compose_debug(row, row + 1, startcol, endcol, dbghl_normal, endcol >= clearcol);
-    compose_debug(row, row + 1, endcol, clearcol, dbghl_clear, true);
-#ifndef NDEBUG
-    for (int i = 0; i < endcol - startcol; i++) {
-      assert(attrs[i] >= 0);
+    // Only compose the columns under other grids, the columns on either side
+    // are sent as they are. A doublewidth char is not split between them.
+    if (cover_start > startcol && cover_start < endcol && chunk[cover_start - startcol] == NUL) {
+      cover_start--;
+    }
+    if (cover_end < endcol && chunk[cover_end - startcol] == NUL) {
+      cover_end++;
+    }
+    LineFlags last_flags = flags;
+    flags &= ~kLineFlagWrap;
+    if (cover_start > startcol) {
+      forward_line(row, startcol, MIN(endcol, cover_start), cover_start, clearattr, flags,
+                   chunk, attrs);
     }
+    compose_debug(row, row + 1, cover_start, cover_end, dbghl_composed, true);
+    compose_line(row, cover_start, cover_end, cover_end < clearcol ? flags : last_flags);
+    if (cover_end < clearcol) {
+      Integer off = MIN(cover_end, endcol) - startcol;
+      forward_line(row, cover_end, MAX(endcol, cover_end), clearcol, clearattr, last_flags,
+                   chunk + off, attrs + off);
+    }
+  }
+}
+
+/// Sends a line of "curgrid" to the composed UIs as it is.
+static void forward_line(Integer row, Integer startcol, Integer endcol, Integer clearcol,
+                         Integer clearattr, LineFlags flags, const schar_T *chunk,
+                         const sattr_T *attrs)
+{
+  compose_debug(row, row + 1, startcol, endcol, dbghl_normal, endcol >= clearcol);
+  compose_debug(row, row + 1, endcol, clearcol, dbghl_clear, true);
+#ifndef NDEBUG
+  for (int i = 0; i < endcol - startcol; i++) {
+    assert(attrs[i] >= 0);
+  }
 #endif
-    ui_composed_call_raw_line(1, row, startcol, endcol, clearcol, clearattr,
-                              flags, chunk, attrs);
+  ui_composed_call_raw_line(1, row, startcol, endcol, clearcol, clearattr,
+                            flags, chunk, attrs);
+}
+
+/// Finds the columns of "row" between "startcol" and "endcol" which grids
+/// above "curgrid" cover.
+///
+/// @param[out] cover_start  first covered column
+/// @param[out] cover_end  column after the last covered column
+/// @return false if no column is covered.
+static bool covered_cols(int row, int startcol, int endcol, int *cover_start, int *cover_end)
+{
+  if (row == msg_sep_row && curgrid->comp_index <= msg_grid.comp_index) {
+    *cover_start = startcol;
+    *cover_end = endcol;
+    return true;
+  }
+
+  *cover_start = endcol;
+  *cover_end = startcol;
+  ScreenGrid **row_grids;
+  size_t n_row_grids = occ_row(row, &row_grids);
+  for (size_t i = n_row_grids; i > 0; i--) {
+    ScreenGrid *g = row_grids[i - 1];
+    if (g->comp_index <= curgrid->comp_index) {
+      break;
+    }
+    if (g->comp_disabled || row >= g->comp_row + MIN(g->rows, g->comp_height)) {
+      continue;
+    }
+    int start = MAX(g->comp_col, startcol);
+    int end = MIN(g->comp_col + MIN(g->cols, g->comp_width), endcol);
+    if (start < end) {
+      *cover_start = MIN(*cover_start, start);
+      *cover_end = MAX(*cover_end, end);
+    }
+  }
+  return *cover_start < *cover_end;
+}
+
+/// Gets the grids in the occupancy index for "row".
+///
+/// @param[out] grids  the grids, in layer order
+/// @return number of grids
+static size_t occ_row(int row, ScreenGrid ***grids)
+{
+  occ_update();
+  if (row < 0 || row >= occ_nrows) {
+    return 0;
+  }
+  *grids = occ_grids.items + occ_rows[row];
+  return occ_rows[row + 1] - occ_rows[row];
+}
+
+/// Rebuilds the occupancy index if a layer changed since it was last built.
+static void occ_update(void)
+{
+  int nrows = default_grid.rows;
+  if (occ_valid && occ_nrows == nrows) {
+    return;
+  }
+
+  // Count the grids of each row in occ_rows[row + 2], turn that into the
+  // start of row + 1 in occ_rows[row + 1], and then move the start to the
+  // end while filling in the grids.
+  occ_rows = xrealloc(occ_rows, (size_t)(nrows + 2) * sizeof(*occ_rows));
+  memset(occ_rows, 0, (size_t)(nrows + 2) * sizeof(*occ_rows));
+  for (size_t i = 1; i < kv_size(layers); i++) {
+    int top, bot;
+    occ_span(kv_A(layers, i), nrows, &top, &bot);
+    for (int r = top; r < bot; r++) {
+      occ_rows[r + 2]++;
+    }
+  }
+  for (int r = 2; r < nrows + 2; r++) {
+    occ_rows[r] += occ_rows[r - 1];
+  }
+  kv_size(occ_grids) = 0;
+  kv_ensure_space(occ_grids, occ_rows[nrows + 1]);
+  kv_size(occ_grids) = occ_rows[nrows + 1];
+  for (size_t i = 1; i < kv_size(layers); i++) {
+    ScreenGrid *g = kv_A(layers, i);
+    int top, bot;
+    occ_span(g, nrows, &top, &bot);
+    for (int r = top; r < bot; r++) {
+      kv_A(occ_grids, occ_rows[r + 1]++) = g;
+    }
+  }
+
+  occ_nrows = nrows;
+  occ_valid = true;
+}
+
+/// Rows of the screen which "grid" may cover. The message grid also covers
+/// the separator row above it.
+static void occ_span(ScreenGrid *grid, int nrows, int *top, int *bot)
+{
+  *top = grid->comp_row;
+  if (grid == &msg_grid && msg_sep_row >= 0) {
+    *top = MIN(*top, msg_sep_row);
   }
+  *top = MAX(*top, 0);
+  *bot = MIN(grid->comp_row + grid->comp_height, nrows);
 }
 
 /// The screen is invalid and will soon be cleared
@@ -560,6 +708,7 @@ bool ui_comp_set_screen_valid(bool valid)
   valid_screen = valid;
   if (!valid) {
     msg_sep_row = -1;
+    occ_valid = false;
   }
   return old_val;
 }
@@ -575,6 +724,7 @@ void ui_comp_msg_set_pos(Integer grid, Integer row, Boolean scrolled, String sep
   } else {
     msg_sep_row = -1;
   }
+  occ_valid = false;
 
   if (row > msg_current_row && ui_comp_should_draw()) {
     compose_area(MAX(msg_current_row - 1, 0), row, 0, default_grid.cols);
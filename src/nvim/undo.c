@@ -356,6 +356,9 @@ static inline void zero_fmark_additional_data(fmark_T *fmarks)
 /// Returns FAIL when lines could not be saved, OK otherwise.
 int u_savecommon(buf_T *buf, linenr_T top, linenr_T bot, linenr_T newbot, bool reload)
 {
+  // Only change the buffer when the whole file has been read.
+  buf_load_wait(buf);
+
   if (!reload) {
     // When making changes is not allowed return FAIL.  It's a crude way
     // to make all change commands fail.
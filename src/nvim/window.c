@@ -5196,6 +5196,7 @@ void win_free(win_T *wp, tabpage_T *tp)
   block_autocmds();
 
   set_destroy(uint32_t, &wp->w_ns_set);
+  decor_cache_free(wp);
 
   clear_winopt(&wp->w_onebuf_opt);
   clear_winopt(&wp->w_allbuf_opt);
@@ -5217,6 +5218,7 @@ void win_free(win_T *wp, tabpage_T *tp)
   }
 
   xfree(wp->w_lines);
+  xfree(wp->w_plines_cache);
 
   for (int i = 0; i < wp->w_tagstacklen; i++) {
     xfree(wp->w_tagstack[i].tagname);
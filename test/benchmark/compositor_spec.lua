@@ -0,0 +1,60 @@
+local n = require('test.functional.testnvim')()
+local Screen = require('test.functional.ui.screen')
+
+local clear = n.clear
+local exec_lua = n.exec_lua
+
+local width, height = 200, 60
+-- Number of redraws, set NVIM_BENCH_UI_REDRAWS for a smaller run.
+local redraws = tonumber(os.getenv('NVIM_BENCH_UI_REDRAWS')) or 500
+
+--- Opens "floats" floating windows spread over the screen and measures how
+--- long "redraws" redraws of the text below them take.
+local function run(floats)
+  return exec_lua(
+    [[
+    local floats, redraws = ...
+    local buf = vim.api.nvim_create_buf(false, true)
+    vim.api.nvim_buf_set_lines(buf, 0, -1, true, { 'float', 'text' })
+    for i = 1, floats do
+      vim.api.nvim_open_win(buf, false, {
+        relative = 'editor',
+        row = (i * 7) % (vim.o.lines - 6),
+        col = (i * 37) % (vim.o.columns - 20),
+        width = 20,
+        height = 3,
+        style = 'minimal',
+      })
+    end
+
+    local lines = {}
+    local ts = vim.uv.hrtime()
+    for i = 1, redraws do
+      for row = 1, vim.o.lines do
+        lines[row] = ('%d:%d '):format(i, row):rep(vim.o.columns / 8)
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+      vim.cmd('redraw')
+    end
+    return (vim.uv.hrtime() - ts) / 1000000
+  ]],
+    floats,
+    redraws
+  )
+end
+
+describe('compositor', function()
+  before_each(function()
+    clear()
+    local screen = Screen.new(width, height)
+    screen:attach()
+  end)
+
+  for _, floats in ipairs({ 0, 50 }) do
+    it(('%d redraws below %d floating windows'):format(redraws, floats), function()
+      local ms = run(floats)
+      print()
+      print(('%14.6f ms - %d floats'):format(ms, floats))
+    end)
+  end
+end)
@@ -12,8 +12,12 @@ describe('extmark perf', function()
       function start()
         ts = vim.uv.hrtime()
       end
-      function stop(name)
-        out[#out+1] = ('%14.6f ms - %s'):format((vim.uv.hrtime() - ts) / 1000000, name)
+      function stop(name, count)
+        local ms = (vim.uv.hrtime() - ts) / 1000000
+        if count then
+          name = ('%s (%d/ms)'):format(name, count / ms)
+        end
+        out[#out+1] = ('%14.6f ms - %s'):format(ms, name)
       end
     ]])
   end)
@@ -42,4 +46,156 @@ describe('extmark perf', function()
       stop('nvim_buf_clear_namespace')
     ]])
   end)
+
+  for _, size in ipairs({ 10000, 100000 }) do
+    it(('setting %d highlight marks'):format(size), function()
+      exec_lua(
+        [[
+        local N = ...
+        local lines = {}
+        for i = 1, N / 10 do
+          lines[i] = ('local foo_%d = bar(baz, %d) -- comment'):format(i, i)
+        end
+        vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+        -- marks of another plugin, which are kept when the namespace is replaced
+        local ns0 = vim.api.nvim_create_namespace('ns0')
+        for i = 0, N / 10 - 1 do
+          vim.api.nvim_buf_set_extmark(0, ns0, i, 0, { sign_text = 'x' })
+        end
+        local ns = vim.api.nvim_create_namespace('ns')
+
+        -- ten "semantic tokens" on every line
+        local marks = {}
+        for i = 0, N - 1 do
+          local row, col = math.floor(i / 10), (i % 10) * 3
+          marks[#marks + 1] = { row, col, { end_col = col + 3, hl_group = 'Keyword' } }
+        end
+
+        start()
+        for _, m in ipairs(marks) do
+          vim.api.nvim_buf_set_extmark(0, ns, m[1], m[2], m[3])
+        end
+        stop(('nvim_buf_set_extmark %d marks'):format(N), N)
+
+        vim.api.nvim_buf_clear_namespace(0, ns, 0, -1)
+        start()
+        vim.api.nvim_buf_set_extmarks(0, ns, marks, {})
+        stop(('nvim_buf_set_extmarks %d marks'):format(N), N)
+
+        start()
+        vim.api.nvim_buf_clear_namespace(0, ns, 0, -1)
+        for _, m in ipairs(marks) do
+          vim.api.nvim_buf_set_extmark(0, ns, m[1], m[2], m[3])
+        end
+        stop(('clear + nvim_buf_set_extmark %d marks'):format(N), N)
+
+        start()
+        vim.api.nvim_buf_set_extmarks(0, ns, marks, { replace = true })
+        stop(('nvim_buf_set_extmarks replace %d marks'):format(N), N)
+      ]],
+        size
+      )
+    end)
+  end
+
+  it('getting 100000 marks', function()
+    exec_lua([[
+      local lines = {}
+      for i = 1, 10000 do
+        lines[i] = ('local foo_%d = bar(baz, %d) -- comment'):format(i, i)
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+      local ns = vim.api.nvim_create_namespace('ns')
+      for i = 0, 99999 do
+        local row, col = math.floor(i / 10), (i % 10) * 3
+        local opts = { end_col = col + 3, hl_group = 'Keyword' }
+        if i % 1000 == 0 then
+          opts.virt_lines = { { { 'virtual line' } } }
+        end
+        vim.api.nvim_buf_set_extmark(0, ns, row, col, opts)
+      end
+
+      local function sum_rows(marks)
+        local sum = 0
+        for _, mark in ipairs(marks) do
+          sum = sum + mark[2]
+        end
+        return sum
+      end
+
+      start()
+      local sum = sum_rows(vim.api.nvim_buf_get_extmarks(0, ns, 0, -1, {}))
+      stop('nvim_buf_get_extmarks', 100000)
+
+      start()
+      local cols = vim.api.nvim_buf_get_extmarks(0, ns, 0, -1, { columns = true })
+      local sum2 = 0
+      for _, row in ipairs(cols[2]) do
+        sum2 = sum2 + row
+      end
+      stop('nvim_buf_get_extmarks columns', 100000)
+      assert(sum == sum2)
+
+      start()
+      for _ = 1, 100 do
+        vim.api.nvim_buf_get_extmarks(0, ns, 0, -1, { type = 'virt_lines' })
+      end
+      stop('100 x nvim_buf_get_extmarks type=virt_lines')
+    ]])
+  end)
+
+  it(':%s on every line with 100000 marks', function()
+    exec_lua([[
+      local lines = {}
+      for i = 1, 10000 do
+        lines[i] = ('local foo_%d = bar(baz, %d) -- comment'):format(i, i)
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+      local ns = vim.api.nvim_create_namespace('ns')
+      for i = 0, 99999 do
+        local row, col = math.floor(i / 10), (i % 10) * 3
+        vim.api.nvim_buf_set_extmark(0, ns, row, col, { end_col = col + 3, hl_group = 'Keyword' })
+      end
+
+      start()
+      vim.cmd('%s/bar/qux/')
+      stop(':%s same length')
+
+      start()
+      vim.cmd('%s/qux/quux/')
+      stop(':%s longer')
+
+      start()
+      vim.cmd('%s/quux/\\r/')
+      stop(':%s line break')
+    ]])
+  end)
+
+  it('clearing and setting marks again', function()
+    exec_lua([[
+      local lines = {}
+      for i = 1, 1000 do
+        lines[i] = ('local foo_%d = bar(baz, %d) -- comment'):format(i, i)
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+      local ns = vim.api.nvim_create_namespace('ns')
+
+      local N, rounds = 10000, 100
+      start()
+      for _ = 1, rounds do
+        vim.api.nvim_buf_clear_namespace(0, ns, 0, -1)
+        for i = 0, N - 1 do
+          local row, col = math.floor(i / 10), (i % 10) * 3
+          vim.api.nvim_buf_set_extmark(0, ns, row, col, { end_col = col + 3, hl_group = 'Keyword' })
+        end
+      end
+      stop(('%d rounds of clear + %d marks'):format(rounds, N), rounds * N)
+
+      local stats = vim.api.nvim__stats()
+      out[#out + 1] = ('marktree nodes: %d in use, %d free'):format(
+        stats.marktree_nodes,
+        stats.marktree_free_nodes
+      )
+    ]])
+  end)
 end)
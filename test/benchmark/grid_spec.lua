@@ -0,0 +1,95 @@
+local n = require('test.functional.testnvim')()
+local Screen = require('test.functional.ui.screen')
+
+local api = n.api
+local clear = n.clear
+local exec_lua = n.exec_lua
+
+local width, height = 400, 100
+-- Number of redraws, set NVIM_BENCH_GRID_REDRAWS for a smaller run.
+local redraws = tonumber(os.getenv('NVIM_BENCH_GRID_REDRAWS')) or 1000
+
+--- Fills the screen with text and measures "redraws" redraws of every line
+--- without clearing the grid. With "change" every redraw changes one cell in
+--- each line, otherwise only the comparison with the grid is left. With
+--- "blend" a float with that 'winblend' covers most of the screen.
+local function run(change, blend)
+  return exec_lua(
+    [[
+    local change, blend, redraws = ...
+    local lines = {}
+    for row = 1, vim.o.lines do
+      lines[row] = ('%03d text '):format(row):rep(vim.o.columns / 9)
+    end
+    vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+    if blend then
+      vim.cmd('hi Normal guifg=#d0d0d0 guibg=#202020 | hi NormalFloat guifg=#ffff00 guibg=#404080')
+      local buf = vim.api.nvim_create_buf(false, true)
+      vim.api.nvim_buf_set_lines(buf, 0, -1, true, vim.list_slice(lines, 1, vim.o.lines - 20))
+      local win = vim.api.nvim_open_win(buf, false, {
+        relative = 'editor',
+        row = 10,
+        col = 50,
+        width = vim.o.columns - 100,
+        height = vim.o.lines - 20,
+        style = 'minimal',
+      })
+      vim.wo[win].winblend = blend
+    end
+    vim.cmd('redraw')
+
+    local ts = vim.uv.hrtime()
+    for i = 1, redraws do
+      if change then
+        for row = 1, #lines do
+          lines[row] = tostring(i % 10) .. lines[row]:sub(2)
+        end
+        vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+      end
+      vim.api.nvim__redraw({ valid = false, flush = true })
+    end
+    return (vim.uv.hrtime() - ts) / 1000000
+  ]],
+    change,
+    blend,
+    redraws
+  )
+end
+
+describe('full redraw', function()
+  before_each(function()
+    clear()
+    local screen = Screen.new(width, height)
+    screen:attach()
+  end)
+
+  for _, case in ipairs({
+    { false },
+    { true },
+    { false, 30 },
+    { true, 30 },
+  }) do
+    local change, blend = case[1], case[2]
+    it(
+      ('%d redraws of %d columns, %s%s'):format(
+        redraws,
+        width,
+        change and 'one cell changed per line' or 'unchanged',
+        blend and (", float with 'winblend' %d"):format(blend) or ''
+      ),
+      function()
+        local before = api.nvim__stats()
+        local ms = run(change, blend)
+        local after = api.nvim__stats()
+        print()
+        print(
+          ('%14.6f ms - %.1f us per redraw, %.0f bytes per redraw'):format(
+            ms,
+            ms * 1000 / redraws,
+            (after.ui_bytes - before.ui_bytes) / redraws
+          )
+        )
+      end
+    )
+  end
+end)
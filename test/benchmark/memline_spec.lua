@@ -0,0 +1,100 @@
+local n = require('test.functional.testnvim')()
+
+local clear = n.clear
+local exec_lua = n.exec_lua
+
+describe('memline perf', function()
+  before_each(function()
+    clear()
+
+    exec_lua([[
+      out = {}
+      function start()
+        ts = vim.uv.hrtime()
+      end
+      function stop(name, count)
+        local ms = (vim.uv.hrtime() - ts) / 1000000
+        out[#out+1] = ('%14.6f ms - %s (%d/ms)'):format(ms, name, count / ms)
+      end
+
+      function fill(count)
+        local lines = {}
+        for i = 1, count do
+          lines[i] = ('line %d '):format(i) .. ('x'):rep(i % 80)
+        end
+        vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+      end
+    ]])
+  end)
+
+  after_each(function()
+    for _, line in ipairs(exec_lua([[return out]])) do
+      print(line)
+    end
+  end)
+
+  for _, size in ipairs({ 10000, 100000, 500000 }) do
+    it(('offset queries in %d lines'):format(size), function()
+      exec_lua(
+        [[
+        local size = ...
+        local Q = 100000
+        fill(size)
+        math.randomseed(size)
+
+        start()
+        for _ = 1, Q do
+          vim.api.nvim_buf_get_offset(0, math.random(0, size - 1))
+        end
+        stop(('nvim_buf_get_offset %d lines'):format(size), Q)
+
+        local total = vim.fn.line2byte(size + 1)
+        start()
+        for _ = 1, Q do
+          vim.fn.byte2line(math.random(1, total - 1))
+        end
+        stop(('byte2line %d lines'):format(size), Q)
+
+        -- each edit changes the chunks before the next query
+        start()
+        for _ = 1, Q / 10 do
+          local row = math.random(0, size - 1)
+          vim.api.nvim_buf_set_lines(0, row, row, true, { 'inserted' })
+          vim.api.nvim_buf_get_offset(0, math.random(0, size - 1))
+          vim.api.nvim_buf_set_lines(0, row, row + 1, true, {})
+        end
+        stop(('edit + nvim_buf_get_offset %d lines'):format(size), Q / 10)
+      ]],
+        size
+      )
+    end)
+  end
+
+  it('appending 1000000 lines', function()
+    exec_lua([[
+      local fname = vim.fn.tempname()
+      local N = 1000000
+      local lines = {}
+      for i = 1, N do
+        lines[i] = ('line %d '):format(i) .. ('x'):rep(i % 80)
+      end
+
+      start()
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+      stop('nvim_buf_set_lines', N)
+
+      vim.cmd('silent %yank')
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, {})
+      start()
+      vim.cmd('silent put')
+      stop('put', N)
+
+      vim.fn.writefile(lines, fname)
+      vim.cmd('enew!')
+      start()
+      vim.cmd('silent edit ' .. fname)
+      stop('edit', N)
+      os.remove(fname)
+    ]])
+  end)
+end)
@@ -0,0 +1,66 @@
+local n = require('test.functional.testnvim')()
+
+local clear = n.clear
+local exec_lua = n.exec_lua
+
+-- Size of the file in Mbyte, set NVIM_BENCH_READFILE_MB for a smaller run.
+local size_mb = tonumber(os.getenv('NVIM_BENCH_READFILE_MB')) or 1024
+
+describe('readfile perf', function()
+  before_each(function()
+    clear()
+  end)
+
+  it(('loading %d Mbyte of mixed ASCII/UTF-8 text'):format(size_mb), function()
+    local out = exec_lua(
+      [[
+      local size_mb = ...
+      local fname = vim.fn.tempname()
+
+      -- 1 Mbyte block of lines, mostly ASCII with some multibyte text
+      local lines = {}
+      local len = 0
+      local i = 0
+      while len < 1024 * 1024 do
+        i = i + 1
+        local line
+        if i % 4 == 0 then
+          line = ('äöü €uro ✓ 日本語 '):rep(i % 5 + 1)
+        else
+          line = ('line %d '):format(i) .. ('x'):rep(i % 100)
+        end
+        lines[#lines + 1] = line
+        len = len + #line + 1
+      end
+      local block = table.concat(lines, '\n') .. '\n'
+
+      local f = assert(io.open(fname, 'wb'))
+      for _ = 1, size_mb do
+        f:write(block)
+      end
+      f:close()
+
+      local out = {}
+      for _, ff in ipairs({ 'unix', 'dos' }) do
+        vim.cmd('enew!')
+        local ts = vim.uv.hrtime()
+        vim.cmd(('silent edit ++ff=%s ++enc=utf-8 %s'):format(ff, fname))
+        local ms = (vim.uv.hrtime() - ts) / 1000000
+        out[#out + 1] = ('%14.6f ms - edit ++ff=%s (%d lines, %.1f Mbyte/s)'):format(
+          ms,
+          ff,
+          vim.api.nvim_buf_line_count(0),
+          size_mb / ms * 1000
+        )
+      end
+      vim.cmd('enew!')
+      os.remove(fname)
+      return out
+    ]],
+      size_mb
+    )
+    for _, line in ipairs(out) do
+      print(line)
+    end
+  end)
+end)
@@ -0,0 +1,54 @@
+local t = require('test.testutil')
+local n = require('test.functional.testnvim')()
+local Screen = require('test.functional.ui.screen')
+
+local api = n.api
+local clear = n.clear
+local command = n.command
+
+local width, height = 200, 60
+-- Number of output lines, set NVIM_BENCH_REDRAW_LINES for a smaller run.
+local lines = tonumber(os.getenv('NVIM_BENCH_REDRAW_LINES')) or 200000
+
+describe('redraw of terminal output', function()
+  before_each(function()
+    clear()
+    local screen = Screen.new(width, height)
+    screen:attach()
+  end)
+
+  for _, rate in ipairs({ 0, 60 }) do
+    it(("%d lines with 'redrawrate' %d"):format(lines, rate), function()
+      command('set redrawrate=' .. rate)
+      command('autocmd TermClose * let g:done = 1')
+      local before = api.nvim__stats()
+      local script = t.tmpname()
+      t.write_file(script, ('for i = 1, %d do io.write(i, "\\n") end'):format(lines))
+      local ts = vim.uv.hrtime()
+      command(('terminal %s --clean -l %s'):format(n.nvim_prog, script))
+      t.retry(nil, 600000, function()
+        assert(api.nvim_get_var('done') == 1)
+      end)
+      local ms = (vim.uv.hrtime() - ts) / 1000000
+      local after = api.nvim__stats()
+      os.remove(script)
+
+      local frames = after.redraw_frames - before.redraw_frames
+      print()
+      print(
+        ('%14.6f ms - %d frames, %d postponed'):format(
+          ms,
+          frames,
+          after.redraw_postponed - before.redraw_postponed
+        )
+      )
+      print(
+        ('%14.1f us in win_update, %.1f lines and %.0f bytes per frame'):format(
+          (after.redraw_win_update_us - before.redraw_win_update_us) / frames,
+          (after.redraw_lines - before.redraw_lines) / frames,
+          (after.ui_bytes - before.ui_bytes) / frames
+        )
+      )
+    end)
+  end
+end)
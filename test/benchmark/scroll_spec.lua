@@ -0,0 +1,78 @@
+local n = require('test.functional.testnvim')()
+local Screen = require('test.functional.ui.screen')
+
+local api = n.api
+local clear = n.clear
+local exec_lua = n.exec_lua
+
+local width, height = 120, 50
+-- Number of scroll steps, set NVIM_BENCH_SCROLL_STEPS for a smaller run.
+local steps = tonumber(os.getenv('NVIM_BENCH_SCROLL_STEPS')) or 2000
+
+describe('scrolling', function()
+  before_each(function()
+    clear()
+    local screen = Screen.new(width, height)
+    screen:attach()
+  end)
+
+  --- Scrolls through 'wrap'ped lines of "size" bytes with "keys", redrawing
+  --- after each step.
+  local function run(size, keys)
+    return exec_lua(
+      [[
+      local size, keys, steps = ...
+      local words = {}
+      for i = 1, size / 8 do
+        words[i] = ('word%03d'):format(i % 1000)
+      end
+      local line = table.concat(words, ' ')
+      local lines = {}
+      for i = 1, 2000 do
+        lines[i] = line
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+      vim.o.linebreak = true
+      vim.o.scrolloff = 5
+      vim.cmd('redraw')
+
+      local keys = vim.api.nvim_replace_termcodes(keys, true, true, true)
+      local ts = vim.uv.hrtime()
+      for _ = 1, steps do
+        vim.cmd('normal! ' .. keys)
+        if vim.fn.line('.') == vim.fn.line('$') then
+          vim.cmd('normal! gg')
+        end
+        vim.cmd('redraw')
+      end
+      return (vim.uv.hrtime() - ts) / 1000000
+    ]],
+      size,
+      keys,
+      steps
+    )
+  end
+
+  for _, case in ipairs({
+    { 2000, '<C-E>' },
+    { 2000, 'j' },
+    { 20000, '<C-D>' },
+  }) do
+    local size, keys = case[1], case[2]
+    it(('%d steps of %s through lines of %d bytes'):format(steps, keys, size), function()
+      local before = api.nvim__stats()
+      local ms = run(size, keys)
+      local after = api.nvim__stats()
+      local hit = after.plines_cache_hit - before.plines_cache_hit
+      local miss = after.plines_cache_miss - before.plines_cache_miss
+      print()
+      print(
+        ('%14.6f ms - %d line heights, %.1f%% cached'):format(
+          ms,
+          hit + miss,
+          hit + miss > 0 and hit * 100 / (hit + miss) or 0
+        )
+      )
+    end)
+  end
+end)
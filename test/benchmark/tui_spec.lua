@@ -0,0 +1,89 @@
+local n = require('test.functional.testnvim')()
+
+local clear = n.clear
+local exec_lua = n.exec_lua
+
+local width, height = 200, 60
+-- Number of frames, set NVIM_BENCH_TUI_FRAMES for a smaller run.
+local frames = tonumber(os.getenv('NVIM_BENCH_TUI_FRAMES')) or 300
+
+local workloads = {
+  -- Rewrite every line.
+  full = [[
+    local lines = {}
+    for i = 1, frames do
+      for row = 1, vim.o.lines do
+        lines[row] = ('%d:%d '):format(i, row):rep(vim.o.columns / 8):sub(1, vim.o.columns - 1)
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+      vim.cmd('redraw')
+    end
+  ]],
+  -- Move the cursor through text, redrawing 'cursorline' and the ruler.
+  cursor = [[
+    local lines = {}
+    for row = 1, vim.o.lines * 2 do
+      lines[row] = ('word%d '):format(row):rep(vim.o.columns / 8)
+    end
+    vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+    vim.o.cursorline = true
+    vim.o.ruler = true
+    vim.cmd('redraw')
+    for i = 1, frames do
+      vim.api.nvim_win_set_cursor(0, { i % #lines + 1, (i * 7) % (vim.o.columns / 2) })
+      vim.cmd('redraw')
+    end
+  ]],
+}
+
+--- Runs the TUI in a :terminal and counts the bytes it writes to the terminal
+--- until it exits, after "count" frames of "workload".
+local function run(workload, count)
+  return exec_lua(
+    [[
+    local nvim_prog, code, count, width, height = ...
+    vim.o.columns, vim.o.lines = width, height + 2
+    local script = vim.fn.tempname()
+    local lines = vim.split(('local frames = %d\n%s\nvim.cmd("qall!")'):format(count, code), '\n')
+    vim.fn.writefile(lines, script)
+
+    local bytes, exited = 0, false
+    vim.fn.termopen({ nvim_prog, '--clean', '-n', '--cmd', 'set termsync', '-S', script }, {
+      on_stdout = function(_, data)
+        for i, chunk in ipairs(data) do
+          bytes = bytes + #chunk + (i > 1 and 1 or 0)
+        end
+      end,
+      on_exit = function()
+        exited = true
+      end,
+    })
+    vim.wait(300000, function()
+      return exited
+    end)
+    os.remove(script)
+    return bytes
+  ]],
+    n.nvim_prog,
+    workloads[workload],
+    count,
+    width,
+    height
+  )
+end
+
+describe('TUI output', function()
+  before_each(clear)
+
+  for _, workload in ipairs({ 'full', 'cursor' }) do
+    local name =
+      ('%d frames of %s redraw in a %dx%d terminal'):format(frames, workload, width, height)
+    it(name, function()
+      -- Startup and exit are measured separately and left out.
+      local base = run(workload, 0)
+      local bytes = run(workload, frames)
+      print()
+      print(('%14.1f bytes per frame - %s'):format((bytes - base) / frames, workload))
+    end)
+  end
+end)
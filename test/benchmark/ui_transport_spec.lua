@@ -0,0 +1,72 @@
+local n = require('test.functional.testnvim')()
+
+local clear = n.clear
+local exec_lua = n.exec_lua
+
+local width, height = 200, 60
+-- Number of redraws, set NVIM_BENCH_UI_REDRAWS for a smaller run.
+local redraws = tonumber(os.getenv('NVIM_BENCH_UI_REDRAWS')) or 500
+
+--- Attaches to a child Nvim as UI and measures how long it takes until all
+--- output of "redraws" full redraws was received and decoded.
+---
+--- @return number? milliseconds, nil if the ring is not supported
+local function run(use_ring)
+  return exec_lua(
+    [[
+    local nvim_prog, use_ring, redraws, width, height = ...
+    local chan = vim.fn.jobstart(
+      { nvim_prog, '--embed', '--headless', '--clean', '-n' },
+      { rpc = true }
+    )
+    local opts = { ext_linegrid = true }
+    if use_ring then
+      opts.shm_ring = vim.api.nvim__chan_ring(chan)
+      if opts.shm_ring == '' then
+        vim.fn.jobstop(chan)
+        return nil
+      end
+    end
+    vim.rpcrequest(chan, 'nvim_ui_attach', width, height, opts)
+
+    local code = [=[
+      local redraws, width, height = ...
+      local lines = {}
+      for i = 1, redraws do
+        for row = 1, height do
+          lines[row] = ('%d:%d '):format(i, row):rep(width / 8):sub(1, width - 1)
+        end
+        vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+        vim.cmd('redraw')
+      end
+    ]=]
+    local ts = vim.uv.hrtime()
+    -- The response comes after all redraw events.
+    vim.rpcrequest(chan, 'nvim_exec_lua', code, { redraws, width, height })
+    local ms = (vim.uv.hrtime() - ts) / 1000000
+    vim.fn.jobstop(chan)
+    return ms
+  ]],
+    n.nvim_prog,
+    use_ring,
+    redraws,
+    width,
+    height
+  )
+end
+
+describe('UI transport', function()
+  before_each(clear)
+
+  it(('%d full redraws of a %dx%d grid'):format(redraws, width, height), function()
+    local pipe = run(false)
+    local ring = run(true)
+    print()
+    print(('%14.6f ms - pipe'):format(pipe))
+    if ring then
+      print(('%14.6f ms - shared memory ring (%.2fx)'):format(ring, pipe / ring))
+    else
+      print('shared memory ring not supported')
+    end
+  end)
+end)
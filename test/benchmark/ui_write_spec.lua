@@ -0,0 +1,66 @@
+local n = require('test.functional.testnvim')()
+local Screen = require('test.functional.ui.screen')
+
+local api = n.api
+local clear = n.clear
+local exec_lua = n.exec_lua
+
+local width, height = 200, 60
+-- Number of redraws, set NVIM_BENCH_UI_REDRAWS for a smaller run.
+local redraws = tonumber(os.getenv('NVIM_BENCH_UI_REDRAWS')) or 500
+
+describe('remote UI output', function()
+  local screen
+
+  before_each(function()
+    clear()
+    screen = Screen.new(width, height)
+    screen:attach()
+  end)
+
+  it(('%d full redraws of a %dx%d grid'):format(redraws, width, height), function()
+    local before = api.nvim__stats()
+    local ms = exec_lua(
+      [[
+      local redraws, width, height = ...
+      local lines = {}
+      local ts = vim.uv.hrtime()
+      for i = 1, redraws do
+        for row = 1, height do
+          lines[row] = ('%d:%d '):format(i, row):rep(width / 8):sub(1, width - 1)
+        end
+        vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+        vim.cmd('redraw')
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, { 'DONE' })
+      vim.cmd('redraw')
+      return (vim.uv.hrtime() - ts) / 1000000
+    ]],
+      redraws,
+      width,
+      height
+    )
+    -- let the client read everything, so that queued writes are done
+    screen:expect({ any = 'DONE' })
+    local after = api.nvim__stats()
+
+    local writes = after.stream_writes - before.stream_writes
+    local bufs = after.stream_write_bufs - before.stream_write_bufs
+    local bytes = after.stream_write_bytes - before.stream_write_bytes
+    print()
+    print(
+      ('%14.6f ms - %d redraws, %.1f Mbyte/s'):format(
+        ms,
+        redraws,
+        bytes / 1024 / 1024 / ms * 1000
+      )
+    )
+    print(
+      ('%14.2f writes per redraw, %.2f buffers and %.0f bytes per write'):format(
+        writes / redraws,
+        bufs / writes,
+        bytes / writes
+      )
+    )
+  end)
+end)
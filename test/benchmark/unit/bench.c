@@ -0,0 +1,89 @@
+/// Native microbenchmarks for core data structures.
+///
+/// Usage: nvim-bench [-r repeat] [filter]
+///
+/// Every case whose name contains "filter" is run "repeat" times, and one JSON
+/// object per case is printed to stdout, e.g.
+///
+///   {"name":"marktree/put","n":100000,"repeat":7,"min_ns":...,"median_ns":...}
+///
+/// "min_ns" and "median_ns" are nanoseconds per operation. The output is
+/// meant to be diffed or fed to a script, so nothing else goes to stdout.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "nvim/main.h"
+
+volatile uint64_t bench_sink = 0;
+
+static const BenchCase cases[] = {
+  { "loop/schedule_fast", 1000000, bench_loop_throughput },
+  { "loop/wakeup_latency", 10000, bench_loop_wakeup_latency },
+  { "marktree/put", 100000, bench_marktree_put },
+  { "marktree/itr", 100000, bench_marktree_itr },
+  { "marktree/splice", 10000, bench_marktree_splice },
+  { "marktree/del", 100000, bench_marktree_del },
+  { "memline/append", 100000, bench_ml_append },
+  { "memline/get", 100000, bench_ml_get },
+  { "regexp/exec_multi", 10000, bench_regexec_multi },
+  { "grid/put_linebuf_same", 100000, bench_grid_put_linebuf_same },
+  { "grid/put_linebuf_one", 100000, bench_grid_put_linebuf_one },
+  { "hashtab/find", 100000, bench_hash_find },
+  { "map/get", 100000, bench_map_get },
+  { "mbyte/utf_ptr2char", 1000000, bench_utf_ptr2char },
+  { "mbyte/utf_char2cells", 1000000, bench_utf_char2cells },
+  { "msgpack/pack", 10000, bench_mpack_pack },
+  { "msgpack/unpack", 10000, bench_mpack_unpack },
+};
+
+static int cmp_u64(const void *a, const void *b)
+{
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+  return x < y ? -1 : x > y;
+}
+
+static void run_case(const BenchCase *c, int repeat)
+{
+  uint64_t *times = malloc((size_t)repeat * sizeof(*times));
+  c->run(c->n);  // warm up caches and allocator
+  for (int i = 0; i < repeat; i++) {
+    times[i] = c->run(c->n);
+  }
+  qsort(times, (size_t)repeat, sizeof(*times), cmp_u64);
+  printf("{\"name\":\"%s\",\"n\":%zu,\"repeat\":%d,\"min_ns\":%.3f,\"median_ns\":%.3f}\n",
+         c->name, c->n, repeat, (double)times[0] / (double)c->n,
+         (double)times[repeat / 2] / (double)c->n);
+  fflush(stdout);
+  free(times);
+}
+
+int main(int argc, char **argv)
+{
+  int repeat = 7;
+  const char *filter = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+      repeat = atoi(argv[++i]);
+    } else {
+      filter = argv[i];
+    }
+  }
+  if (repeat < 1) {
+    fprintf(stderr, "nvim-bench: repeat must be positive\n");
+    return 2;
+  }
+
+  event_init();
+  early_init(NULL);
+
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    if (filter == NULL || strstr(cases[i].name, filter) != NULL) {
+      run_case(&cases[i], repeat);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// A benchmark case. "run" performs "n" operations and returns the number of
+/// nanoseconds spent in the timed part; setup and teardown are not counted.
+typedef struct {
+  const char *name;
+  size_t n;
+  uint64_t (*run)(size_t n);
+} BenchCase;
+
+/// Sink for results the compiler must not optimize away.
+extern volatile uint64_t bench_sink;
+
+uint64_t bench_loop_throughput(size_t n);
+uint64_t bench_loop_wakeup_latency(size_t n);
+uint64_t bench_marktree_put(size_t n);
+uint64_t bench_marktree_itr(size_t n);
+uint64_t bench_marktree_splice(size_t n);
+uint64_t bench_marktree_del(size_t n);
+uint64_t bench_ml_append(size_t n);
+uint64_t bench_ml_get(size_t n);
+uint64_t bench_regexec_multi(size_t n);
+uint64_t bench_grid_put_linebuf_same(size_t n);
+uint64_t bench_grid_put_linebuf_one(size_t n);
+uint64_t bench_hash_find(size_t n);
+uint64_t bench_map_get(size_t n);
+uint64_t bench_utf_ptr2char(size_t n);
+uint64_t bench_utf_char2cells(size_t n);
+uint64_t bench_mpack_pack(size_t n);
+uint64_t bench_mpack_unpack(size_t n);
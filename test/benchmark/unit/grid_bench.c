@@ -0,0 +1,50 @@
+#include "bench.h"
+#include "nvim/grid.h"
+#include "nvim/grid_defs.h"
+#include "nvim/os/time.h"
+
+/// Width of the redrawn line, like a full screen line of a wide terminal.
+#define GRID_BENCH_COLS 400
+
+static ScreenGrid bench_grid = SCREEN_GRID_INIT;
+
+/// Fills the line buffer with text and puts it on the grid once, so that the
+/// grid starts out equal to the line buffer.
+static void setup_line(void)
+{
+  if (bench_grid.chars == NULL) {
+    grid_alloc(&bench_grid, 1, GRID_BENCH_COLS, false, true);
+  }
+  for (int col = 0; col < GRID_BENCH_COLS; col++) {
+    linebuf_char[col] = schar_from_ascii((char)('a' + col % 26));
+    linebuf_attr[col] = col / 40;
+    linebuf_vcol[col] = col;
+  }
+  grid_put_linebuf(&bench_grid, 0, 0, 0, GRID_BENCH_COLS, GRID_BENCH_COLS, 0, 0, 0);
+}
+
+/// Redraws a line which didn't change, the common case for most lines of a
+/// window.
+uint64_t bench_grid_put_linebuf_same(size_t n)
+{
+  setup_line();
+
+  uint64_t start = os_hrtime();
+  for (size_t i = 0; i < n; i++) {
+    grid_put_linebuf(&bench_grid, 0, 0, 0, GRID_BENCH_COLS, GRID_BENCH_COLS, 0, 0, 0);
+  }
+  return os_hrtime() - start;
+}
+
+/// Redraws a line where one cell in the middle changed.
+uint64_t bench_grid_put_linebuf_one(size_t n)
+{
+  setup_line();
+
+  uint64_t start = os_hrtime();
+  for (size_t i = 0; i < n; i++) {
+    linebuf_char[GRID_BENCH_COLS / 2] = schar_from_ascii(i % 2 ? 'x' : 'y');
+    grid_put_linebuf(&bench_grid, 0, 0, 0, GRID_BENCH_COLS, GRID_BENCH_COLS, 0, 0, 0);
+  }
+  return os_hrtime() - start;
+}
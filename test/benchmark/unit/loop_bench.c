@@ -0,0 +1,105 @@
+#include <uv.h>
+
+#include "bench.h"
+#include "nvim/event/defs.h"
+#include "nvim/event/loop.h"
+#include "nvim/os/time.h"
+
+#define PRODUCERS 4
+
+typedef struct {
+  Loop *loop;
+  size_t count;
+  uv_sem_t *done;  ///< latency: wait for the event to be handled
+} Producer;
+
+static size_t handled;
+static uint64_t latency_sum;
+
+static void count_event(void **argv)
+{
+  (void)argv;
+  handled++;
+}
+
+static void latency_event(void **argv)
+{
+  uint64_t *sent = argv[0];
+  latency_sum += os_hrtime() - *sent;
+  handled++;
+  uv_sem_post(argv[1]);
+}
+
+static void throughput_producer(void *arg)
+{
+  Producer *p = arg;
+  for (size_t i = 0; i < p->count; i++) {
+    loop_schedule_fast(p->loop, event_create(count_event, NULL));
+  }
+}
+
+static void latency_producer(void *arg)
+{
+  Producer *p = arg;
+  uint64_t sent;
+  for (size_t i = 0; i < p->count; i++) {
+    sent = os_hrtime();
+    loop_schedule_fast(p->loop, event_create(latency_event, &sent, p->done));
+    uv_sem_wait(p->done);
+  }
+}
+
+static void run_loop(Loop *loop, size_t n)
+{
+  while (handled < n) {
+    loop_poll_events(loop, -1);
+  }
+}
+
+/// PRODUCERS threads schedule "n" events in total, as fast as they can. The
+/// result is the time per event, i.e. the inverse of events per second.
+uint64_t bench_loop_throughput(size_t n)
+{
+  Loop loop;
+  loop_init(&loop, NULL);
+  handled = 0;
+
+  Producer producers[PRODUCERS];
+  uv_thread_t threads[PRODUCERS];
+  uint64_t start = os_hrtime();
+  for (int i = 0; i < PRODUCERS; i++) {
+    producers[i] = (Producer){ .loop = &loop, .count = n / PRODUCERS };
+    uv_thread_create(&threads[i], throughput_producer, &producers[i]);
+  }
+  run_loop(&loop, n / PRODUCERS * PRODUCERS);
+  uint64_t elapsed = os_hrtime() - start;
+
+  for (int i = 0; i < PRODUCERS; i++) {
+    uv_thread_join(&threads[i]);
+  }
+  loop_close(&loop, false);
+  return elapsed;
+}
+
+/// One thread schedules an event and waits until it was handled, "n" times.
+/// The result is the average time from scheduling an event until the loop,
+/// blocked waiting for it, handles it.
+uint64_t bench_loop_wakeup_latency(size_t n)
+{
+  Loop loop;
+  loop_init(&loop, NULL);
+  handled = 0;
+  latency_sum = 0;
+
+  uv_sem_t done;
+  uv_sem_init(&done, 0);
+  Producer producer = { .loop = &loop, .count = n, .done = &done };
+  uv_thread_t thread;
+  uv_thread_create(&thread, latency_producer, &producer);
+  run_loop(&loop, n);
+  uv_thread_join(&thread);
+
+  uv_sem_destroy(&done);
+  loop_close(&loop, false);
+  return latency_sum;
+}
@@ -0,0 +1,70 @@
+#include <stdio.h>
+
+#include "bench.h"
+#include "nvim/hashtab.h"
+#include "nvim/map_defs.h"
+#include "nvim/memory.h"
+#include "nvim/os/time.h"
+
+/// Returns "n" distinct keys, looking like typical variable names.
+static char **make_keys(size_t n)
+{
+  char **keys = xmalloc(n * sizeof(*keys));
+  for (size_t i = 0; i < n; i++) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "g:plugin_var_%zu", i);
+    keys[i] = xstrdup(buf);
+  }
+  return keys;
+}
+
+static void free_keys(char **keys, size_t n)
+{
+  for (size_t i = 0; i < n; i++) {
+    xfree(keys[i]);
+  }
+  xfree(keys);
+}
+
+uint64_t bench_hash_find(size_t n)
+{
+  char **keys = make_keys(n);
+  hashtab_T ht;
+  hash_init(&ht);
+  for (size_t i = 0; i < n; i++) {
+    hash_add(&ht, keys[i]);
+  }
+
+  uint64_t start = os_hrtime();
+  uint64_t found = 0;
+  for (size_t i = 0; i < n; i++) {
+    found += !HASHITEM_EMPTY(hash_find(&ht, keys[(i * 7919) % n]));
+  }
+  uint64_t elapsed = os_hrtime() - start;
+
+  bench_sink += found;
+  hash_clear(&ht);
+  free_keys(keys, n);
+  return elapsed;
+}
+
+uint64_t bench_map_get(size_t n)
+{
+  char **keys = make_keys(n);
+  Map(cstr_t, int) map = MAP_INIT;
+  for (size_t i = 0; i < n; i++) {
+    map_put(cstr_t, int)(&map, keys[i], (int)i);
+  }
+
+  uint64_t start = os_hrtime();
+  uint64_t sum = 0;
+  for (size_t i = 0; i < n; i++) {
+    sum += (uint64_t)map_get(cstr_t, int)(&map, keys[(i * 7919) % n]);
+  }
+  uint64_t elapsed = os_hrtime() - start;
+
+  bench_sink += sum;
+  map_destroy(cstr_t, &map);
+  free_keys(keys, n);
+  return elapsed;
+}
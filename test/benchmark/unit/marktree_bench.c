@@ -0,0 +1,103 @@
+#include <stdbool.h>
+#include <string.h>
+
+#include "bench.h"
+#include "nvim/marktree.h"
+#include "nvim/os/time.h"
+
+#define NS 1
+#define LINES 10000
+
+// Deterministic pseudo-random sequence, so every run measures the same work.
+static uint32_t rand_state;
+
+static uint32_t next_rand(void)
+{
+  rand_state = rand_state * 1103515245 + 12345;
+  return rand_state >> 8;
+}
+
+static void fill_tree(MarkTree *tree, size_t n)
+{
+  rand_state = 1;
+  for (size_t i = 0; i < n; i++) {
+    int row = (int)(next_rand() % LINES);
+    int col = (int)(next_rand() % 80);
+    marktree_put_test(tree, NS, (uint32_t)i + 1, row, col, true, -1, -1, false, false);
+  }
+}
+
+uint64_t bench_marktree_put(size_t n)
+{
+  MarkTree tree[1];
+  memset(tree, 0, sizeof(tree));
+
+  uint64_t start = os_hrtime();
+  fill_tree(tree, n);
+  uint64_t elapsed = os_hrtime() - start;
+
+  marktree_clear(tree);
+  return elapsed;
+}
+
+uint64_t bench_marktree_itr(size_t n)
+{
+  MarkTree tree[1];
+  memset(tree, 0, sizeof(tree));
+  fill_tree(tree, n);
+
+  uint64_t start = os_hrtime();
+  MarkTreeIter itr[1];
+  uint64_t sum = 0;
+  marktree_itr_first(tree, itr);
+  while (itr->x) {
+    sum += (uint64_t)marktree_itr_current(itr).pos.row;
+    marktree_itr_next(tree, itr);
+  }
+  uint64_t elapsed = os_hrtime() - start;
+
+  bench_sink += sum;
+  marktree_clear(tree);
+  return elapsed;
+}
+
+/// Each operation inserts a line break at a random position and joins it
+/// again, like "o" followed by "J" would.
+uint64_t bench_marktree_splice(size_t n)
+{
+  MarkTree tree[1];
+  memset(tree, 0, sizeof(tree));
+  fill_tree(tree, 100000);
+
+  uint64_t start = os_hrtime();
+  for (size_t i = 0; i < n; i += 2) {
+    int row = (int)(next_rand() % LINES);
+    int col = (int)(next_rand() % 80);
+    marktree_splice(tree, row, col, 0, 0, 1, 0);
+    marktree_splice(tree, row, col, 1, 0, 0, 0);
+  }
+  uint64_t elapsed = os_hrtime() - start;
+
+  marktree_clear(tree);
+  return elapsed;
+}
+
+uint64_t bench_marktree_del(size_t n)
+{
+  MarkTree tree[1];
+  memset(tree, 0, sizeof(tree));
+  fill_tree(tree, n);
+
+  uint64_t start = os_hrtime();
+  MarkTreeIter itr[1];
+  for (size_t i = 0; i < n; i++) {
+    // Delete in a different order than inserted, to not only hit the edges.
+    uint32_t id = (uint32_t)((i * 7919) % n) + 1;
+    marktree_lookup_ns(tree, NS, id, false, itr);
+    marktree_del_itr(tree, itr, false);
+  }
+  uint64_t elapsed = os_hrtime() - start;
+
+  marktree_clear(tree);
+  return elapsed;
+}
@@ -0,0 +1,51 @@
+#include "bench.h"
+#include "nvim/ascii_defs.h"
+#include "nvim/mbyte.h"
+#include "nvim/memory.h"
+#include "nvim/os/time.h"
+
+/// Mostly ASCII with some Latin, CJK and emoji, like a typical source file
+/// with comments in other languages.
+static const char text[] = "local x = 1  -- äöü €uro ✓ 日本語 テキスト 🙂 ok\n"
+                           "for i, v in ipairs(list) do print(i, v) end\n";
+
+uint64_t bench_utf_ptr2char(size_t n)
+{
+  const size_t len = sizeof(text) - 1;
+
+  uint64_t start = os_hrtime();
+  uint64_t sum = 0;
+  size_t off = 0;
+  for (size_t i = 0; i < n; i++) {
+    sum += (uint64_t)utf_ptr2char(text + off);
+    off += (size_t)utf_ptr2len(text + off);
+    if (off >= len) {
+      off = 0;
+    }
+  }
+  uint64_t elapsed = os_hrtime() - start;
+
+  bench_sink += sum;
+  return elapsed;
+}
+
+uint64_t bench_utf_char2cells(size_t n)
+{
+  // Decode once, so that only utf_char2cells() is measured.
+  int *chars = xmalloc(sizeof(text) * sizeof(*chars));
+  size_t nchars = 0;
+  for (const char *p = text; *p != NUL; p += utf_ptr2len(p)) {
+    chars[nchars++] = utf_ptr2char(p);
+  }
+
+  uint64_t start = os_hrtime();
+  uint64_t sum = 0;
+  for (size_t i = 0; i < n; i++) {
+    sum += (uint64_t)utf_char2cells(chars[i % nchars]);
+  }
+  uint64_t elapsed = os_hrtime() - start;
+
+  bench_sink += sum;
+  xfree(chars);
+  return elapsed;
+}
@@ -0,0 +1,92 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "nvim/buffer_defs.h"
+#include "nvim/globals.h"
+#include "nvim/memline.h"
+#include "nvim/os/time.h"
+#include "nvim/regexp.h"
+
+/// Replaces the text of the current buffer with an empty memline, without a
+/// swapfile.
+static void reset_memline(void)
+{
+  if (curbuf->b_ml.ml_mfp != NULL) {
+    ml_close(curbuf, false);
+  }
+  curbuf->b_p_swf = false;
+  ml_open(curbuf);
+}
+
+static void make_line(char *buf, size_t size, size_t i)
+{
+  if (i % 4 == 0) {
+    snprintf(buf, size, "    foo%zubar = some_function(arg, %zu)  -- äöü", i % 100, i);
+  } else {
+    snprintf(buf, size, "line %zu %.*s", i, (int)(i % 60), "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"
+             "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx");
+  }
+}
+
+static void fill_buffer(size_t n)
+{
+  char line[128];
+  reset_memline();
+  for (size_t i = 0; i < n; i++) {
+    make_line(line, sizeof(line), i);
+    ml_append((linenr_T)i, line, 0, false);
+  }
+}
+
+uint64_t bench_ml_append(size_t n)
+{
+  char line[128];
+  reset_memline();
+
+  uint64_t start = os_hrtime();
+  for (size_t i = 0; i < n; i++) {
+    make_line(line, sizeof(line), i);
+    ml_append((linenr_T)i, line, 0, false);
+  }
+  return os_hrtime() - start;
+}
+
+/// Gets lines in a strided order, so that the cached line and block don't
+/// always hit.
+uint64_t bench_ml_get(size_t n)
+{
+  fill_buffer(n);
+
+  uint64_t start = os_hrtime();
+  uint64_t sum = 0;
+  for (size_t i = 0; i < n; i++) {
+    linenr_T lnum = (linenr_T)((i * 7919) % n) + 1;
+    sum += (uint8_t)ml_get(lnum)[0];
+  }
+  uint64_t elapsed = os_hrtime() - start;
+
+  bench_sink += sum;
+  return elapsed;
+}
+
+uint64_t bench_regexec_multi(size_t n)
+{
+  fill_buffer(n);
+  regmmatch_T regmatch;
+  memset(&regmatch, 0, sizeof(regmatch));
+  regmatch.regprog = vim_regcomp("\\<foo\\d\\+bar\\s*=\\s*\\k\\+(", RE_MAGIC);
+
+  uint64_t start = os_hrtime();
+  uint64_t matches = 0;
+  for (size_t i = 0; i < n; i++) {
+    matches += (uint64_t)vim_regexec_multi(&regmatch, curwin, curbuf, (linenr_T)i + 1, 0,
+                                           NULL, NULL);
+  }
+  uint64_t elapsed = os_hrtime() - start;
+
+  bench_sink += matches;
+  vim_regfree(regmatch.regprog);
+  return elapsed;
+}
@@ -0,0 +1,120 @@
+#include <assert.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "nvim/api/private/defs.h"
+#include "nvim/api/private/helpers.h"
+#include "nvim/memory.h"
+#include "nvim/msgpack_rpc/packer.h"
+#include "nvim/msgpack_rpc/unpacker.h"
+#include "nvim/os/time.h"
+
+#define PACK_BUF_SIZE (1024 * 1024)
+
+/// Builds a message shaped like a "redraw" notification with a batch of
+/// "grid_line" events, which dominates RPC traffic of a busy UI.
+static Object make_message(Arena *arena)
+{
+  Array cells = arena_array(arena, 80);
+  for (int i = 0; i < 80; i++) {
+    Array cell = arena_array(arena, 3);
+    ADD_C(cell, CSTR_AS_OBJ(i % 7 == 0 ? "ä" : "x"));
+    ADD_C(cell, INTEGER_OBJ(i % 13));
+    ADD_C(cell, INTEGER_OBJ(i % 5 + 1));
+    ADD_C(cells, ARRAY_OBJ(cell));
+  }
+
+  Array event = arena_array(arena, 51);
+  ADD_C(event, CSTR_AS_OBJ("grid_line"));
+  for (int row = 0; row < 50; row++) {
+    Array args = arena_array(arena, 5);
+    ADD_C(args, INTEGER_OBJ(1));
+    ADD_C(args, INTEGER_OBJ(row));
+    ADD_C(args, INTEGER_OBJ(0));
+    ADD_C(args, ARRAY_OBJ(cells));
+    ADD_C(args, BOOLEAN_OBJ(false));
+    ADD_C(event, ARRAY_OBJ(args));
+  }
+
+  Dictionary opts = arena_dict(arena, 2);
+  PUT_C(opts, "flush", BOOLEAN_OBJ(true));
+  PUT_C(opts, "batch", FLOAT_OBJ(0.5));
+
+  Array msg = arena_array(arena, 4);
+  ADD_C(msg, INTEGER_OBJ(2));
+  ADD_C(msg, CSTR_AS_OBJ("redraw"));
+  ADD_C(msg, ARRAY_OBJ(event));
+  ADD_C(msg, DICTIONARY_OBJ(opts));
+  return ARRAY_OBJ(msg);
+}
+
+/// Counts and discards the packed bytes.
+static void discard_flush(PackerBuffer *packer)
+{
+  packer->anylen += (size_t)(packer->ptr - packer->startptr);
+  packer->ptr = packer->startptr;
+}
+
+/// Keeps the packed bytes, the buffer is expected to be large enough.
+static void keep_flush(PackerBuffer *packer)
+{
+  (void)packer;
+  abort();
+}
+
+static void packer_init(PackerBuffer *packer, char *buf, PackerBufferFlush flush)
+{
+  *packer = (PackerBuffer){
+    .startptr = buf,
+    .ptr = buf,
+    .endptr = buf + PACK_BUF_SIZE,
+    .packer_flush = flush,
+  };
+}
+
+uint64_t bench_mpack_pack(size_t n)
+{
+  Arena arena = ARENA_EMPTY;
+  Object msg = make_message(&arena);
+  char *buf = xmalloc(PACK_BUF_SIZE);
+  PackerBuffer packer;
+  packer_init(&packer, buf, discard_flush);
+
+  uint64_t start = os_hrtime();
+  for (size_t i = 0; i < n; i++) {
+    mpack_object(&msg, &packer);
+    discard_flush(&packer);
+  }
+  uint64_t elapsed = os_hrtime() - start;
+
+  bench_sink += packer.anylen;
+  xfree(buf);
+  arena_mem_free(arena_finish(&arena));
+  return elapsed;
+}
+
+uint64_t bench_mpack_unpack(size_t n)
+{
+  Arena arena = ARENA_EMPTY;
+  Object msg = make_message(&arena);
+  char *buf = xmalloc(PACK_BUF_SIZE);
+  PackerBuffer packer;
+  packer_init(&packer, buf, keep_flush);
+  mpack_object(&msg, &packer);
+  size_t len = (size_t)(packer.ptr - packer.startptr);
+  arena_mem_free(arena_finish(&arena));
+
+  uint64_t start = os_hrtime();
+  for (size_t i = 0; i < n; i++) {
+    Arena res_arena = ARENA_EMPTY;
+    Error err = ERROR_INIT;
+    Object res = unpack(buf, len, &res_arena, &err);
+    assert(!ERROR_SET(&err));
+    bench_sink += res.data.array.size;
+    arena_mem_free(arena_finish(&res_arena));
+  }
+  uint64_t elapsed = os_hrtime() - start;
+
+  xfree(buf);
+  return elapsed;
+}
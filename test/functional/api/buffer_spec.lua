@@ -50,6 +50,62 @@ describe('api/buf', function()
       assert_alive()
     end)
 
+    it('alternating reads of far apart lines use remembered blocks', function()
+      local lines = {}
+      for i = 1, 10000 do
+        lines[i] = ('line %d'):format(i)
+      end
+      api.nvim_buf_set_lines(0, 0, -1, true, lines)
+      local result = exec_lua([[
+        local before = vim.api.nvim__stats()
+        local same = true
+        for _ = 1, 100 do
+          same = same and vim.fn.getline(2) == 'line 2' and vim.fn.getline(9000) == 'line 9000'
+        end
+        local after = vim.api.nvim__stats()
+        return {
+          ok = same,
+          hit = after.ml_cache_hit - before.ml_cache_hit,
+          miss = after.ml_cache_miss - before.ml_cache_miss,
+        }
+      ]])
+      eq(true, result.ok)
+      ok(result.hit >= 190)
+      ok(result.miss <= 10)
+
+      -- changing lines forgets the blocks, line numbers are different
+      api.nvim_buf_set_lines(0, 0, 1, true, {})
+      eq('line 9001', fn.getline(9000))
+      eq('line 3', fn.getline(2))
+      eq('line 9001', fn.getline(9000))
+    end)
+
+    it('inserting many lines in the middle keeps lines and offsets', function()
+      local lines = {}
+      for i = 1, 3000 do
+        lines[i] = ('line %d'):format(i)
+      end
+      api.nvim_buf_set_lines(0, 0, -1, true, lines)
+      local new = {}
+      for i = 1, 5000 do
+        new[i] = ('new %d '):format(i) .. ('x'):rep(i % 100)
+      end
+      api.nvim_buf_set_lines(0, 1500, 1500, true, new)
+      for i = 5000, 1, -1 do
+        table.insert(lines, 1501, new[i])
+      end
+      eq(lines, api.nvim_buf_get_lines(0, 0, -1, true))
+
+      local offset = 0
+      for i = 1, #lines, 97 do
+        eq(offset, api.nvim_buf_get_offset(0, i - 1))
+        for j = i, math.min(i + 96, #lines) do
+          offset = offset + #lines[j] + 1
+        end
+      end
+      eq(offset, api.nvim_buf_get_offset(0, #lines))
+    end)
+
     it('cursor position is maintained after lines are inserted #9961', function()
       -- replace the buffer contents with these three lines.
       api.nvim_buf_set_lines(0, 0, -1, true, { 'line1', 'line2', 'line3', 'line4' })
@@ -666,6 +722,21 @@ describe('api/buf', function()
       eq({ 'ab\0cd' }, get_lines(0, -1, true))
     end)
 
+    it('can handle requests larger than the read buffer', function()
+      local lines = {}
+      for i = 1, 3000 do
+        lines[i] = i % 7 == 0 and '' or ('%d\0'):format(i) .. ('x'):rep(i % 300)
+      end
+      set_lines(0, -1, true, lines)
+      eq(lines, get_lines(0, -1, true))
+      set_lines(0, 1, true, { 'short' })
+      eq('short', get_lines(0, 1, true)[1])
+
+      local dict = { [('k'):rep(100)] = 'v', a = ('y'):rep(70000), b = '' }
+      api.nvim_set_var('d', dict)
+      eq(dict, api.nvim_get_var('d'))
+    end)
+
     it('works with multiple lines', function()
       eq({ '' }, get_lines(0, -1, true))
       -- Replace buffer
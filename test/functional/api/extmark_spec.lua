@@ -1722,6 +1722,49 @@ describe('API/extmarks', function()
     eq({ { 3, 0, 0 } }, get_extmarks(-1, 0, -1, { type = 'sign' }))
     eq({ { 4, 0, 0 } }, get_extmarks(-1, 0, -1, { type = 'virt_text' }))
     eq({ { 5, 0, 0 } }, get_extmarks(-1, 0, -1, { type = 'virt_lines' }))
+
+    -- enough marks that whole subtrees without virt_lines are skipped
+    local lines = {}
+    for i = 1, 200 do
+      lines[i] = tostring(i)
+    end
+    api.nvim_buf_set_lines(0, 0, -1, true, lines)
+    for i = 6, 200 do
+      set_extmark(ns, i, i - 1, 0, i % 50 == 0 and { virt_lines = { { { 'line' } } } } or {})
+    end
+    eq(
+      { { 5, 0, 0 }, { 50, 49, 0 }, { 100, 99, 0 }, { 150, 149, 0 }, { 200, 199, 0 } },
+      get_extmarks(-1, 0, -1, { type = 'virt_lines' })
+    )
+    eq({ { 100, 99, 0 }, { 150, 149, 0 } }, get_extmarks(-1, { 60, 0 }, { 149, 0 }, {
+      type = 'virt_lines',
+    }))
+    eq({ { 150, 149, 0 } }, get_extmarks(-1, { 149, 0 }, -1, {
+      type = 'virt_lines',
+      overlap = true,
+      limit = 1,
+    }))
+    eq({ { 200, 199, 0 }, { 150, 149, 0 } }, get_extmarks(-1, -1, { 100, 0 }, {
+      type = 'virt_lines',
+    }))
+  end)
+
+  it('can get marks as columns', function()
+    set_extmark(ns, 1, 0, 0, {})
+    set_extmark(ns, 2, 0, 2, { end_row = 0, end_col = 4, hl_group = 'Normal' })
+    set_extmark(ns, 3, 0, 3, { sign_text = '>>' })
+    eq(
+      { { 1, 2, 3 }, { 0, 0, 0 }, { 0, 2, 3 }, { -1, 0, -1 }, { -1, 4, -1 } },
+      get_extmarks(ns, 0, -1, { columns = true })
+    )
+    eq({ { 3, 2 }, { 0, 0 }, { 3, 2 }, { -1, 0 }, { -1, 4 } }, get_extmarks(ns, -1, { 0, 1 }, {
+      columns = true,
+    }))
+    eq({ {}, {}, {}, {}, {} }, get_extmarks(ns2, 0, -1, { columns = true }))
+    eq(
+      "cannot use both 'details' and 'columns'",
+      pcall_err(get_extmarks, ns, 0, -1, { columns = true, details = true })
+    )
   end)
 
   it('invalidated marks are deleted', function()
@@ -1951,6 +1994,91 @@ describe('Extmarks buffer api with many marks', function()
     eq({}, get_marks(ns1))
     eq({}, get_marks(ns2))
   end)
+
+  it('can set many marks at once', function()
+    local list = {}
+    for i = 29, 0, -1 do
+      for j = 0, i, 2 do
+        list[#list + 1] = { i, j, { end_row = i, end_col = j + 1, hl_group = 'Search' } }
+      end
+    end
+    local ids = api.nvim_buf_set_extmarks(0, ns1, list, { replace = true })
+    eq(#list, #ids)
+    ns_marks[ns1] = {}
+    for k, id in ipairs(ids) do
+      eq(nil, ns_marks[ns1][id])
+      ns_marks[ns1][id] = { list[k][1], list[k][2] }
+    end
+    eq(ns_marks[ns1], get_marks(ns1))
+    eq(ns_marks[ns2], get_marks(ns2))
+    local details = get_extmark_by_id(ns1, ids[1], { details = true, hl_name = true })
+    eq({ 29, 0 }, { details[1], details[2] })
+    eq({ 29, 1, 'Search' }, { details[3].end_row, details[3].end_col, details[3].hl_group })
+
+    -- an item with an id edits that mark, new ids do not clash with it
+    local ids2 = api.nvim_buf_set_extmarks(0, ns1, {
+      { 3, 1 },
+      { 5, 2, { id = ids[2] } },
+      { 4, 0, { id = 1000 } },
+    }, {})
+    eq(ids[2], ids2[2])
+    eq(1000, ids2[3])
+    eq(1001, ids2[1])
+    ns_marks[ns1][ids2[1]] = { 3, 1 }
+    ns_marks[ns1][ids[2]] = { 5, 2 }
+    ns_marks[ns1][1000] = { 4, 0 }
+    eq(ns_marks[ns1], get_marks(ns1))
+
+    -- the marks follow text changes
+    feed('10G10dd')
+    for _, marks in pairs(ns_marks) do
+      for id, mark in pairs(marks) do
+        if 9 <= mark[1] and mark[1] < 19 then
+          marks[id] = { 9, 0 }
+        elseif mark[1] >= 19 then
+          mark[1] = mark[1] - 10
+        end
+      end
+    end
+    eq(ns_marks[ns1], get_marks(ns1))
+    eq(ns_marks[ns2], get_marks(ns2))
+
+    -- nothing is set when an item is invalid
+    eq(
+      "Invalid 'marks': expected list of [line, col, opts] items",
+      pcall_err(api.nvim_buf_set_extmarks, 0, ns2, { { 0, 0 }, { 0 } }, {})
+    )
+    eq(
+      "Invalid 'col': out of range",
+      pcall_err(api.nvim_buf_set_extmarks, 0, ns2, { { 0, 0 }, { 0, 100 } }, {})
+    )
+    eq(
+      "cannot use 'ephemeral' with nvim_buf_set_extmarks",
+      pcall_err(api.nvim_buf_set_extmarks, 0, ns2, { { 0, 0, { ephemeral = true } } }, {})
+    )
+    eq(ns_marks[ns2], get_marks(ns2))
+
+    api.nvim_buf_set_extmarks(0, ns1, {}, { replace = true })
+    eq({}, get_marks(ns1))
+    eq(ns_marks[ns2], get_marks(ns2))
+  end)
+
+  it('reuses nodes of cleared marks', function()
+    local before = api.nvim__stats()
+    api.nvim_buf_clear_namespace(0, -1, 0, -1)
+    local cleared = api.nvim__stats()
+    ok(cleared.marktree_nodes < before.marktree_nodes)
+    ok(cleared.marktree_free_nodes > before.marktree_free_nodes)
+
+    for i = 0, 29 do
+      for j = 0, i do
+        api.nvim_buf_set_extmark(0, ns1, i, j, {})
+      end
+    end
+    local after = api.nvim__stats()
+    ok(after.marktree_nodes > cleared.marktree_nodes)
+    ok(after.marktree_free_nodes < cleared.marktree_free_nodes)
+  end)
 end)
 
 describe('API/win_extmark', function()
@@ -384,6 +384,40 @@ describe('server -> client', function()
     end)
   end)
 
+  describe('shared memory ring', function()
+    it('carries the output of a child attached as UI', function()
+      local chan = fn.jobstart(
+        { nvim_prog, '--embed', '--headless', '-n', '-u', 'NONE', '-i', 'NONE' },
+        { rpc = true }
+      )
+      local ring = api.nvim__chan_ring(chan)
+      if t.skip(ring == '', 'needs memfd_create()') then
+        return
+      end
+      fn.rpcrequest(chan, 'nvim_ui_attach', 40, 10, { ext_linegrid = true, shm_ring = ring })
+      eq(2, fn.rpcrequest(chan, 'nvim_eval', '1+1'))
+      fn.rpcrequest(chan, 'nvim_command', 'redraw!')
+
+      -- Larger than the ring, so the child has to wait for room.
+      local before = fn.rpcrequest(chan, 'nvim__stats').stream_write_bytes
+      eq(3000000, #fn.rpcrequest(chan, 'nvim_eval', 'repeat("x", 3000000)'))
+      local after = fn.rpcrequest(chan, 'nvim__stats').stream_write_bytes
+      -- only doorbells went through the pipe
+      ok(after - before < 1000)
+      fn.jobstop(chan)
+    end)
+
+    it('is ignored if the path is not a ring', function()
+      local chan = fn.jobstart(
+        { nvim_prog, '--embed', '--headless', '-n', '-u', 'NONE', '-i', 'NONE' },
+        { rpc = true }
+      )
+      fn.rpcrequest(chan, 'nvim_ui_attach', 40, 10, { shm_ring = '/dev/null' })
+      eq(2, fn.rpcrequest(chan, 'nvim_eval', '1+1'))
+      fn.jobstop(chan)
+    end)
+  end)
+
   describe('connecting to its own pipe address', function()
     it('does not deadlock', function()
       local address = fn.serverlist()[1]
@@ -1184,6 +1184,45 @@ describe('API/win', function()
         api.nvim_win_text_height(0, { start_row = 0, start_vcol = 220, end_row = 2, end_vcol = 42 })
       )
     end)
+
+    it('follows changes of the text and of options', function()
+      local function height(win, row)
+        return api.nvim_win_text_height(win, { start_row = row, end_row = row }).all
+      end
+      local buf = api.nvim_get_current_buf()
+      api.nvim_buf_set_lines(buf, 0, -1, true, { ('x'):rep(80), ('\t'):rep(10) })
+      command('split')
+      local win = api.nvim_get_current_win()
+      local other = fn.win_getid(2)
+      eq({ 1, 1 }, { height(win, 0), height(win, 1) })
+      eq({ 1, 1 }, { height(other, 0), height(other, 1) })
+
+      api.nvim_buf_set_lines(buf, 0, 1, true, { ('x'):rep(200) })
+      eq({ 3, 3 }, { height(win, 0), height(other, 0) })
+
+      -- buffer-local option, also used by the other window
+      command('setlocal tabstop=10')
+      eq({ 2, 2 }, { height(win, 1), height(other, 1) })
+
+      -- window-local option, changes the text width
+      command('setlocal number')
+      api.nvim_buf_set_lines(buf, 0, 1, true, { ('x'):rep(80) })
+      eq({ 2, 1 }, { height(win, 0), height(other, 0) })
+
+      -- changed while not shown in the window
+      command('enew')
+      api.nvim_buf_set_lines(buf, 1, 2, true, { ('\t'):rep(20) })
+      command('buffer ' .. buf)
+      eq({ 3, 3 }, { height(win, 1), height(other, 1) })
+
+      -- global window option, set in one window but also used by the other
+      command('setlocal nonumber')
+      api.nvim_set_option_value('list', true, { win = win })
+      api.nvim_set_option_value('list', true, { win = other })
+      eq({ 1, 1 }, { height(win, 0), height(other, 0) })
+      command('set listchars=eol:$')
+      eq({ 2, 2 }, { height(win, 0), height(other, 0) })
+    end)
   end)
 
   describe('open_win', function()
@@ -46,6 +46,7 @@ describe('fileio', function()
     os.remove('Xtest_тест.md')
     os.remove('Xtest-u8-int-max')
     os.remove('Xtest-overwrite-forced')
+    os.remove('Xtest-largefile')
     rmdir('Xtest_startup_swapdir')
     rmdir('Xtest_backupdir')
     rmdir('Xtest_backupdir with spaces')
@@ -85,6 +86,10 @@ describe('fileio', function()
     retry(3, nil, function()
       eq(1, request('nvim__stats').fsync)
     end)
+    -- Time spent by the main thread in the sync is recorded.
+    local stats = request('nvim__stats')
+    ok(stats.swap_sync >= 1)
+    ok(stats.swap_sync_max_us <= stats.swap_sync_us)
     command('set updatetime=100000 updatecount=100000')
 
     -- 2. Explicit :preserve command.
@@ -271,6 +276,172 @@ describe('fileio', function()
     assert_alive()
   end)
 
+  it("maps a file of at least 'largefilesize' into memory", function()
+    clear()
+    local lines = {}
+    for i = 1, 20000 do
+      lines[i] = ('line %d '):format(i) .. ('x'):rep(i % 300)
+    end
+    lines[5000] = 'with\0nul'
+    lines[12345] = ''
+    -- an illegal byte after the first Mbyte is kept
+    lines[15000] = 'illegal \255 byte'
+    write_file('Xtest-largefile', table.concat(lines, '\n'))
+    command('set largefilesize=64 noundofile')
+    command('edit Xtest-largefile')
+    -- the lines after the first Mbyte are found in the background
+    retry(nil, 10000, function()
+      eq(20000, fn.line('$'))
+    end)
+    eq(false, api.nvim_get_option_value('modified', { buf = 0 }))
+    eq(lines[1], fn.getline(1))
+    eq('with\nnul', fn.getline(5000))
+    eq('', fn.getline(12345))
+    eq(lines[15000], fn.getline(15000))
+    eq(lines[20000], fn.getline(20000))
+    eq(false, api.nvim_get_option_value('endofline', { buf = 0 }))
+    eq(#lines[1] + #lines[2] + 3, fn.line2byte(3))
+    eq(10000, fn.byte2line(fn.line2byte(10000)))
+
+    -- change lines, write back and read again
+    command('10000s/^/changed /')
+    command('3,4delete')
+    command('write')
+    table.remove(lines, 3)
+    table.remove(lines, 3)
+    lines[9998] = 'changed ' .. lines[9998]
+    -- 'fixendofline' adds the missing end-of-line
+    eq(table.concat(lines, '\n') .. '\n', read_file('Xtest-largefile'))
+    command('edit!')
+    eq(19998, fn.line('$'))
+    eq(lines[9998], fn.getline(9998))
+  end)
+
+  it("reads a file of at least 'streamfilesize' in the background", function()
+    clear()
+    local lines = {}
+    for i = 1, 50000 do
+      lines[i] = ('line %d '):format(i) .. ('x'):rep(i % 100)
+    end
+    lines[30000] = 'with\0nul'
+    write_file('Xtest-largefile', table.concat(lines, '\n'))
+    command('set streamfilesize=64 noundofile')
+    command('edit Xtest-largefile')
+    retry(nil, 10000, function()
+      eq(50000, fn.line('$'))
+    end)
+    lines[30000] = 'with\nnul'
+    eq(lines, api.nvim_buf_get_lines(0, 0, -1, true))
+    eq(false, api.nvim_get_option_value('modified', { buf = 0 }))
+    eq(false, api.nvim_get_option_value('endofline', { buf = 0 }))
+
+    -- "G", a search and a change wait for the whole file
+    command('edit!')
+    command('normal! G')
+    eq(50000, fn.line('.'))
+    command('edit!')
+    feed('/^line 49999 <CR>')
+    eq(49999, fn.line('.'))
+    command('edit!')
+    command('1delete')
+    eq(49999, fn.line('$'))
+    eq(lines[50000], fn.getline('$'))
+    command('write')
+    table.remove(lines, 1)
+    lines[29999] = 'with\0nul'
+    eq(table.concat(lines, '\n') .. '\n', read_file('Xtest-largefile'))
+  end)
+
+  it("reads a file without end-of-line in the background with 'binary' or 'nofixeol'", function()
+    clear()
+    local lines = {}
+    for i = 1, 50000 do
+      lines[i] = ('line %d '):format(i) .. ('x'):rep(i % 100)
+    end
+    write_file('Xtest-largefile', table.concat(lines, '\n'))
+    command('set streamfilesize=64 noundofile')
+    for _, cmd in ipairs({ 'edit ++bin', 'set nofixeol | edit' }) do
+      command(cmd .. ' Xtest-largefile')
+      retry(nil, 10000, function()
+        eq(50000, fn.line('$'))
+      end)
+      eq(false, api.nvim_get_option_value('endofline', { buf = 0 }))
+      -- the buffer is not changed, ":quit" would not give E37
+      eq(0, fn.getbufinfo('%')[1].changed)
+      command('write')
+      eq(table.concat(lines, '\n'), read_file('Xtest-largefile'))
+      command('bwipe!')
+    end
+  end)
+
+  it(':checktime notices files changed outside of Nvim', function()
+    clear()
+    write_file('Xtest_startup_file1', 'one\n')
+    write_file('Xtest_startup_file2', 'two\n')
+    command('set autoread')
+    command('edit Xtest_startup_file1')
+    command('split Xtest_startup_file2')
+    command('checktime')
+    eq({ 'one' }, fn.getbufline('Xtest_startup_file1', 1, '$'))
+
+    write_file('Xtest_startup_file1', 'one changed\n')
+    command('checktime')
+    eq({ 'one changed' }, fn.getbufline('Xtest_startup_file1', 1, '$'))
+    eq({ 'two' }, fn.getbufline('Xtest_startup_file2', 1, '$'))
+
+    -- changed by a shell command
+    if not is_os('win') then
+      command('silent !echo two changed > Xtest_startup_file2')
+      command('checktime')
+      eq({ 'two changed' }, fn.getbufline('Xtest_startup_file2', 1, '$'))
+    end
+  end)
+
+  it(':checktime does not check a file when its directory did not change', function()
+    skip(t.sysname() ~= 'linux', 'directories are only watched on Linux')
+    clear()
+    mkdir('Xtest_checktime_dir')
+    finally(function()
+      rmdir('Xtest_checktime_dir')
+    end)
+    write_file('Xtest_checktime_dir/file', 'one\n')
+    command('edit Xtest_checktime_dir/file')
+    command('checktime')
+    local checks = api.nvim__stats().timestamp_checks
+    command('checktime')
+    command('checktime')
+    eq(checks, api.nvim__stats().timestamp_checks)
+
+    -- another file in the directory changed
+    write_file('Xtest_checktime_dir/other', 'two\n')
+    command('checktime')
+    eq(checks + 1, api.nvim__stats().timestamp_checks)
+    command('checktime')
+    eq(checks + 1, api.nvim__stats().timestamp_checks)
+  end)
+
+  it("compresses unused text with 'memcompress'", function()
+    clear()
+    command('set noswapfile updatetime=1 memcompress=1')
+    local lines = {}
+    for i = 1, 5000 do
+      lines[i] = ('line %d '):format(i) .. ('abc'):rep(i % 30)
+    end
+    api.nvim_buf_set_lines(0, 0, -1, true, lines)
+    retry(nil, 3000, function()
+      feed('jk')
+      sleep(10)
+      ok(request('nvim__stats').compress_bytes > 0)
+    end)
+    local stats = request('nvim__stats')
+    ok(stats.compress_ratio > 1.5)
+
+    eq(lines, api.nvim_buf_get_lines(0, 0, -1, true))
+    ok(request('nvim__stats').decompress > stats.decompress)
+    command('%s/^line/changed/')
+    eq('changed 4999 ' .. ('abc'):rep(19), fn.getline(4999))
+  end)
+
   it(':w! does not show "file has been changed" warning', function()
     clear()
     write_file('Xtest-overwrite-forced', 'foobar')
@@ -11,6 +11,7 @@ local api = n.api
 local skip = t.skip
 local is_os = t.is_os
 local is_ci = t.is_ci
+local retry = t.retry
 
 local fname = 'Xtest-functional-ex_cmds-write'
 local fname_bak = fname .. '~'
@@ -124,6 +125,32 @@ describe(':write', function()
     end
   end)
 
+  it('++async writes the file in the background', function()
+    command('edit ' .. fname)
+    command('let g:written = 0 | autocmd BufWritePost * let g:written += 1')
+    api.nvim_buf_set_lines(0, 0, -1, true, { 'line1', 'line2' })
+    command('write ++async')
+    retry(nil, 1000, function()
+      eq(1, eval('g:written'))
+    end)
+    eq({ 'line1', 'line2' }, fn.readfile(fname))
+    eq(0, eval('&modified'))
+
+    -- A change made while writing is not written and keeps 'modified' set.
+    command('write ++async | call setline(1, "changed")')
+    retry(nil, 1000, function()
+      eq(2, eval('g:written'))
+    end)
+    eq({ 'line1', 'line2' }, fn.readfile(fname))
+    eq(1, eval('&modified'))
+
+    -- Writing again first waits for a write in progress.
+    command('write ++async | call setline(2, "new") | write')
+    eq(4, eval('g:written'))
+    eq({ 'changed', 'new' }, fn.readfile(fname))
+    eq(0, eval('&modified'))
+  end)
+
   it('errors out correctly', function()
     skip(is_ci('cirrus'))
     command('let $HOME=""')
@@ -2211,6 +2211,110 @@ describe('TUI', function()
     feed_data(':set columns=99|set stl=redrawn%m\n')
     screen:expect({ any = 'redrawn%[%+%]' })
   end)
+
+  --- Starts Nvim with "args" in a :terminal, collecting what its TUI writes
+  --- in _G.output.
+  ---
+  --- @return integer job
+  local function start_tui_output(args, env)
+    env = env or {}
+    env.VIMRUNTIME = os.getenv('VIMRUNTIME')
+    return exec_lua(
+      [[
+      local argv, env = ...
+      _G.output = ''
+      return vim.fn.termopen(argv, {
+        env = env,
+        on_stdout = function(_, data)
+          _G.output = _G.output .. table.concat(data, '\n')
+        end,
+      })
+    ]],
+      { nvim_prog, unpack(args) },
+      env
+    )
+  end
+
+  it('sends runs of a character as REP when the terminal has it', function()
+    local screen = Screen.new(50, 7)
+    screen:set_default_attr_ids({
+      [1] = { reverse = true },
+      [3] = { bold = true },
+    })
+    screen:attach()
+    -- A genuine xterm keeps "rep" of the terminfo entry.
+    start_tui_output({
+      '--clean',
+      '--cmd',
+      'set shortmess+=I notermguicolors laststatus=0 noruler noshowcmd noshowmode',
+      '--cmd',
+      'set fillchars=eob:\\ ',
+      '-c',
+      "call setline(1, [repeat('x', 30) .. 'y', 'a' .. repeat('-', 20) .. 'b'])",
+      '-c',
+      'normal! $',
+    }, { TERM = 'xterm-256color', XTERM_VERSION = 'XTerm(393)' })
+    command('startinsert')
+    screen:expect([[
+      xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx{1:y}                   |
+      a--------------------b                            |
+                                                        |*4
+      {3:-- TERMINAL --}                                    |
+    ]])
+    local output = exec_lua('return _G.output')
+    ok(output:find('x\27[29b', 1, true) ~= nil)
+    ok(output:find('-\27[19b', 1, true) ~= nil)
+
+    -- The cursor is moved from where the cells sent as REP left it.
+    feed_data('j')
+    screen:expect([[
+      xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxy                   |
+      a--------------------{1:b}                            |
+                                                        |*4
+      {3:-- TERMINAL --}                                    |
+    ]])
+  end)
+
+  it("ends a frame larger than the output buffer once with 'termsync'", function()
+    local screen = Screen.new(200, 52)
+    screen:attach()
+    local job = start_tui_output({
+      '--clean',
+      '--cmd',
+      'set shortmess+=I termguicolors termsync laststatus=0 noruler noshowcmd noshowmode',
+      '-c',
+      "hi A guifg=#ff0000 | hi B guifg=#0000ff | call matchadd('A', 'a') | call matchadd('B', 'b')",
+      '-c',
+      "nnoremap Z <Cmd>call setline(1, repeat([repeat('ab', 100)], 50))<CR>",
+    })
+    retry(nil, nil, function()
+      ok(#exec_lua('return _G.output') > 0)
+    end)
+
+    -- Every cell changes its color, so the frame needs much more than the
+    -- 64 KiB output buffer of the TUI. The terminal reports that it supports
+    -- synchronized output before the frame is drawn.
+    exec_lua(
+      [[
+      local job = ...
+      _G.output = ''
+      vim.fn.chansend(job, '\27[?2026;2$yZ')
+    ]],
+      job
+    )
+    local output
+    retry(nil, nil, function()
+      output = exec_lua('return _G.output')
+      local _, cells = output:gsub('[ab]', '')
+      ok(cells >= 10000, '10000 cells', cells)
+      ok(output:find('\27[?2026l', 1, true) ~= nil)
+    end)
+    ok(#output > 0xffff, 'more than 64 KiB', #output)
+    local _, starts = output:gsub('\27%[%?2026h', '')
+    local _, ends = output:gsub('\27%[%?2026l', '')
+    eq({ 1, 1 }, { starts, ends })
+    ok(output:find('\27[?2026l', 1, true) > output:find('b[^b]*$'))
+  end)
 end)
 
 describe('TUI UIEnter/UILeave', function()
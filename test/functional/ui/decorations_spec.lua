@@ -841,6 +841,89 @@ describe('extmark decorations', function()
     screen:expect_unchanged()
   end)
 
+  it('reuses decorations of lines drawn before', function()
+    insert(example_text)
+    command('hi clear CursorLine')
+    command('set cursorline')
+    feed('gg')
+    api.nvim_buf_set_extmark(0, ns, 1, 4, { end_row = 4, end_col = 7, hl_group = 'Search' })
+    screen:expect([[
+      ^for _,item in ipairs(items) do                    |
+          {34:local text, hl_id_cell, count = unpack(item)}  |
+      {34:    if hl_id_cell ~= nil then}                     |
+      {34:        hl_id = hl_id_cell}                        |
+      {34:    end}                                           |
+          for _ = 1, (count or 1) do                    |
+              local cell = line[colpos]                 |
+              cell.text = text                          |
+              cell.hl_id = hl_id                        |
+              colpos = colpos+1                         |
+          end                                           |
+      end                                               |
+      {1:~                                                 }|*2
+                                                        |
+    ]])
+
+    -- only the old and the new cursor line are drawn again
+    local hit = api.nvim__stats().decor_cache_hit
+    feed('7j')
+    screen:expect([[
+      for _,item in ipairs(items) do                    |
+          {34:local text, hl_id_cell, count = unpack(item)}  |
+      {34:    if hl_id_cell ~= nil then}                     |
+      {34:        hl_id = hl_id_cell}                        |
+      {34:    end}                                           |
+          for _ = 1, (count or 1) do                    |
+              local cell = line[colpos]                 |
+      ^        cell.text = text                          |
+              cell.hl_id = hl_id                        |
+              colpos = colpos+1                         |
+          end                                           |
+      end                                               |
+      {1:~                                                 }|*2
+                                                        |
+    ]])
+    eq(true, api.nvim__stats().decor_cache_hit >= hit + 2)
+
+    -- highlight attributes are looked up again
+    command('hi Search guibg=LightBlue')
+    screen:expect([[
+      for _,item in ipairs(items) do                    |
+          {38:local text, hl_id_cell, count = unpack(item)}  |
+      {38:    if hl_id_cell ~= nil then}                     |
+      {38:        hl_id = hl_id_cell}                        |
+      {38:    end}                                           |
+          for _ = 1, (count or 1) do                    |
+              local cell = line[colpos]                 |
+      ^        cell.text = text                          |
+              cell.hl_id = hl_id                        |
+              colpos = colpos+1                         |
+          end                                           |
+      end                                               |
+      {1:~                                                 }|*2
+                                                        |
+    ]])
+
+    -- a changed mark is seen
+    api.nvim_buf_set_extmark(0, ns, 7, 8, { end_col = 12, hl_group = 'Search' })
+    screen:expect([[
+      for _,item in ipairs(items) do                    |
+          {38:local text, hl_id_cell, count = unpack(item)}  |
+      {38:    if hl_id_cell ~= nil then}                     |
+      {38:        hl_id = hl_id_cell}                        |
+      {38:    end}                                           |
+          for _ = 1, (count or 1) do                    |
+              local cell = line[colpos]                 |
+      ^        {38:cell}.text = text                          |
+              cell.hl_id = hl_id                        |
+              colpos = colpos+1                         |
+          end                                           |
+      end                                               |
+      {1:~                                                 }|*2
+                                                        |
+    ]])
+  end)
+
   it('can have virtual text of overlay position', function()
     insert(example_text)
     feed 'gg'
@@ -8064,6 +8064,42 @@ describe('float window', function()
       end
     end)
 
+    it('redraws doublewidth chars cut by a float', function()
+      insert([[
+        # TODO: 测试字典信息的准确性
+        # FIXME: 测试字典信息的准确性]])
+      local buf = api.nvim_create_buf(false,false)
+      api.nvim_buf_set_lines(buf, 0, -1, true, {'口', '口'})
+      api.nvim_open_win(buf, false, {relative='editor', width=5, height=3, row=0, col=11, style='minimal'})
+      -- Only the part of the line below the float is composed, a doublewidth
+      -- char on its edge is not sent as half a char.
+      api.nvim_buf_set_lines(0, 0, 1, true, {'# TODO:  测试字典信息的准确性'})
+      if multigrid then
+        screen:expect{grid=[[
+        ## grid 1
+          [2:----------------------------------------]|*6
+          [3:----------------------------------------]|
+        ## grid 2
+          # TODO:  测试字典信息的准确性           |
+          # FIXME: 测试字典信息的准确^性           |
+          {0:~                                       }|*4
+        ## grid 3
+                                                  |
+        ## grid 4
+          {1:口   }|*2
+          {1:     }|
+        ]], float_pos={ [4] = { 1001, "NW", 1, 0, 11, true } }}
+      else
+        screen:expect([[
+          # TODO:  测{1:口   } 信息的准确性           |
+          # FIXME: 测{1:口   } 信息的准确^性           |
+          {0:~          }{1:     }{0:                        }|
+          {0:~                                       }|*3
+                                                  |
+        ]])
+      end
+    end)
+
     it("correctly redraws when overlaid windows are resized #13991", function()
 	  n.source([[
         let popup_config = {"relative" : "editor",
@@ -0,0 +1,120 @@
+local t = require('test.testutil')
+local n = require('test.functional.testnvim')()
+local Screen = require('test.functional.ui.screen')
+
+local api = n.api
+local clear = n.clear
+local command = n.command
+local exec_lua = n.exec_lua
+local feed = n.feed
+local eq = t.eq
+local ok = t.ok
+local retry = t.retry
+
+describe("'redrawrate'", function()
+  local screen
+
+  before_each(function()
+    clear()
+    screen = Screen.new(40, 6)
+    screen:attach()
+    screen:set_default_attr_ids({
+      [1] = { bold = true, foreground = Screen.colors.Blue },
+    })
+    command('set laststatus=0 noruler noshowcmd noshowmode')
+    screen:expect([[
+      ^                                        |
+      {1:~                                       }|*4
+                                              |
+    ]])
+  end)
+
+  it('merges output of a job into fewer frames', function()
+    command('set redrawrate=5')
+    local script = t.tmpname()
+    t.write_file(
+      script,
+      [[
+      for i = 1, 40 do
+        io.write('line ', i, '\n')
+        io.stdout:flush()
+        vim.uv.sleep(10)
+      end
+    ]]
+    )
+    local before = api.nvim__stats()
+    -- Every callback shows the last line of the output in the buffer.
+    exec_lua(
+      [[
+      local script = ...
+      local buf = vim.api.nvim_get_current_buf()
+      local partial = ''
+      vim.g.callbacks = 0
+      vim.fn.jobstart({ vim.v.progpath, '--clean', '-l', script }, {
+        on_stdout = function(_, data)
+          data[1] = partial .. data[1]
+          partial = table.remove(data)
+          if #data > 0 then
+            vim.g.callbacks = vim.g.callbacks + 1
+            vim.api.nvim_buf_set_lines(buf, 0, -1, true, { data[#data] })
+          end
+        end,
+        on_exit = function()
+          vim.g.done = true
+        end,
+      })
+    ]],
+      script
+    )
+    retry(nil, 10000, function()
+      eq(true, api.nvim_get_var('done'))
+    end)
+    screen:expect([[
+      ^line 40                                 |
+      {1:~                                       }|*4
+                                              |
+    ]])
+    local after = api.nvim__stats()
+    os.remove(script)
+
+    local callbacks = api.nvim_get_var('callbacks')
+    local frames = after.redraw_frames - before.redraw_frames
+    ok(after.redraw_postponed > before.redraw_postponed)
+    ok(frames < callbacks, ('less than %d frames'):format(callbacks), frames)
+  end)
+
+  it('redraws at once for a typed key while a frame is pending', function()
+    command('set redrawrate=1')
+    -- The next frame for a change that is not typed is due in a second.
+    command('redraw')
+    api.nvim_buf_set_lines(0, 0, -1, true, { 'from a job' })
+    screen:expect_unchanged(false, 200)
+
+    feed('A!<Esc>')
+    screen:expect({
+      grid = [[
+        from a job^!                             |
+        {1:~                                       }|*4
+                                                |
+      ]],
+      timeout = 500,
+    })
+  end)
+
+  it('draws a postponed frame when the timer fires', function()
+    command('set redrawrate=2')
+    command('redraw')
+    local before = api.nvim__stats()
+    api.nvim_buf_set_lines(0, 0, -1, true, { 'from a job' })
+    screen:expect_unchanged(false, 100)
+    ok(api.nvim__stats().redraw_postponed > before.redraw_postponed)
+
+    -- Nothing else happens, the frame is drawn after half a second.
+    screen:expect([[
+      ^from a job                              |
+      {1:~                                       }|*4
+                                              |
+    ]])
+    eq(1, api.nvim__stats().redraw_frames - before.redraw_frames)
+  end)
+end)
@@ -201,6 +201,17 @@ describe('marktree', function()
     shadoworder(tree, shadow, iter)
     lib.marktree_check(tree)
 
+    -- replacing text with text of the same extent
+    dosplice(tree, shadow, { 40, 3 }, { 0, 4 }, { 0, 4 })
+    shadoworder(tree, shadow, iter)
+    lib.marktree_check(tree)
+    dosplice(tree, shadow, { 10, 5 }, { 2, 10 }, { 2, 10 })
+    shadoworder(tree, shadow, iter)
+    lib.marktree_check(tree)
+    dosplice(tree, shadow, { 20, 50 }, { 1, 10 }, { 1, 20 })
+    shadoworder(tree, shadow, iter)
+    lib.marktree_check(tree)
+
     -- build then burn (HOORAY! HOORAY!)
     while next(shadow) do
       lib.marktree_itr_first(tree, iter)
@@ -645,4 +656,91 @@ describe('marktree', function()
     until not lib.marktree_itr_next_filter(tree, iter, 101, 0, filter)
     eq(tablelength(seen), tablelength(shadow))
   end)
+
+  itp('works with marktree_put_many', function()
+    local tree = ffi.new('MarkTree[1]') -- zero initialized by luajit
+    local iter = ffi.new('MarkTreeIter[1]')
+    local shadow = {}
+    local many_ids = {}
+    local right_gravity = 0x4000 -- MT_FLAG_RIGHT_GRAVITY
+
+    local function put_many(count, del_ns, paired)
+      local marks = ffi.new('MTPair[?]', count)
+      for i = 0, count - 1 do
+        last_id = last_id + 1
+        -- not in order, and many marks at the same position
+        local row, col = (i * 37) % 101, i % 7
+        local gravity = i % 2 == 0
+        local mark = marks[i]
+        mark.start.pos.row, mark.start.pos.col = row, col
+        mark.start.ns, mark.start.id = ns + 1, last_id
+        mark.start.flags = gravity and right_gravity or 0
+        if paired then
+          mark.end_pos.row, mark.end_pos.col = row + i % 5, 10
+        else
+          mark.end_pos.row, mark.end_pos.col = -1, -1
+          shadow[last_id] = { row, col, gravity }
+          many_ids[last_id] = true
+        end
+      end
+      lib.marktree_put_many(tree, marks, count, del_ns or 0)
+    end
+
+    -- bulk load into an empty tree
+    put_many(1000)
+    lib.marktree_check(tree)
+    shadoworder(tree, shadow, iter)
+    ok(tree[0].root.level >= 2)
+
+    -- the tree still works as usual
+    for i = 1, 100 do
+      local id = put(tree, i, 3, true)
+      shadow[id] = { i, 3, true }
+    end
+    lib.marktree_check(tree)
+    shadoworder(tree, shadow, iter)
+
+    -- few marks are put one by one, many are merged
+    put_many(10)
+    lib.marktree_check(tree)
+    shadoworder(tree, shadow, iter)
+    put_many(5000)
+    lib.marktree_check(tree)
+    shadoworder(tree, shadow, iter)
+    eq(6110, tree[0].n_keys)
+
+    -- replace a namespace
+    for id in pairs(many_ids) do
+      shadow[id] = nil
+    end
+    many_ids = {}
+    put_many(300, ns + 1)
+    lib.marktree_check(tree)
+    shadoworder(tree, shadow, iter)
+    eq(400, tree[0].n_keys)
+
+    put_many(0, ns + 1)
+    for id in pairs(many_ids) do
+      shadow[id] = nil
+    end
+    lib.marktree_check(tree)
+    shadoworder(tree, shadow, iter)
+    eq(100, tree[0].n_keys)
+
+    -- pairs
+    lib.marktree_clear(tree)
+    for i = 1, 100 do
+      put(tree, 1, i, false, 2, 100 - i, false)
+    end
+    put_many(2000, nil, true)
+    check_intersections(tree)
+    eq(4200, tree[0].n_keys)
+
+    dosplice(tree, {}, { 20, 3 }, { 30, 0 }, { 0, 5 })
+    check_intersections(tree)
+
+    put_many(0, ns + 1)
+    check_intersections(tree)
+    eq(200, tree[0].n_keys)
+  end)
 end)